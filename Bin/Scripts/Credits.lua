@@ -9,6 +9,8 @@ require "Mission"
 Musics["Music"] = Resource.defineMusic("Music/Credits.mp3")
 
 function Mission.onEnter(Location)
+	Graphics.setPartialRedraw(true)
+
 	-- Defines
 	TITLE_CHAR_WIDTH = 5
 	TITLE_HEIGHT = 10
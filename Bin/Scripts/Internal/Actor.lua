@@ -119,3 +119,12 @@ function Actor:playAnimLooped(Anim)
     playActorAnimLooped(self.Pointer, Anim)
 end
 
+---- Bulk
+function Actor.getByTeam(Team)
+    local List = getActorsByTeam(Team)
+    for i, Pointer in ipairs(List) do
+        List[i] = Actor:inherit({ Pointer = Pointer })
+    end
+    return List
+end
+
@@ -0,0 +1,97 @@
+----------------------------------------------------------------------
+--| * Api.lua *
+--|
+--| Routes hot entity, actor and camera bindings
+--| through LuaJIT FFI when engine is built against LuaJIT
+----------------------------------------------------------------------
+
+---- Singleton
+Api = {}
+
+--- Globals which have FFI version
+local NAMES = {
+    "setEntityPosition", "getEntityPosition",
+    "setEntityVelocity", "getEntityVelocity",
+    "setEntityZIndex", "getEntityZIndex",
+    "setEntityAnimFrame", "getEntityAnimFrame",
+    "setActorTeam", "getActorTeam",
+    "setActorHealth", "getActorHealth",
+    "isActorAlive", "setActorSpeed",
+    "setCameraPosition", "getCameraPosition"
+}
+
+--- Regular bindings, kept for comparison
+Api.Lua = {}
+for _, Name in ipairs(NAMES) do
+    Api.Lua[Name] = _G[Name]
+end
+
+--- FFI versions, empty on stock Lua
+Api.FFI = {}
+
+function Api.isJIT()
+    return Api.C ~= nil
+end
+
+--- Puts FFI or regular versions into globals, false if FFI isn't available
+function Api.select(IsFFI)
+    if IsFFI and not Api.isJIT() then
+        return false
+    end
+
+    local Source = IsFFI and Api.FFI or Api.Lua
+    for _, Name in ipairs(NAMES) do
+        _G[Name] = Source[Name]
+    end
+    return true
+end
+
+---- FFI
+if jit then
+    local Ok, ffi = pcall(require, "ffi")
+    if Ok then
+        ffi.cdef(SCRIPT_API_DECLARATIONS)
+        Api.C = ffi.C
+    end
+end
+
+if Api.C then
+    local C = Api.C
+    local FFI = Api.FFI
+
+    -- Entity
+    FFI.setEntityPosition = C.GT_SetEntityPosition
+    FFI.setEntityVelocity = C.GT_SetEntityVelocity
+    FFI.setEntityZIndex = C.GT_SetEntityZIndex
+    FFI.getEntityZIndex = C.GT_GetEntityZIndex
+    FFI.setEntityAnimFrame = C.GT_SetEntityAnimFrame
+    FFI.getEntityAnimFrame = C.GT_GetEntityAnimFrame
+
+    function FFI.getEntityPosition(Pointer)
+        return C.GT_GetEntityPositionX(Pointer), C.GT_GetEntityPositionY(Pointer)
+    end
+
+    function FFI.getEntityVelocity(Pointer)
+        return C.GT_GetEntityVelocityX(Pointer), C.GT_GetEntityVelocityY(Pointer)
+    end
+
+    -- Actor
+    FFI.setActorTeam = C.GT_SetActorTeam
+    FFI.getActorTeam = C.GT_GetActorTeam
+    FFI.setActorHealth = C.GT_SetActorHealth
+    FFI.getActorHealth = C.GT_GetActorHealth
+    FFI.setActorSpeed = C.GT_SetActorSpeed
+
+    function FFI.isActorAlive(Pointer)
+        return C.GT_IsActorAlive(Pointer) ~= 0
+    end
+
+    -- Camera
+    FFI.setCameraPosition = C.GT_SetCameraPosition
+
+    function FFI.getCameraPosition()
+        return C.GT_GetCameraPositionX(), C.GT_GetCameraPositionY()
+    end
+
+    Api.select(true)
+end
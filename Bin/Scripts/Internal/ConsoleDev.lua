@@ -1,3 +1,125 @@
 function mission(Name, Location)
     Mission.switch("Scripts/Mission" .. tostring(Name) .. ".lua", Location or 1)
-end
\ No newline at end of file
+end
+
+--- Compare per-frame cost of entity updates through regular bindings and FFI
+function benchApi(Count, Frames)
+    Count = Count or 500
+    Frames = Frames or 100
+
+    local List = {}
+    for i = 1, Count do
+        List[i] = Entity:new(i % SCREEN_WIDTH, i % SCREEN_HEIGHT, 1, 1, nil)
+    end
+
+    local function run(SetPosition, GetPosition)
+        local Start = os.clock()
+        for Frame = 1, Frames do
+            for i = 1, Count do
+                local Pointer = List[i].Pointer
+                local X, Y = GetPosition(Pointer)
+                SetPosition(Pointer, X + 0.01, Y)
+            end
+        end
+        return (os.clock() - Start) * 1000 / Frames
+    end
+
+    local LuaTime = run(Api.Lua.setEntityPosition, Api.Lua.getEntityPosition)
+    GT_LOG(PR_NOTE, string.format("benchApi(): bindings %.3f ms per frame, %d entities", LuaTime, Count))
+
+    if Api.isJIT() then
+        local FFITime = run(Api.FFI.setEntityPosition, Api.FFI.getEntityPosition)
+        GT_LOG(PR_NOTE, string.format("benchApi(): FFI %.3f ms per frame, %d entities", FFITime, Count))
+    else
+        GT_LOG(PR_NOTE, "benchApi(): FFI isn't available, engine isn't built against LuaJIT")
+    end
+
+    for i = 1, Count do
+        List[i]:delete()
+    end
+end
+
+--- Average per-frame cost of world entity update passes with Count moving cars
+function benchEntities(Count, Frames)
+    Count = Count or 10000
+    Frames = Frames or 100
+
+    runScript(function()
+        local List = {}
+        for i = 1, Count do
+            List[i] = Car:new(i % SCREEN_WIDTH, i % SCREEN_HEIGHT, 1, 1, Textures["Blank"])
+            List[i]:setMaxSpeed(0.01, 0.01)
+            List[i]:setAcceleration(0.001, 0.001)
+        end
+
+        -- Skip frame we spawned at
+        waitTime(0)
+
+        local Total = 0
+        for Frame = 1, Frames do
+            waitTime(0)
+            Total = Total + getWorldUpdateTime()
+        end
+        GT_LOG(PR_NOTE, string.format("benchEntities(): %.3f ms per frame, %d entities", Total / Frames, Count))
+        memory()
+
+        for i = 1, Count do
+            List[i]:delete()
+        end
+    end)
+end
+
+--- Average per-frame record, submit and wait time. Overlap is submit work main thread didn't wait for
+function benchRender(Frames)
+    Frames = Frames or 100
+
+    runScript(function()
+        local Record, Submit, Wait = 0, 0, 0
+        for Frame = 1, Frames do
+            waitTime(0)
+            local R, S, W = getRenderTimes()
+            Record, Submit, Wait = Record + R, Submit + S, Wait + W
+        end
+
+        Record, Submit, Wait = Record / Frames, Submit / Frames, Wait / Frames
+        GT_LOG(PR_NOTE, string.format("benchRender(): record %.3f ms, submit %.3f ms, wait %.3f ms, overlap %.3f ms",
+                                      Record, Submit, Wait, math.max(Submit - Wait, 0)))
+        memory()
+    end)
+end
+
+--- Counts of last rendered frame
+function renderStats()
+    local Stats = getRenderStats()
+    GT_LOG(PR_NOTE, string.format("renderStats(): elements %d background, %d dynamic, %d foreground, %d debug, %d culled, sort %.3f ms",
+                                  Stats.Background, Stats.Dynamic, Stats.Foreground, Stats.Debug, Stats.Culled, Stats.SortTime))
+    GT_LOG(PR_NOTE, string.format("renderStats(): %d draw calls, %d texture binds, %d blend changes, %d text rasterizations",
+                                  Stats.DrawCalls, Stats.TextureBinds, Stats.BlendChanges, Stats.TextRasterizations))
+end
+
+--- Blue, green, yellow, orange and red cells are covered by 1, 2, 3, 4 and more elements
+function overdraw(IsShown)
+    if IsShown == nil then
+        IsShown = true
+    end
+    showOverdraw(IsShown)
+end
+
+--- Live, peak and last frame allocations of every memory tag, writes report file if Path is given
+function memory(Path)
+    for Name, Stats in pairs(getMemoryStats()) do
+        GT_LOG(PR_NOTE, string.format("memory(): %-10s live %9d, peak %9d, %6d blocks, frame %5d allocs %8d bytes, budget %d",
+                                      Name, Stats.Live, Stats.Peak, Stats.Blocks, Stats.FrameAllocs, Stats.FrameBytes, Stats.Budget))
+    end
+
+    if Path then
+        writeMemoryReport(Path)
+    end
+end
+
+--- Voice usage since start up
+function voices()
+    local Stats = getVoiceStats()
+    GT_LOG(PR_NOTE, string.format("voices(): %d of %d active, peak %d, %d played, %d stolen, %d limited, %d culled, %d rejected",
+                                  Stats.Active, Stats.Voices, Stats.Peak, Stats.Played, Stats.Stolen, Stats.Limited, Stats.Culled, Stats.Rejected))
+end
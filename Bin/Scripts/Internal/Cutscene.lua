@@ -32,3 +32,26 @@ function Cutscene.new(funInit, funEnd)
         end
     end
 end
+
+---- Coroutines
+--- Fun runs as coroutine and may wait inside without polling,
+--- wait functions return false if entity left the world
+function Cutscene.run(Fun)
+    runScript(Fun)
+end
+
+function Cutscene.wait(Time)
+    return waitTime(Time)
+end
+
+function Cutscene.waitAnimation(TActor)
+    return waitAnimation(TActor.Pointer)
+end
+
+function Cutscene.waitDialog(TDialog)
+    return waitDialog(TDialog.Pointer)
+end
+
+function Cutscene.waitDeath(TActor)
+    return waitDeath(TActor.Pointer)
+end
@@ -116,3 +116,25 @@ function Entity:getTexture()
     return getEntityTexture(self.Pointer)
 end
 
+---- Bulk
+--- List may contain objects or raw pointers
+function Entity.setPositions(List, Xs, Ys)
+    setEntityPositions(List, Xs, Ys)
+end
+
+function Entity.getPositions(List)
+    return getEntityPositions(List)
+end
+
+function Entity.setVelocities(List, Xs, Ys)
+    setEntityVelocities(List, Xs, Ys)
+end
+
+function Entity.getInRect(X1, Y1, X2, Y2)
+    local List = getEntitiesInRect(X1, Y1, X2, Y2)
+    for i, Pointer in ipairs(List) do
+        List[i] = Entity:inherit({ Pointer = Pointer })
+    end
+    return List
+end
+
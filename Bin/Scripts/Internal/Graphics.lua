@@ -55,3 +55,13 @@ function Graphics.drawRect(RenderMode, ZIndex, IsHUD, Rect)
     drawRect(RenderMode, ZIndex, IsHUD, Rect[1], Rect[2], Rect[3], Rect[4])
 end
 
+--- Static RENDER_MODE_BACKGROUND or RENDER_MODE_FOREGROUND layer is redrawn only where it changes
+function Graphics.setLayerCached(RenderMode, IsCached)
+    setLayerCached(RenderMode, IsCached)
+end
+
+--- Only changed parts of screen are redrawn, for static screens, moving camera redraws everything
+function Graphics.setPartialRedraw(IsPartial)
+    setPartialRedraw(IsPartial)
+end
+
@@ -67,6 +67,7 @@ end
 require "Console"
 require "Graphics"
 require "Camera"
+require "Tilemap"
 require "Input"
 require "Sound"
 require "Music"
@@ -83,3 +84,4 @@ require "Saver"
 require "Cutscene"
 
 require "ConsoleDev"
+require "Api"
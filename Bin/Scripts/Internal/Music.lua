@@ -16,3 +16,18 @@ function Music:play()
     playMusic(self.Pointer)
 end
 
+--- Previous music fades out at the same time, Time is in milliseconds
+function Music:fadeIn(Time)
+    fadeInMusic(self.Pointer, Time)
+end
+
+function Music.fadeOut(Time)
+    fadeOutMusic(Time)
+end
+
+--- Music is freed when every Music of the same file is released
+function Music:release()
+    releaseMusic(self.Pointer)
+    self.Pointer = nil
+end
+
@@ -17,10 +17,17 @@ function Resource.defineMusic(Path)
     return Music:new(Path)
 end
 
-function Resource.defineAnimation(Row, Count, FrameTime)
+function Resource.defineAnimation(Row, Count, FrameTime, Name) -- <Name> is optional
+    if Name then
+        return defineNamedAnimation(Name, Row, Count, FrameTime)
+    end
     return defineAnimation(Row, Count, FrameTime)
 end
 
+function Resource.findAnimation(Name)
+    return findAnimation(Name)
+end
+
 function Resource.defineWeapon(Anim, RangeX, RangeY, Damage, ...) -- <...> is sounds
     return defineWeapon(Anim, RangeX, RangeY, Damage, ...)
 end
@@ -46,5 +53,5 @@ Sounds["CarDoorOpen"] = Resource.defineSound("Sounds/CarDoorOpening.wav")
 Sounds["CarDoorClose"] = Resource.defineSound("Sounds/CarDoorClose.wav")
 Sounds["StartEngine"] = Resource.defineSound("Sounds/DodgeEngineStart.wav")
 
-Weapons["Fist"] = Resource.defineWeapon(Resource.defineAnimation(4, 3, 1000.0 / 2.0), 8, 8, 7.5, Sounds["Punch1"], Sounds["Punch2"], Sounds["Punch3"], Sounds["Punch4"])
+Weapons["Fist"] = Resource.defineWeapon(Resource.defineAnimation(4, 3, 1000.0 / 2.0, "Fist"), 8, 8, 7.5, Sounds["Punch1"], Sounds["Punch2"], Sounds["Punch3"], Sounds["Punch4"])
 
@@ -20,6 +20,22 @@ function Sound:playLooped()
     playSoundLooped(self.Pointer)
 end
 
+--- Attenuated by distance from camera, not played at all when it's too far
+function Sound:playAt(X, Y)
+    playSoundAt(self.Pointer, X, Y)
+end
+
+--- See SOUND_PRIORITY_*, 0 instances means no limit
+function Sound:setPriority(Priority, MaxInstances)
+    setSoundPriority(self.Pointer, Priority, MaxInstances or 4)
+end
+
+--- Sound is freed when every Sound of the same file is released
+function Sound:release()
+    releaseSound(self.Pointer)
+    self.Pointer = nil
+end
+
 function Sound.stopAll()
     stopAllSounds()
 end
@@ -0,0 +1,59 @@
+----------------------------------------------------------------------
+--| * Tilemap.lua *
+--|
+--| Tile layers of location, size is in tiles
+--| and tile size is in units
+----------------------------------------------------------------------
+
+---- Singleton
+Tilemap = {}
+
+function Tilemap.create(Width, Height, TileWidth, TileHeight, LayerCount)
+    return createTilemap(Width, Height, TileWidth, TileHeight, LayerCount or 1)
+end
+
+function Tilemap.load(Path)
+    return loadTilemap(Path)
+end
+
+function Tilemap.save(Path)
+    return saveTilemap(Path)
+end
+
+function Tilemap.unload()
+    unloadTilemap()
+end
+
+--- *** Returns id of texture's first sprite, next ones go row by row *** ---
+function Tilemap.defineTileset(Texture)
+    return defineTileset(Texture)
+end
+
+function Tilemap.setLayer(Layer, RenderMode, ZIndex)
+    setTilemapLayer(Layer, RenderMode, ZIndex)
+end
+
+function Tilemap.setTile(Layer, X, Y, Tile)
+    setTile(Layer, X, Y, Tile)
+end
+
+function Tilemap.getTile(Layer, X, Y)
+    return getTile(Layer, X, Y)
+end
+
+--- *** Returns tile, X and Y of it or nil if position is outside of tilemap *** ---
+function Tilemap.getTileAt(Layer, X, Y)
+    return getTileAt(Layer, X, Y)
+end
+
+function Tilemap.fill(Layer, Rect, Tile)
+    for Y = Rect[2], Rect[2] + Rect[4] - 1 do
+        for X = Rect[1], Rect[1] + Rect[3] - 1 do
+            setTile(Layer, X, Y, Tile)
+        end
+    end
+end
+
+function Tilemap.getSize()
+    return getTilemapSize()
+end
@@ -10,3 +10,17 @@ function Trigger:new(Rect, Entity, FunctionName)
     return Object
 end
 
+--- Watched entity entering calls <FunctionName>, leaving calls exit function
+function Trigger:watch(Entity)
+    watchTriggerEntity(self.Pointer, Entity)
+end
+
+--- Non-repeatable triggers are removed after first enter
+function Trigger:setRepeatable(Boolean)
+    setTriggerRepeatable(self.Pointer, Boolean)
+end
+
+function Trigger:setExitFunction(ExitFunctionName)
+    setTriggerExitFunction(self.Pointer, ExitFunctionName)
+end
+
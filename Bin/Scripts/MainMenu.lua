@@ -11,6 +11,7 @@ Textures["Background"] = Resource.defineTexture("Textures/Special/MainMenu.png",
 ---- Menu
 function Mission.onEnter(Location)
 	showCursor()
+	Graphics.setPartialRedraw(true)
 
 	-- Defines
 	ARROW_TRY_RATE = 150
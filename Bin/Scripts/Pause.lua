@@ -28,6 +28,7 @@ local Active
 function Mission.onEnter(Location)
 	GT_LOG(PR_NOTE, "Game paused")
 	showCursor()
+	Graphics.setPartialRedraw(true)
 
 	-- Defines
 	Active = BUTTON_CONTINUE_TEXT 
@@ -33,7 +33,9 @@ enum eAITaskID
 class Actor;
 
 /**
- * Tasks send commands to Actors
+ * Tasks send commands to Actors. Parallel tasks only read
+ * the world and change their actor, so they're handled on
+ * job system when actor thinks, others on main thread
  */
 class AITask
 {
@@ -42,12 +44,29 @@ protected:
     s32 m_id;
     s32 m_status;
 
+private:
+    b32 m_bHandled;
+
 public:
-    AITask(Actor* pActor, s32 id) : m_pActor(pActor), m_id(id), m_status(AITASK_INPROCESS) {}
+    AITask(Actor* pActor, s32 id) : m_pActor(pActor), m_id(id), m_status(AITASK_INPROCESS), m_bHandled(false) {}
     virtual ~AITask() = default;
 
     forceinline s32 GetID() const { return m_id; }
     forceinline s32 GetStatus() const { return m_status; }
 
     virtual void Handle() {}
+    virtual b32 IsParallel() const { return false; }
+
+    /** Job system side */
+    forceinline void HandleParallel() { Handle(); m_bHandled = true; }
+
+    /** Main thread side, tasks which were handled by job this frame are skipped */
+    forceinline void HandleSerial()
+    {
+        if (!m_bHandled)
+        {
+            Handle();
+        }
+        m_bHandled = false;
+    }
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AI/WaitTask.h"
+#include "Game/Game.h"
 #include "Game/Actor.h"
 
 struct Animation;
@@ -13,10 +14,10 @@ public:
     AnimateForTask(Actor* pActor, const Animation* pAnim, f32 wait) :
         AITask(pActor, AITASK_ANIMATE_FOR), m_pWaitTask(new WaitTask(pActor, wait))
     {
-        pActor->m_pAnim = pAnim ? pAnim : pActor->m_aActorAnims[ACTOR_ANIMATION_IDLE];
-        pActor->m_animFrame = 0;
-        pActor->m_animElapsed = 0.0f;
-        pActor->m_actorState = ACTOR_STATE_ANIMATE_LOOPED;
+        pActor->Anim() = pAnim ? pAnim : pActor->m_aActorAnims[ACTOR_ANIMATION_IDLE];
+        pActor->AnimFrame() = 0;
+        pActor->AnimElapsed() = 0.0f;
+        pActor->SetActorState(ACTOR_STATE_ANIMATE_LOOPED);
     }
 
     ~AnimateForTask()
@@ -39,7 +40,7 @@ public:
         s32 waitStatus = m_pWaitTask->GetStatus();
         if (waitStatus == AITASK_DONE || waitStatus == AITASK_IMPOSSIBLE)
         {
-            m_pActor->m_actorState = ACTOR_STATE_AFTER_ANIMATION;
+            g_game.GetWorld().GetCommands().SetState(m_pActor, m_pActor, ACTOR_STATE_AFTER_ANIMATION);
             m_status = waitStatus;
         }
     }
@@ -33,8 +33,8 @@ b32 GotoEntityTask::IsDone() const
 {
     TList<Entity*> lstEntity;
     g_collisionMgr.CheckCollision(
-        m_pActor->m_vPosition,
-        m_pActor->m_hitBox,
+        m_pActor->Position(),
+        m_pActor->HitBox(),
         [] (auto pEntity, auto userdata) -> b32 { return pEntity == (Entity*)userdata; },
         m_pEntity,
         lstEntity
@@ -46,8 +46,8 @@ b32 GotoEntityTask::IsDone() const
 void GotoEntityTask::HandleActor()
 {
     // Get positions and compute error
-    const Vector2& vActor = m_pActor->m_vPosition;
-    const Vector2& vEntity = m_pEntity->m_vPosition;
+    const Vector2& vActor = m_pActor->Position();
+    const Vector2& vEntity = m_pEntity->Position();
     Vector2 vError = { m_pActor->m_vSpeed.x * ERROR_MULTIPLIER,
                        m_pActor->m_vSpeed.y * ERROR_MULTIPLIER };
 
@@ -13,6 +13,7 @@ public:
         AITask(pActor, AITASK_GOTO_ENTITY), m_pEntity(pEntity) {}
 
     virtual void Handle() override;
+    virtual b32 IsParallel() const override { return true; }
 
 private:
     b32 IsDone() const;
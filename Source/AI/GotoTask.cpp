@@ -12,7 +12,7 @@ void GotoTask::Handle()
     }
 
     // Get position and compute error
-    const Vector2& vPosition = m_pActor->m_vPosition;
+    const Vector2& vPosition = m_pActor->Position();
     Vector2 vError = { m_pActor->m_vSpeed.x * ERROR_MULTIPLIER,
                        m_pActor->m_vSpeed.y * ERROR_MULTIPLIER };
 
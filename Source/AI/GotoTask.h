@@ -14,4 +14,5 @@ public:
         m_bCompletedX(false), m_bCompletedY(false) {}
 
     virtual void Handle() override;
+    virtual b32 IsParallel() const override { return true; }
 };
\ No newline at end of file
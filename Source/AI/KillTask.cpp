@@ -38,8 +38,8 @@ b32 KillTask::IsPossible() const
     // Check if we are near the target
     TList<Entity*> lstEntity;
     g_collisionMgr.CheckCollision(
-        m_pActor->m_vPosition,
-        m_pActor->m_hitBox,
+        m_pActor->Position(),
+        m_pActor->HitBox(),
         [] (auto pEntity, auto userdata) -> b32 { return pEntity == (Entity*)userdata; },
         m_pTarget,
         lstEntity
@@ -51,7 +51,7 @@ b32 KillTask::IsPossible() const
 
 void KillTask::HandleActor()
 {
-    if (m_pTarget->m_vPosition.x < m_pActor->m_vPosition.x)
+    if (m_pTarget->Position().x < m_pActor->Position().x)
     {
         m_pActor->m_bLookRight = false;
     }
@@ -60,7 +60,7 @@ void KillTask::HandleActor()
         m_pActor->m_bLookRight = true;
     }
 
-    if (m_pActor->m_animElapsed - (f32)(std::rand() % ERROR_RATE) > m_pActor->m_attackRate)
+    if (m_pActor->AnimElapsed() - (f32)m_pActor->Random(ERROR_RATE) > m_pActor->m_attackRate)
     {
         m_pActor->PushCommand(AICMD_ATTACK);
     }
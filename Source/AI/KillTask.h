@@ -10,6 +10,7 @@ public:
     KillTask(Actor* pActor, Actor* pTarget) : AITask(pActor, AITASK_KILL), m_pTarget(pTarget) {}
 
     virtual void Handle() override;
+    virtual b32 IsParallel() const override { return true; }
 
 private:
     b32 IsDone() const;
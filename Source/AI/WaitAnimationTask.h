@@ -9,12 +9,11 @@ class WaitAnimationTask final : public AITask
 public:
     WaitAnimationTask(Actor* pActor, const Animation* pAnim) : AITask(pActor, AITASK_ANIMATE_FOR)
     {
-        pActor->m_pAnim = pAnim ? pAnim : pActor->m_aActorAnims[ACTOR_ANIMATION_IDLE];
-        pActor->m_animFrame = 0;
-        pActor->m_animElapsed = 0.0f;
-        pActor->m_actorState = ACTOR_STATE_ANIMATE_ONCE;
+        pActor->PlayAnimOnce(pAnim ? pAnim : pActor->m_aActorAnims[ACTOR_ANIMATION_IDLE]);
     }
 
+    virtual b32 IsParallel() const override { return true; }
+
     virtual void Handle() override
     {
         if (m_status != AITASK_INPROCESS)
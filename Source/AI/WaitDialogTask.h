@@ -16,6 +16,8 @@ public:
         }
     }
 
+    virtual b32 IsParallel() const override { return true; }
+
     virtual void Handle() override
     {
         if (m_status != AITASK_INPROCESS)
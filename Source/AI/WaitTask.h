@@ -11,5 +11,6 @@ public:
     WaitTask(Actor* pActor, f32 wait) : AITask(pActor, AITASK_WAIT), m_wait(wait) {}
 
     virtual void Handle() override;
+    virtual b32 IsParallel() const override { return true; }
 };
 
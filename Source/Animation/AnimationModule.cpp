@@ -1,31 +1,171 @@
+#include "Engine/StdHeaders.h"
 #include "Animation/AnimationModule.h"
 
-static constexpr i32f MAX_ANIMATIONS = 256;
+static constexpr s32 START_BLOCK_CAPACITY = 4;
 
 void AnimationModule::StartUp()
 {
-    m_aAnims = new Animation[MAX_ANIMATIONS];
-    m_usedAnims = 0;
+    m_apBlocks = nullptr;
+    m_blockCount = 0;
+    m_blockCapacity = 0;
+    m_clipCount = 0;
 
     AddNote(PR_NOTE, "Module started");
 }
 
 void AnimationModule::ShutDown()
 {
-    delete[] m_aAnims;
+    UndefineAnimations();
+
+    for (i32f i = 0; i < m_blockCount; ++i)
+    {
+        delete[] m_apBlocks[i];
+    }
+    if (m_apBlocks)
+    {
+        delete[] m_apBlocks;
+        m_apBlocks = nullptr;
+    }
+    m_blockCount = 0;
+    m_blockCapacity = 0;
 
     AddNote(PR_NOTE, "Module shut down");
 }
 
 const Animation* AnimationModule::DefineAnimation(const Animation& anim)
 {
-    if (m_usedAnims >= MAX_ANIMATIONS)
+    char key[KEY_LENGTH];
+    MakeKey(anim, key);
+
+    Clip** ppClip = m_tabClips.Find(key);
+    if (ppClip)
     {
-        AddNote(PR_WARNING, "There're no free slot for animations");
-        return nullptr;
+        return &(*ppClip)->anim;
     }
 
-    m_aAnims[m_usedAnims] = anim;
-    ++m_usedAnims;
-    return &m_aAnims[m_usedAnims-1];
+    Clip* pClip = AllocateClip();
+    pClip->anim = anim;
+    std::memcpy(pClip->key, key, KEY_LENGTH);
+
+    // Key of clip never moves, table may point to it
+    m_tabClips.Insert(pClip->key, pClip);
+    return &pClip->anim;
+}
+
+const Animation* AnimationModule::DefineAnimation(const char* name, const Animation& anim)
+{
+    const Animation* pAnim = DefineAnimation(anim);
+
+    NamedClip* pNamed = m_tabNames.Find(name);
+    if (pNamed)
+    {
+        pNamed->pAnim = pAnim;
+        return pAnim;
+    }
+
+    size_t length = std::strlen(name);
+    char* nameCopy = new char[length + 1];
+    std::memcpy(nameCopy, name, length + 1);
+
+    m_tabNames.Insert(nameCopy, { nameCopy, pAnim });
+    return pAnim;
+}
+
+const Animation* AnimationModule::FindAnimation(const char* name)
+{
+    NamedClip* pNamed = m_tabNames.Find(name);
+    return pNamed ? pNamed->pAnim : nullptr;
+}
+
+void AnimationModule::UndefineAnimations()
+{
+    for (i32f i = 0; i < m_tabNames.GetCapacity(); ++i)
+    {
+        NamedClip* pNamed = m_tabNames.GetAt(i);
+        if (pNamed)
+        {
+            delete[] pNamed->name;
+        }
+    }
+
+    m_tabNames.Clean();
+    m_tabClips.Clean();
+    m_clipCount = 0;
+}
+
+void AnimationModule::Tick(f32 dtTime, const AnimationBatch& batch, s32 first, s32 last) const
+{
+    for (i32f i = first; i < last; ++i)
+    {
+        const Animation* pAnim = batch.apAnim[i];
+        if (!(batch.aFlags[i] & batch.flag) || !pAnim)
+        {
+            continue;
+        }
+
+        // Update timer
+        f32 elapsed = batch.aElapsed[i] + dtTime;
+        s32 frame = batch.aFrame[i];
+        u8 mode = batch.aMode[i];
+
+        if (mode == ANIMATION_MODE_HOLD || elapsed <= pAnim->frameDuration)
+        {
+            batch.aElapsed[i] = elapsed;
+
+            // New looped animation may have less frames
+            if (mode == ANIMATION_MODE_LOOP && frame >= pAnim->count)
+            {
+                batch.aFrame[i] = 0;
+            }
+            continue;
+        }
+
+        // Update frame
+        if (mode == ANIMATION_MODE_ONCE && frame >= pAnim->count - 1)
+        {
+            batch.aElapsed[i] = elapsed;
+            batch.aMode[i] = ANIMATION_MODE_HOLD;
+            batch.aEnded[SDL_AtomicAdd(batch.pEndedCount, 1)] = (s32)i;
+            continue;
+        }
+
+        ++frame;
+        batch.aFrame[i] = mode == ANIMATION_MODE_LOOP && frame >= pAnim->count ? 0 : frame;
+        batch.aElapsed[i] = 0.0f;
+    }
+}
+
+AnimationModule::Clip* AnimationModule::AllocateClip()
+{
+    s32 block = m_clipCount / CLIPS_PER_BLOCK;
+    if (block >= m_blockCount)
+    {
+        // Grow array of blocks, blocks themselves stay in place
+        if (m_blockCount >= m_blockCapacity)
+        {
+            s32 capacity = m_blockCapacity ? m_blockCapacity * 2 : START_BLOCK_CAPACITY;
+            Clip** apBlocks = new Clip*[capacity];
+            if (m_apBlocks)
+            {
+                std::memcpy(apBlocks, m_apBlocks, m_blockCount * sizeof(Clip*));
+                delete[] m_apBlocks;
+            }
+
+            m_apBlocks = apBlocks;
+            m_blockCapacity = capacity;
+        }
+
+        m_apBlocks[m_blockCount++] = new Clip[CLIPS_PER_BLOCK];
+    }
+
+    Clip* pClip = &m_apBlocks[block][m_clipCount % CLIPS_PER_BLOCK];
+    ++m_clipCount;
+    return pClip;
+}
+
+void AnimationModule::MakeKey(const Animation& anim, char* key)
+{
+    u32 durationBits;
+    std::memcpy(&durationBits, &anim.frameDuration, sizeof(durationBits));
+    std::snprintf(key, KEY_LENGTH, "%d:%d:%08X", anim.row, anim.count, durationBits);
 }
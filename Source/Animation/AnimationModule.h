@@ -1,6 +1,8 @@
 #pragma once
 
+#include "SDL.h"
 #include "Engine/EngineModule.h"
+#include "Containers/NameTable.h"
 
 struct Animation
 {
@@ -9,10 +11,62 @@ struct Animation
     f32 frameDuration;
 };
 
+enum eAnimationMode
+{
+    ANIMATION_MODE_LOOP = 0, /** Wraps to the first frame */
+    ANIMATION_MODE_ONCE,     /** Reports end on the last frame, then holds */
+    ANIMATION_MODE_HOLD,     /** Frame is kept, only elapsed time goes */
+};
+
+/**
+ * Packed animation state of many owners. Indices of owners which ONCE
+ * animation ended are appended to aEnded, it must fit all owners
+ */
+struct AnimationBatch
+{
+    const Animation** apAnim;
+    s32* aFrame;
+    f32* aElapsed;
+    u8* aMode;
+
+    /** Only owners with flag are advanced */
+    const u32* aFlags;
+    u32 flag;
+
+    s32* aEnded;
+    SDL_atomic_t* pEndedCount;
+};
+
+/**
+ * Clips are registered by (row, count, frameDuration), defining the same
+ * tuple again gives the same clip. Clips may be named for lookup from
+ * scripts, several names may share one clip. Clips are stored in blocks
+ * which never move, so pointers are valid until animations are undefined
+ */
 class AnimationModule final : public EngineModule
 {
-    Animation* m_aAnims;
-    s32 m_usedAnims;
+    static constexpr i32f CLIPS_PER_BLOCK = 64;
+    static constexpr i32f KEY_LENGTH = 32;
+
+    struct Clip
+    {
+        Animation anim;
+        char key[KEY_LENGTH];
+    };
+
+    struct NamedClip
+    {
+        char* name;
+        const Animation* pAnim;
+    };
+
+    Clip** m_apBlocks;
+    s32 m_blockCount;
+    s32 m_blockCapacity;
+    s32 m_clipCount;
+
+    TNameTable<Clip*> m_tabClips;
+    TNameTable<NamedClip> m_tabNames;
 
 public:
     AnimationModule() : EngineModule("AnimationModule", CHANNEL_ANIMATION) {}
@@ -21,7 +75,27 @@ public:
     void ShutDown();
 
     const Animation* DefineAnimation(const Animation& anim);
-    forceinline void UndefineAnimations() { m_usedAnims = 0; }
+
+    /** Previous clip of name is replaced */
+    const Animation* DefineAnimation(const char* name, const Animation& anim);
+
+    /** Null if there's no such name */
+    const Animation* FindAnimation(const char* name);
+
+    /** Blocks are kept for next definitions */
+    void UndefineAnimations();
+
+    forceinline s32 GetAnimationCount() const { return m_clipCount; }
+    forceinline s32 GetNameCount() const { return m_tabNames.GetCount(); }
+
+    /** Advances [first, last) of batch, ranges may be ticked on different threads */
+    void Tick(f32 dtTime, const AnimationBatch& batch, s32 first, s32 last) const;
+
+private:
+    Clip* AllocateClip();
+
+    /** Exact bits of duration, so only identical tuples share key */
+    static void MakeKey(const Animation& anim, char* key);
 };
 
 inline AnimationModule g_animModule;
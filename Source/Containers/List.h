@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Types.h"
+#include "Engine/MemoryTracker.h"
 
 template<class T>
 class TList
@@ -93,6 +94,7 @@ inline void TList<T>::Move(TList<T>& lstDest, TList<T>& lstSrc)
 template<class T>
 inline void TList<T>::Push(const T& data)
 {
+    MemoryScope scope(MEMORY_CONTAINERS, true);
     Item* pTemp = new Item(data, m_pFirst);
     m_pFirst = pTemp;
     if (!m_pLast)
@@ -104,6 +106,7 @@ inline void TList<T>::Push(const T& data)
 template<class T>
 inline void TList<T>::PushBack(const T& data)
 {
+    MemoryScope scope(MEMORY_CONTAINERS, true);
     Item* pTemp = new Item(data, nullptr);
     if (m_pLast)
     {
@@ -140,6 +143,7 @@ inline void TList<T>::PushBefore(Iterator& beforeIterator, const T& data)
     }
 
     // Allocate new item
+    MemoryScope scope(MEMORY_CONTAINERS, true);
     Item* pNew = new Item(data, beforeIterator.pItem);
     pTemp->pNext = pNew;
 }
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Engine/StdHeaders.h"
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+/**
+ * Open addressing hash table by string key, grows twice when it gets 3/4 full.
+ * Keys aren't copied, so key must live while it's in table. Values move
+ * when table grows, keep pointers to them only until next Insert()
+ */
+template<class T>
+class TNameTable
+{
+    static constexpr i32f START_CAPACITY = 64;
+
+    struct Slot
+    {
+        const char* key;
+        u32 hash;
+        T value;
+    };
+
+    Slot* m_aSlots;
+    s32 m_capacity;
+    s32 m_count;
+
+public:
+    TNameTable() : m_aSlots(nullptr), m_capacity(0), m_count(0) {}
+    forceinline ~TNameTable() { Clean(); }
+
+    TNameTable(const TNameTable&) = delete;
+    TNameTable& operator=(const TNameTable&) = delete;
+
+    /** Null if there's no such key */
+    T* Find(const char* key);
+
+    /** Key must not be in table yet */
+    T* Insert(const char* key, const T& value);
+
+    b32 Remove(const char* key);
+    void Clean();
+
+    forceinline s32 GetCount() const { return m_count; }
+
+    /** For iteration over slots, null if slot is empty */
+    forceinline s32 GetCapacity() const { return m_capacity; }
+    forceinline T* GetAt(i32f index) { return m_aSlots[index].key ? &m_aSlots[index].value : nullptr; }
+
+    /** FNV-1a */
+    forceinline static u32 Hash(const char* key)
+    {
+        u32 hash = 2166136261u;
+        for ( ; *key; ++key)
+        {
+            hash = (hash ^ (u8)*key) * 16777619u;
+        }
+        return hash;
+    }
+
+private:
+    /** -1 if there's no such key */
+    s32 FindSlot(const char* key) const;
+    void Grow();
+};
+
+template<class T>
+T* TNameTable<T>::Find(const char* key)
+{
+    s32 slot = FindSlot(key);
+    return slot >= 0 ? &m_aSlots[slot].value : nullptr;
+}
+
+template<class T>
+T* TNameTable<T>::Insert(const char* key, const T& value)
+{
+    if ((m_count + 1) * 4 > m_capacity * 3)
+    {
+        Grow();
+    }
+
+    u32 hash = Hash(key);
+    u32 mask = (u32)m_capacity - 1;
+
+    u32 i = hash & mask;
+    while (m_aSlots[i].key)
+    {
+        i = (i + 1) & mask;
+    }
+
+    m_aSlots[i].key = key;
+    m_aSlots[i].hash = hash;
+    m_aSlots[i].value = value;
+    ++m_count;
+
+    return &m_aSlots[i].value;
+}
+
+template<class T>
+b32 TNameTable<T>::Remove(const char* key)
+{
+    s32 slot = FindSlot(key);
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    u32 mask = (u32)m_capacity - 1;
+    u32 hole = (u32)slot;
+
+    // Shift back following slots which can't be found past hole anymore
+    for (u32 i = (hole + 1) & mask; m_aSlots[i].key; i = (i + 1) & mask)
+    {
+        u32 home = m_aSlots[i].hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            m_aSlots[hole] = m_aSlots[i];
+            hole = i;
+        }
+    }
+
+    m_aSlots[hole].key = nullptr;
+    m_aSlots[hole].value = T();
+    --m_count;
+
+    return true;
+}
+
+template<class T>
+void TNameTable<T>::Clean()
+{
+    if (m_aSlots)
+    {
+        delete[] m_aSlots;
+        m_aSlots = nullptr;
+    }
+    m_capacity = 0;
+    m_count = 0;
+}
+
+template<class T>
+s32 TNameTable<T>::FindSlot(const char* key) const
+{
+    if (!m_count)
+    {
+        return -1;
+    }
+
+    u32 hash = Hash(key);
+    u32 mask = (u32)m_capacity - 1;
+
+    for (u32 i = hash & mask; m_aSlots[i].key; i = (i + 1) & mask)
+    {
+        if (m_aSlots[i].hash == hash && std::strcmp(m_aSlots[i].key, key) == 0)
+        {
+            return (s32)i;
+        }
+    }
+
+    return -1;
+}
+
+template<class T>
+void TNameTable<T>::Grow()
+{
+    Slot* aOldSlots = m_aSlots;
+    s32 oldCapacity = m_capacity;
+
+    m_capacity = m_capacity ? m_capacity * 2 : START_CAPACITY;
+    m_aSlots = new Slot[m_capacity];
+    for (i32f i = 0; i < m_capacity; ++i)
+    {
+        m_aSlots[i].key = nullptr;
+        m_aSlots[i].hash = 0;
+        m_aSlots[i].value = T();
+    }
+
+    // Hashes are kept, so keys aren't touched again
+    u32 mask = (u32)m_capacity - 1;
+    for (i32f i = 0; i < oldCapacity; ++i)
+    {
+        if (!aOldSlots[i].key)
+        {
+            continue;
+        }
+
+        u32 j = aOldSlots[i].hash & mask;
+        while (m_aSlots[j].key)
+        {
+            j = (j + 1) & mask;
+        }
+        m_aSlots[j] = aOldSlots[i];
+    }
+
+    if (aOldSlots)
+    {
+        delete[] aOldSlots;
+    }
+}
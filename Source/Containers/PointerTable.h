@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Engine/StdHeaders.h"
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+/**
+ * Open addressing hash table by pointer key, grows twice when it gets 3/4 full.
+ * Keys are never dereferenced, so table may be asked about objects which are
+ * already deleted. Values move when table grows, same as in TNameTable
+ */
+template<class T>
+class TPointerTable
+{
+    static constexpr i32f START_CAPACITY = 64;
+
+    struct Slot
+    {
+        const void* key;
+        T value;
+    };
+
+    Slot* m_aSlots;
+    s32 m_capacity;
+    s32 m_count;
+
+public:
+    TPointerTable() : m_aSlots(nullptr), m_capacity(0), m_count(0) {}
+    forceinline ~TPointerTable() { Clean(); }
+
+    TPointerTable(const TPointerTable&) = delete;
+    TPointerTable& operator=(const TPointerTable&) = delete;
+
+    /** Null if there's no such key */
+    T* Find(const void* key);
+    forceinline const T* Find(const void* key) const { return const_cast<TPointerTable*>(this)->Find(key); }
+
+    /** Key must not be in table yet */
+    T* Insert(const void* key, const T& value);
+
+    b32 Remove(const void* key);
+
+    /** Empties table but keeps its memory */
+    void Reset();
+    void Clean();
+
+    forceinline s32 GetCount() const { return m_count; }
+
+    /** Fibonacci hashing, low bits of pointers are always zero */
+    forceinline static u32 Hash(const void* key)
+    {
+        return (u32)(((u64)(uintptr_t)key * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+private:
+    /** -1 if there's no such key */
+    s32 FindSlot(const void* key) const;
+    void Grow();
+};
+
+template<class T>
+T* TPointerTable<T>::Find(const void* key)
+{
+    s32 slot = FindSlot(key);
+    return slot >= 0 ? &m_aSlots[slot].value : nullptr;
+}
+
+template<class T>
+T* TPointerTable<T>::Insert(const void* key, const T& value)
+{
+    if ((m_count + 1) * 4 > m_capacity * 3)
+    {
+        Grow();
+    }
+
+    u32 mask = (u32)m_capacity - 1;
+
+    u32 i = Hash(key) & mask;
+    while (m_aSlots[i].key)
+    {
+        i = (i + 1) & mask;
+    }
+
+    m_aSlots[i].key = key;
+    m_aSlots[i].value = value;
+    ++m_count;
+
+    return &m_aSlots[i].value;
+}
+
+template<class T>
+b32 TPointerTable<T>::Remove(const void* key)
+{
+    s32 slot = FindSlot(key);
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    u32 mask = (u32)m_capacity - 1;
+    u32 hole = (u32)slot;
+
+    // Shift back following slots which can't be found past hole anymore
+    for (u32 i = (hole + 1) & mask; m_aSlots[i].key; i = (i + 1) & mask)
+    {
+        u32 home = Hash(m_aSlots[i].key) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            m_aSlots[hole] = m_aSlots[i];
+            hole = i;
+        }
+    }
+
+    m_aSlots[hole].key = nullptr;
+    m_aSlots[hole].value = T();
+    --m_count;
+
+    return true;
+}
+
+template<class T>
+void TPointerTable<T>::Reset()
+{
+    for (i32f i = 0; i < m_capacity; ++i)
+    {
+        m_aSlots[i].key = nullptr;
+        m_aSlots[i].value = T();
+    }
+    m_count = 0;
+}
+
+template<class T>
+void TPointerTable<T>::Clean()
+{
+    if (m_aSlots)
+    {
+        delete[] m_aSlots;
+        m_aSlots = nullptr;
+    }
+    m_capacity = 0;
+    m_count = 0;
+}
+
+template<class T>
+s32 TPointerTable<T>::FindSlot(const void* key) const
+{
+    if (!m_count || !key)
+    {
+        return -1;
+    }
+
+    u32 mask = (u32)m_capacity - 1;
+
+    for (u32 i = Hash(key) & mask; m_aSlots[i].key; i = (i + 1) & mask)
+    {
+        if (m_aSlots[i].key == key)
+        {
+            return (s32)i;
+        }
+    }
+
+    return -1;
+}
+
+template<class T>
+void TPointerTable<T>::Grow()
+{
+    Slot* aOldSlots = m_aSlots;
+    s32 oldCapacity = m_capacity;
+
+    m_capacity = m_capacity ? m_capacity * 2 : START_CAPACITY;
+    m_aSlots = new Slot[m_capacity];
+    for (i32f i = 0; i < m_capacity; ++i)
+    {
+        m_aSlots[i].key = nullptr;
+        m_aSlots[i].value = T();
+    }
+
+    u32 mask = (u32)m_capacity - 1;
+    for (i32f i = 0; i < oldCapacity; ++i)
+    {
+        if (!aOldSlots[i].key)
+        {
+            continue;
+        }
+
+        u32 j = Hash(aOldSlots[i].key) & mask;
+        while (m_aSlots[j].key)
+        {
+            j = (j + 1) & mask;
+        }
+        m_aSlots[j] = aOldSlots[i];
+    }
+
+    if (aOldSlots)
+    {
+        delete[] aOldSlots;
+    }
+}
@@ -26,31 +26,19 @@ void CollisionManager::CheckCollision(const Vector2& vPoint, const FRect& hitBox
     };
 
     // Try to find entities that lie on the rectangle
-    auto& lstWorldEntity = g_game.GetWorld().GetEntityList();
+    EntityStore& store = g_game.GetWorld().GetEntityStore();
+    s32 count = store.Query(checkRect);
 
-    for (auto it = lstWorldEntity.Begin(); it; ++it)
+    for (i32f i = 0; i < count; ++i)
     {
-        if (it->data == pExcept || !it->data->m_bCollidable)
+        Entity* pEntity = store.GetQueryEntity(i);
+        if (pEntity == pExcept || !pEntity->Collidable())
         {
             continue;
         }
 
-        // Get entity hitbox in world coords
-        const Vector2& vEntity = it->data->m_vPosition;
-        const FRect& entityBox = it->data->m_hitBox;
-        FRect entityRect = {
-            vEntity.x + entityBox.x1, vEntity.y + entityBox.y1,
-            vEntity.x + entityBox.x2, vEntity.y + entityBox.y2
-        };
-
-        // Check collision
-        if (entityRect.x1 > checkRect.x2) continue;
-        if (entityRect.x2 < checkRect.x1) continue;
-        if (entityRect.y1 > checkRect.y2) continue;
-        if (entityRect.y2 < checkRect.y1) continue;
-
         // Push entity
-        lstEntity.Push(it->data);
+        lstEntity.Push(pEntity);
     }
 }
 
@@ -63,30 +51,18 @@ void CollisionManager::CheckCollision(const Vector2& vPoint, const FRect& hitBox
     };
 
     // Try to find entities that lie on the rectangle
-    auto& lstWorldEntity = g_game.GetWorld().GetEntityList();
+    EntityStore& store = g_game.GetWorld().GetEntityStore();
+    s32 count = store.Query(checkRect);
 
-    for (auto it = lstWorldEntity.Begin(); it; ++it)
+    for (i32f i = 0; i < count; ++i)
     {
-        if (it->data == pExcept || !it->data->m_bCollidable || !predicate(it->data, userdata))
+        Entity* pEntity = store.GetQueryEntity(i);
+        if (pEntity == pExcept || !pEntity->Collidable() || !predicate(pEntity, userdata))
         {
             continue;
         }
 
-        // Get entity hitbox in world coords
-        const Vector2& vEntity = it->data->m_vPosition;
-        const FRect& entityBox = it->data->m_hitBox;
-        FRect entityRect = {
-            vEntity.x + entityBox.x1, vEntity.y + entityBox.y1,
-            vEntity.x + entityBox.x2, vEntity.y + entityBox.y2
-        };
-
-        // Check collision
-        if (entityRect.x1 > checkRect.x2) continue;
-        if (entityRect.x2 < checkRect.x1) continue;
-        if (entityRect.y1 > checkRect.y2) continue;
-        if (entityRect.y2 < checkRect.y1) continue;
-
         // Push entity
-        lstEntity.Push(it->data);
+        lstEntity.Push(pEntity);
     }
 }
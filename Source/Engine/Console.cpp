@@ -8,6 +8,7 @@ static constexpr i32f CONSOLE_STRING_WIDTH = 80;
 static constexpr i32f CONSOLE_STRING_HEIGHT = 15;
 static constexpr i32f CONSOLE_BUFSIZE = (CONSOLE_STRING_WIDTH * CONSOLE_STRING_HEIGHT) + 1;
 static constexpr i32f LAST_BUFSIZE = CONSOLE_STRING_WIDTH + 1;
+static constexpr i32f PENDING_BUFSIZE = 4096;
 
 static constexpr i32f CONSOLE_INPUT_INDEX = CONSOLE_STRING_WIDTH * (CONSOLE_STRING_HEIGHT - 1);
 static constexpr char CONSOLE_PROMPT[] = "> ";
@@ -23,6 +24,12 @@ void Console::StartUp()
     m_lastInput = new u8[CONSOLE_STRING_WIDTH + 1];
     std::memcpy(m_lastInput, &m_buffer[CONSOLE_INPUT_INDEX], LAST_BUFSIZE);
 
+    // Allocate pending text buffer
+    m_pending = new char[PENDING_BUFSIZE];
+    m_pending[0] = 0;
+    m_pendingLength = 0;
+    m_pendingLock = 0;
+
     // Defaults
     m_bShown = false;
     m_lastInputPosition = m_currentInput;
@@ -39,6 +46,11 @@ void Console::ShutDown()
     {
         delete[] m_lastInput;
     }
+    if (m_pending)
+    {
+        delete[] m_pending;
+        m_pending = nullptr;
+    }
 }
 
 void Console::Render() const
@@ -85,7 +97,51 @@ void Console::Render() const
     g_graphicsModule.FillRect(RENDER_MODE_DEBUG, 999, true, dest);
 }
 
+void Console::Update()
+{
+    SDL_AtomicLock(&m_pendingLock);
+    if (m_pendingLength > 0)
+    {
+        Write(m_pending);
+        m_pending[0] = 0;
+        m_pendingLength = 0;
+    }
+    SDL_AtomicUnlock(&m_pendingLock);
+}
+
 void Console::Print(const char* text)
+{
+    if (!m_pending)
+    {
+        return;
+    }
+
+    // Only the tail fits
+    s32 length = (s32)std::strlen(text);
+    if (length > PENDING_BUFSIZE - 1)
+    {
+        text += length - (PENDING_BUFSIZE - 1);
+        length = PENDING_BUFSIZE - 1;
+    }
+
+    SDL_AtomicLock(&m_pendingLock);
+
+    // Oldest text would scroll out of console anyway
+    s32 overflow = m_pendingLength + length - (PENDING_BUFSIZE - 1);
+    if (overflow > 0)
+    {
+        std::memmove(m_pending, m_pending + overflow, m_pendingLength - overflow);
+        m_pendingLength -= overflow;
+    }
+
+    std::memcpy(m_pending + m_pendingLength, text, length);
+    m_pendingLength += length;
+    m_pending[m_pendingLength] = 0;
+
+    SDL_AtomicUnlock(&m_pendingLock);
+}
+
+void Console::Write(const char* text)
 {
     for (i32f y = m_currentRow * CONSOLE_STRING_WIDTH, x = 0, j = 0; text[j]; ++x, ++j)
     {
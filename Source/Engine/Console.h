@@ -1,5 +1,6 @@
 #pragma once
 
+#include "SDL.h"
 #include "Engine/EngineModule.h"
 
 class Console : public EngineModule
@@ -15,22 +16,31 @@ class Console : public EngineModule
     s32 m_lastInputPosition;
     s32 m_lastCursorPosition;
 
+    char* m_pending;          /** Text printed since last Update() */
+    s32 m_pendingLength;
+    SDL_SpinLock m_pendingLock;
+
 public:
     Console() : EngineModule("Console", CHANNEL_LOGMGR) {}
 
     void StartUp();
     void ShutDown();
 
+    /** Moves printed text into buffer, only main thread touches buffer */
+    void Update();
     void Render() const;
 
     forceinline void Toggle(b32 bToggle) { m_bShown = bToggle; }
     forceinline b32 IsShown() const { return m_bShown; }
 
+    /** May be called from any thread, text is shown on next Update() */
     void Print(const char* text);
     void Input(i32f ch);
     void Clear();
 
 private:
+    void Write(const char* text);
+
     void Arrow(i32f ch);
     void Interpret();
 
@@ -1,22 +1,23 @@
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#endif
+
+#include <ctime>
 #include <filesystem>
 #include "Engine/StdHeaders.h"
 #include "Engine/Console.h"
 #include "Engine/DebugLogManager.h"
 #include "Engine/Assert.h"
 
-static constexpr i32f NOTE_PREFIX_BUFSIZE  = 64;
-static constexpr i32f NOTE_MESSAGE_BUFSIZE = 512;
-static constexpr i32f NOTE_FINAL_BUFSIZE   = 1024;
-
-static constexpr char PRIORITY_PREFIX_UNDEFINED[] = "Undefined";
-static constexpr char PRIORITY_PREFIX_ERROR[]     = "Error";
-static constexpr char PRIORITY_PREFIX_WARNING[]   = "Warning";
-static constexpr char PRIORITY_PREFIX_NOTE[]      = "Note";
+/** Writer wakes up this often even if nobody woke it */
+static constexpr u32 WRITER_PERIOD = 50;
 
-#define DIR_LOGS "Logs\\"
+#define DIR_LOGS "Logs/"
 #define LOGS_EXTENSION ".log"
 
 static constexpr char FILENAME_LOGFULL[]         = DIR_LOGS "LogFull" LOGS_EXTENSION;
+static constexpr char FILENAME_LOGBINARY[]       = DIR_LOGS "Log.gtlog";
 static constexpr char FILENAME_DEBUGLOGMANAGER[] = DIR_LOGS "DebugLogManager" LOGS_EXTENSION;
 static constexpr char FILENAME_GT2D[]            = DIR_LOGS "GT2D" LOGS_EXTENSION;
 static constexpr char FILENAME_GRAPHICSMODULE[]  = DIR_LOGS "GraphicsModule" LOGS_EXTENSION;
@@ -86,186 +87,678 @@ enum ePriorityColor
     PRIORITY_COLOR_NOTE      = 0,
 };
 
+struct LogChannel
+{
+    s32 channel;
+    s32 color;
+    const char* fileName;
+};
+
+static constexpr LogChannel LOG_CHANNELS[] = {
+    { CHANNEL_LOGMGR,    CHANNEL_COLOR_LOGMGR,    FILENAME_DEBUGLOGMANAGER },
+    { CHANNEL_GT2D,      CHANNEL_COLOR_GT2D,      FILENAME_GT2D },
+    { CHANNEL_GRAPHICS,  CHANNEL_COLOR_GRAPHICS,  FILENAME_GRAPHICSMODULE },
+    { CHANNEL_INPUT,     CHANNEL_COLOR_INPUT,     FILENAME_INPUTMODULE },
+    { CHANNEL_SOUND,     CHANNEL_COLOR_SOUND,     FILENAME_SOUNDMODULE },
+    { CHANNEL_ANIMATION, CHANNEL_COLOR_ANIMATION, FILENAME_ANIMATIONMODULE },
+    { CHANNEL_SCRIPT,    CHANNEL_COLOR_SCRIPT,    FILENAME_SCRIPTMODULE },
+    { CHANNEL_GAME,      CHANNEL_COLOR_GAME,      FILENAME_GAME }
+};
+
+/** Index into LOG_CHANNELS, -1 if channel is unknown */
+internal s32 FindChannel(s32 channel)
+{
+    for (i32f i = 0; i < (i32f)(sizeof(LOG_CHANNELS) / sizeof(LOG_CHANNELS[0])); ++i)
+    {
+        if (LOG_CHANNELS[i].channel == channel)
+        {
+            return (s32)i;
+        }
+    }
+    return -1;
+}
+
+internal s32 GetPriorityColor(s32 priority)
+{
+    switch (priority)
+    {
+    case PR_ERROR:   return PRIORITY_COLOR_ERROR;
+    case PR_WARNING: return PRIORITY_COLOR_WARNING;
+    case PR_NOTE:    return PRIORITY_COLOR_NOTE;
+    default:         return PRIORITY_COLOR_UNDEFINED;
+    }
+}
+
+internal s32 ClampLength(s32 length, s32 maxLength)
+{
+    return length < 0 ? 0 : (length > maxLength ? maxLength : length);
+}
+
+/** Ring positions wrap around, so they're compared by difference */
+forceinline s32 PositionDiff(s32 a, s32 b)
+{
+    return (s32)((u32)a - (u32)b);
+}
+
+forceinline s32 PositionAdd(s32 position, s32 count)
+{
+    return (s32)((u32)position + (u32)count);
+}
+
+/** Formatted note with prefix, longer ones are cut */
+static constexpr s32 TEXT_SIZE = 1024;
+
 void DebugLogManager::StartUp()
 {
-#ifdef _DEBUG
+#if defined(_DEBUG) && defined(_WIN32)
     // Allocate windows console
     b32 bRes = AllocConsole();
     DebugAssert(bRes);
-    hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    m_hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 #endif
 
     // Start up engine's console
     g_console.StartUp();
 
-    // Open all log files
+    // Ring, every slot waits for producer of its position
+    m_aRing = new Record[RING_SIZE];
+    for (i32f i = 0; i < RING_SIZE; ++i)
+    {
+        SDL_AtomicSet(&m_aRing[i].sequence, (s32)i);
+    }
+
+    SDL_AtomicSet(&m_enqueuePos, 0);
+    SDL_AtomicSet(&m_writtenPos, 0);
+    SDL_AtomicSet(&m_droppedCount, 0);
+    m_dequeuePos = 0;
+    m_reportedDrops = 0;
+    m_syncLock = 0;
+    m_pWriterThread = nullptr;
+
+    std::memset(m_aRateSites, 0, sizeof(m_aRateSites));
+    m_startTicks = SDL_GetTicks();
+
+    // Open log files, notes are written right away until writer runs
     std::filesystem::create_directory(DIR_LOGS);
 
-    hLogFull = std::fopen(FILENAME_LOGFULL, "w");
-    ShipAssert(hLogFull);
+#ifdef GT2D_LOG_BINARY
+    // Everything goes once into one file
+    OpenBatch(m_full, FILENAME_LOGBINARY, "wb");
+    ShipAssert(m_full.hFile);
+
+    m_aFormats = new FormatSlot[FORMAT_SLOTS];
+    std::memset(m_aFormats, 0, sizeof(FormatSlot) * FORMAT_SLOTS);
+    m_formatCount = 0;
+
+    LogFileHeader header;
+    std::memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+    header.version = LOG_VERSION;
+    header.startTime = (u64)std::time(nullptr);
+    Append(m_full, (const char*)&header, sizeof(header));
+#else
+    OpenBatch(m_full, FILENAME_LOGFULL, "w");
+    ShipAssert(m_full.hFile);
+
+    for (i32f i = 0; i < CHANNEL_COUNT; ++i)
+    {
+        OpenBatch(m_aChannels[i], LOG_CHANNELS[i].fileName, "w");
+        if (!m_aChannels[i].hFile)
+        {
+            LogNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
+        }
+    }
+#endif
+
+#ifndef _WIN32
+    m_console.hFile = stdout;
+    m_console.aBuffer = new char[BATCH_SIZE];
+    m_console.size = 0;
+#endif
+    m_consoleTextSize = 0;
 
-    if ( nullptr == (hLogMgr = std::fopen(FILENAME_DEBUGLOGMANAGER, "w")) )  AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
-    if ( nullptr == (hGT2D = std::fopen(FILENAME_GT2D, "w")) )               AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
-    if ( nullptr == (hGraphics = std::fopen(FILENAME_GRAPHICSMODULE, "w")) ) AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
-    if ( nullptr == (hInput = std::fopen(FILENAME_INPUTMODULE, "w")) )       AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
-    if ( nullptr == (hSound = std::fopen(FILENAME_SOUNDMODULE, "w")) )       AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
-    if ( nullptr == (hAnim = std::fopen(FILENAME_ANIMATIONMODULE, "w")) )    AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
-    if ( nullptr == (hScript = std::fopen(FILENAME_SCRIPTMODULE, "w")) )     AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
-    if ( nullptr == (hGame = std::fopen(FILENAME_GAME, "w")) )               AddNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't open log file: %s", strerror(errno));
+    // Run writer
+    SDL_AtomicSet(&m_bQuit, 0);
+    m_pWake = SDL_CreateSemaphore(0);
+    m_pWriterThread = m_pWake ? SDL_CreateThread(WriterMain, "GT2D Log", this) : nullptr;
+    if (!m_pWriterThread)
+    {
+        LogNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "Can't create writer thread, notes are written on calling thread: %s", SDL_GetError());
+    }
 
-    AddNote(CHANNEL_LOGMGR, PR_NOTE, "DebugLogManager", "Manager started");
+    LogNote(CHANNEL_LOGMGR, PR_NOTE, "DebugLogManager", "Manager started");
 }
 
 void DebugLogManager::ShutDown()
 {
-    AddNote(CHANNEL_LOGMGR, PR_NOTE, "DebugLogManager", "Manager shut down");
+    // Make room for the last notes
+    Flush();
+    LogNote(CHANNEL_LOGMGR, PR_NOTE, "DebugLogManager", "Manager shut down");
+
+    // Writer drains everything before it quits
+    if (m_pWriterThread)
+    {
+        SDL_AtomicSet(&m_bQuit, 1);
+        SDL_SemPost(m_pWake);
+        SDL_WaitThread(m_pWriterThread, nullptr);
+        m_pWriterThread = nullptr;
+    }
+    if (m_pWake)
+    {
+        SDL_DestroySemaphore(m_pWake);
+        m_pWake = nullptr;
+    }
+
+    // Nobody else writes now
+    WriteMuted();
 
     // Close log files
-    std::fclose(hLogFull);
-    std::fclose(hLogMgr);
-    std::fclose(hGT2D);
-    std::fclose(hGraphics);
-    std::fclose(hInput);
-    std::fclose(hSound);
-    std::fclose(hAnim);
-    std::fclose(hScript);
-    std::fclose(hGame);
+    CloseBatch(m_full);
+    for (i32f i = 0; i < CHANNEL_COUNT; ++i)
+    {
+        CloseBatch(m_aChannels[i]);
+    }
+
+#ifndef _WIN32
+    FlushBatch(m_console);
+    delete[] m_console.aBuffer;
+    m_console.aBuffer = nullptr;
+    m_console.hFile = nullptr;
+#endif
+
+    delete[] m_aRing;
+    m_aRing = nullptr;
+
+#ifdef GT2D_LOG_BINARY
+    delete[] m_aFormats;
+    m_aFormats = nullptr;
+#endif
 
     // Detach consoles
     g_console.ShutDown();
-#ifdef _DEBUG
+#if defined(_DEBUG) && defined(_WIN32)
     FreeConsole();
 #endif
 }
 
-void DebugLogManager::VAddNote(s32 channel, s32 priority, const char* name, const char* fmt, std::va_list vl)
+DebugLogManager::Record* DebugLogManager::BeginRecord(s32 channel, s32 priority, const char* name, const char* fmt, u32 site)
+{
+    // Errors are never muted
+    s32 repeated = 0;
+    if (priority != PR_ERROR)
+    {
+        repeated = CheckRate(name, fmt, site);
+        if (repeated == -1)
+        {
+            return nullptr;
+        }
+    }
+
+    Record* pRecord;
+
+    // Without writer note is written under lock when it's packed
+    if (!m_pWriterThread)
+    {
+        SDL_AtomicLock(&m_syncLock);
+        pRecord = &m_syncRecord;
+    }
+    else
+    {
+        // Claim slot, drop note if writer is a whole ring behind
+        s32 position = SDL_AtomicGet(&m_enqueuePos);
+        for ( ;; )
+        {
+            pRecord = &m_aRing[position & (RING_SIZE - 1)];
+            s32 diff = PositionDiff(SDL_AtomicGet(&pRecord->sequence), position);
+
+            if (diff == 0)
+            {
+                if (SDL_AtomicCAS(&m_enqueuePos, position, PositionAdd(position, 1)))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Errors wait for writer instead
+                if (priority != PR_ERROR)
+                {
+                    SDL_AtomicAdd(&m_droppedCount, 1 + repeated);
+                    return nullptr;
+                }
+
+                SDL_SemPost(m_pWake);
+                SDL_Delay(1);
+            }
+
+            position = SDL_AtomicGet(&m_enqueuePos);
+        }
+    }
+
+    pRecord->channel = channel;
+    pRecord->priority = priority;
+    pRecord->repeated = repeated;
+    pRecord->time = SDL_GetTicks() - m_startTicks;
+    pRecord->name = name;
+    pRecord->fmt = fmt;
+    pRecord->argsSize = 0;
+
+    return pRecord;
+}
+
+void DebugLogManager::EndRecord(Record& record)
+{
+    if (&record == &m_syncRecord)
+    {
+        WriteRecord(record);
+        FlushBatches();
+        SDL_AtomicUnlock(&m_syncLock);
+        return;
+    }
+
+    // Publish, sequence was position of slot
+    s32 position = SDL_AtomicGet(&record.sequence);
+    SDL_AtomicSet(&record.sequence, PositionAdd(position, 1));
+
+    // Errors usually go right before crash, so they can't wait in ring
+    if (record.priority == PR_ERROR)
+    {
+        Flush();
+    }
+    else if ((position & (RING_SIZE / 4 - 1)) == 0)
+    {
+        SDL_SemPost(m_pWake);
+    }
+}
+
+s32 DebugLogManager::CheckRate(const char* name, const char* fmt, u32 site)
 {
-    std::FILE* hFile;
-    const char* priorityName = "";
-    WORD noteColor = 0;
+    RateSite& rate = m_aRateSites[site & (RATE_SITES - 1)];
+    u32 now = SDL_GetTicks();
+    s32 repeated = 0;
+
+    SDL_AtomicLock(&rate.lock);
 
-    // Foreground color and channel prefix
-    switch (channel)
+    if (rate.key != site || rate.fmt != fmt)
+    {
+        // Other site takes the place, its muted notes are counted as dropped
+        repeated = rate.muted;
+        rate.key = site;
+        rate.name = name;
+        rate.fmt = fmt;
+        rate.windowStart = now;
+        rate.count = 1;
+        rate.muted = 0;
+
+        if (repeated)
+        {
+            SDL_AtomicAdd(&m_droppedCount, repeated);
+            repeated = 0;
+        }
+    }
+    else if (now - rate.windowStart >= RATE_WINDOW)
+    {
+        repeated = rate.muted;
+        rate.windowStart = now;
+        rate.count = 1;
+        rate.muted = 0;
+    }
+    else if (rate.count < RATE_BURST)
+    {
+        ++rate.count;
+    }
+    else
+    {
+        ++rate.muted;
+        repeated = -1;
+    }
+
+    SDL_AtomicUnlock(&rate.lock);
+    return repeated;
+}
+
+void DebugLogManager::PackString(Record& record, const char* value)
+{
+    if (!value)
     {
-    case CHANNEL_LOGMGR:
+        value = "(null)";
+    }
+
+    // Type, length, text and null
+    s32 room = ARGS_SIZE - record.argsSize - 1 - (s32)sizeof(u16) - 1;
+    if (room < 0)
     {
-        hFile = hLogMgr;
-        noteColor |= CHANNEL_COLOR_LOGMGR;
-    } break;
+        return;
+    }
+
+    u16 length = (u16)ClampLength((s32)std::strlen(value), room);
+
+    u8* pArg = &record.aArgs[record.argsSize];
+    pArg[0] = (u8)LOG_ARG_STRING;
+    std::memcpy(pArg + 1, &length, sizeof(length));
+    std::memcpy(pArg + 1 + sizeof(length), value, length);
+    pArg[1 + sizeof(length) + length] = '\0';
+
+    record.argsSize += 1 + (s32)sizeof(length) + length + 1;
+}
 
-    case CHANNEL_GT2D:
+void DebugLogManager::Flush()
+{
+    if (!m_pWriterThread)
     {
-        hFile = hGT2D;
-        noteColor |= CHANNEL_COLOR_GT2D;
-    } break;
+        return;
+    }
 
-    case CHANNEL_GRAPHICS:
+    s32 target = SDL_AtomicGet(&m_enqueuePos);
+    SDL_SemPost(m_pWake);
+
+    while (PositionDiff(SDL_AtomicGet(&m_writtenPos), target) < 0)
     {
-        hFile = hGraphics;
-        noteColor |= CHANNEL_COLOR_GRAPHICS;
-    } break;
+        SDL_Delay(1);
+    }
+}
 
-    case CHANNEL_INPUT:
+s32 SDLCALL DebugLogManager::WriterMain(void* pData)
+{
+    DebugLogManager* pLog = (DebugLogManager*)pData;
+
+    while (!SDL_AtomicGet(&pLog->m_bQuit))
     {
-        hFile = hInput;
-        noteColor |= CHANNEL_COLOR_INPUT;
-    } break;
+        SDL_SemWaitTimeout(pLog->m_pWake, WRITER_PERIOD);
+        pLog->WriteRecords();
+    }
+
+    // Last notes
+    pLog->WriteRecords();
+    return 0;
+}
+
+b32 DebugLogManager::WriteRecords()
+{
+    b32 bWritten = false;
 
-    case CHANNEL_SOUND:
+    for ( ;; )
     {
-        hFile = hSound;
-        noteColor |= CHANNEL_COLOR_SOUND;
-    } break;
+        Record& record = m_aRing[m_dequeuePos & (RING_SIZE - 1)];
+        if (SDL_AtomicGet(&record.sequence) != PositionAdd(m_dequeuePos, 1))
+        {
+            break;
+        }
+
+        WriteRecord(record);
+
+        // Slot is free for producer of the next lap
+        SDL_AtomicSet(&record.sequence, PositionAdd(m_dequeuePos, RING_SIZE));
+        m_dequeuePos = PositionAdd(m_dequeuePos, 1);
+        bWritten = true;
+    }
+
+    WriteDrops();
 
-    case CHANNEL_ANIMATION:
+    if (bWritten)
     {
-        hFile = hAnim;
-        noteColor |= CHANNEL_COLOR_ANIMATION;
-    } break;
+        FlushBatches();
+    }
+    SDL_AtomicSet(&m_writtenPos, m_dequeuePos);
+
+    return bWritten;
+}
 
-    case CHANNEL_SCRIPT:
+void DebugLogManager::WriteRecord(const Record& record)
+{
+    // Tell about muted notes first
+    if (record.repeated > 0)
     {
-        hFile = hScript;
-        noteColor |= CHANNEL_COLOR_SCRIPT;
-    } break;
+        WriteNote(record.channel, record.priority, record.name, "Repeated %d more times: %s", record.repeated, record.fmt);
+    }
+
+#ifdef GT2D_LOG_BINARY
+    WriteBinary(record);
+#endif
+
+    char text[TEXT_SIZE];
+    s32 length = ClampLength(std::snprintf(text, TEXT_SIZE - 1, "<%s> %s: ", record.name, GetLogPriorityName(record.priority)), TEXT_SIZE - 2);
+    length += FormatLogArgs(text + length, TEXT_SIZE - 1 - length, record.fmt, record.aArgs, record.argsSize);
+    text[length++] = '\n';
+    text[length] = '\0';
+
+    WriteText(record.channel, record.priority, text, length);
+}
+
+void DebugLogManager::WriteText(s32 channel, s32 priority, const char* text, s32 length)
+{
+    s32 index = FindChannel(channel);
+    s32 noteColor = (index != -1 ? LOG_CHANNELS[index].color : CHANNEL_COLOR_UNDEFINED) | GetPriorityColor(priority);
 
-    case CHANNEL_GAME:
+    AppendConsoleText(text, length);
+
+#ifndef GT2D_LOG_BINARY
+    Append(m_full, text, length);
+    if (index != -1)
     {
-        hFile = hGame;
-        noteColor |= CHANNEL_COLOR_GAME;
-    } break;
+        Append(m_aChannels[index], text, length);
+    }
+#endif
 
-    default:
+#ifdef _DEBUG
+    #ifdef _WIN32
+        SetConsoleTextAttribute((HANDLE)m_hConsole, (WORD)noteColor);
+        WriteConsoleA((HANDLE)m_hConsole, text, (DWORD)length, nullptr, nullptr);
+    #else
+        // Same colors through escape codes, windows console has blue and red swapped
+        s32 fg = noteColor & 0xF;
+        s32 bg = (noteColor >> 4) & 0xF;
+        s32 fgCode = ((fg & 8) ? 90 : 30) + (((fg & 1) << 2) | (fg & 2) | ((fg & 4) >> 2));
+        s32 bgCode = ((bg & 8) ? 100 : 40) + (((bg & 1) << 2) | (bg & 2) | ((bg & 4) >> 2));
+
+        char escape[32];
+        s32 escapeLength = bg ? std::snprintf(escape, sizeof(escape), "\x1B[%d;%dm", fgCode, bgCode) : std::snprintf(escape, sizeof(escape), "\x1B[%dm", fgCode);
+
+        Append(m_console, escape, escapeLength);
+        Append(m_console, text, length - 1);
+        Append(m_console, "\x1B[0m\n", 5);
+    #endif
+#else
+    (void)noteColor;
+#endif
+}
+
+void DebugLogManager::WriteNote(s32 channel, s32 priority, const char* name, const char* fmt, s32 count, const char* arg)
+{
+    Record record;
+    record.channel = channel;
+    record.priority = priority;
+    record.repeated = 0;
+    record.time = SDL_GetTicks() - m_startTicks;
+    record.name = name;
+    record.fmt = fmt;
+    record.argsSize = 0;
+
+    PackArg(record, count);
+    if (arg)
     {
-        hFile = nullptr;
-        noteColor |= CHANNEL_COLOR_UNDEFINED;
-    } break;
+        PackArg(record, arg);
     }
 
-    // Background color and priority prefix
-    switch (priority)
+    WriteRecord(record);
+}
+
+void DebugLogManager::WriteDrops()
+{
+    s32 dropped = SDL_AtomicGet(&m_droppedCount);
+    if (dropped == m_reportedDrops)
     {
-    case PR_ERROR:
+        return;
+    }
+
+    WriteNote(CHANNEL_LOGMGR, PR_WARNING, "DebugLogManager", "%d notes dropped, log is too busy", dropped - m_reportedDrops, nullptr);
+    m_reportedDrops = dropped;
+}
+
+void DebugLogManager::WriteMuted()
+{
+    for (i32f i = 0; i < RATE_SITES; ++i)
     {
-        priorityName = PRIORITY_PREFIX_ERROR;
-        noteColor |= PRIORITY_COLOR_ERROR;
-    } break;
+        const RateSite& rate = m_aRateSites[i];
+        if (rate.muted > 0)
+        {
+            WriteNote(CHANNEL_LOGMGR, PR_NOTE, rate.name, "Repeated %d more times: %s", rate.muted, rate.fmt);
+        }
+    }
+
+    FlushBatches();
+}
 
-    case PR_WARNING:
+#ifdef GT2D_LOG_BINARY
+void DebugLogManager::WriteBinary(const Record& record)
+{
+    LogEntry entry;
+    entry.time = record.time;
+    entry.format = InternFormat(record.name, record.fmt);
+    entry.channel = (u16)record.channel;
+    entry.kind = LOG_ENTRY_NOTE;
+    entry.priority = (u8)record.priority;
+    entry.size = (u16)record.argsSize;
+
+    Append(m_full, (const char*)&entry, sizeof(entry));
+    Append(m_full, (const char*)record.aArgs, record.argsSize);
+}
+
+u16 DebugLogManager::InternFormat(const char* name, const char* fmt)
+{
+    // Strings are literals, so pointers are enough
+    u32 hash = (u32)(((uintptr_t)fmt >> 3) ^ ((uintptr_t)name >> 5)) * 2654435761u;
+    s32 index = (s32)(hash >> 20) & (FORMAT_SLOTS - 1);
+
+    for ( ;; )
     {
-        priorityName = PRIORITY_PREFIX_WARNING;
-        noteColor |= PRIORITY_COLOR_WARNING;
-    } break;
+        FormatSlot& slot = m_aFormats[index];
+        if (slot.fmt == fmt && slot.name == name)
+        {
+            return slot.id;
+        }
+        if (!slot.fmt)
+        {
+            break;
+        }
+        index = (index + 1) & (FORMAT_SLOTS - 1);
+    }
 
-    case PR_NOTE:
+    // Define new id, or reuse the last one when table is full
+    u16 id = (u16)FORMAT_SLOTS;
+    if (m_formatCount < FORMAT_SLOTS * 3 / 4)
     {
-        priorityName = PRIORITY_PREFIX_NOTE;
-        noteColor |= PRIORITY_COLOR_NOTE;
-    } break;
+        id = (u16)m_formatCount++;
+        m_aFormats[index] = { name, fmt, id };
+    }
+
+    s32 nameLength = ClampLength((s32)std::strlen(name), 255);
+    s32 fmtLength = ClampLength((s32)std::strlen(fmt), UINT16_MAX - 256 - 2);
+
+    LogEntry entry;
+    entry.time = 0;
+    entry.format = id;
+    entry.channel = 0;
+    entry.kind = LOG_ENTRY_FORMAT;
+    entry.priority = 0;
+    entry.size = (u16)(nameLength + 1 + fmtLength + 1);
 
-    default:
+    Append(m_full, (const char*)&entry, sizeof(entry));
+    Append(m_full, name, nameLength);
+    Append(m_full, "", 1);
+    Append(m_full, fmt, fmtLength);
+    Append(m_full, "", 1);
+
+    return id;
+}
+#endif
+
+void DebugLogManager::OpenBatch(Batch& batch, const char* fileName, const char* mode)
+{
+    batch.hFile = std::fopen(fileName, mode);
+    batch.aBuffer = batch.hFile ? new char[BATCH_SIZE] : nullptr;
+    batch.size = 0;
+}
+
+void DebugLogManager::CloseBatch(Batch& batch)
+{
+    if (!batch.hFile)
     {
-        priorityName = PRIORITY_PREFIX_UNDEFINED;
-        noteColor |= PRIORITY_COLOR_UNDEFINED;
-    } break;
+        return;
     }
 
-    // Get note prefix
-    char notePrefix[NOTE_PREFIX_BUFSIZE];
-    std::snprintf(notePrefix, NOTE_PREFIX_BUFSIZE, "<%s> %s", name, priorityName);
+    FlushBatch(batch);
+    std::fclose(batch.hFile);
+    delete[] batch.aBuffer;
 
-    // Get note message
-    char noteMessage[NOTE_MESSAGE_BUFSIZE];
-    std::vsnprintf(noteMessage, NOTE_MESSAGE_BUFSIZE, fmt, vl);
+    batch.hFile = nullptr;
+    batch.aBuffer = nullptr;
+}
 
-    // Get final note
-    char noteFinal[NOTE_FINAL_BUFSIZE];
-    std::snprintf(noteFinal, NOTE_FINAL_BUFSIZE, "%s: %s\n", notePrefix, noteMessage);
-    size_t noteLength = std::strlen(noteFinal);
+void DebugLogManager::Append(Batch& batch, const char* text, s32 length)
+{
+    if (!batch.hFile)
+    {
+        return;
+    }
 
-    // Output
-    g_console.Print(noteFinal);
+    if (batch.size + length > BATCH_SIZE)
+    {
+        FlushBatch(batch);
+    }
 
-    SetConsoleTextAttribute(hConsole, noteColor);
-    WriteConsoleA(hConsole, noteFinal, (DWORD)noteLength, nullptr, nullptr);
+    std::memcpy(batch.aBuffer + batch.size, text, length);
+    batch.size += length;
+}
 
-    fwrite(noteFinal, 1, noteLength, hLogFull);
-    if (hFile)
+void DebugLogManager::FlushBatch(Batch& batch)
+{
+    if (!batch.hFile || batch.size == 0)
     {
-        fwrite(noteFinal, 1, noteLength, hFile);
+        return;
     }
 
-    // Flush stuff
-    std::fflush(hLogFull);
-    std::fflush(hFile);
+    std::fwrite(batch.aBuffer, 1, batch.size, batch.hFile);
+    std::fflush(batch.hFile);
+    batch.size = 0;
 }
 
-void DebugLogManager::AddNote(s32 channel, s32 priority, const char* name, const char* fmt, ...)
+void DebugLogManager::FlushBatches()
 {
-    std::va_list vl;
-    va_start(vl, fmt);
+    FlushBatch(m_full);
+    for (i32f i = 0; i < CHANNEL_COUNT; ++i)
+    {
+        FlushBatch(m_aChannels[i]);
+    }
+    FlushBatch(m_console);
+    FlushConsoleText();
+}
 
-    VAddNote(channel, priority, name, fmt, vl);
+void DebugLogManager::AppendConsoleText(const char* text, s32 length)
+{
+    if (length > CONSOLE_TEXT_SIZE - 1)
+    {
+        text += length - (CONSOLE_TEXT_SIZE - 1);
+        length = CONSOLE_TEXT_SIZE - 1;
+    }
+
+    if (m_consoleTextSize + length > CONSOLE_TEXT_SIZE - 1)
+    {
+        FlushConsoleText();
+    }
+
+    std::memcpy(m_aConsoleText + m_consoleTextSize, text, length);
+    m_consoleTextSize += length;
+}
+
+void DebugLogManager::FlushConsoleText()
+{
+    if (m_consoleTextSize == 0)
+    {
+        return;
+    }
 
-    va_end(vl);
+    // Console only copies it, main thread moves it into console buffer
+    m_aConsoleText[m_consoleTextSize] = '\0';
+    g_console.Print(m_aConsoleText);
+    m_consoleTextSize = 0;
 }
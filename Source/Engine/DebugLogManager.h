@@ -1,50 +1,292 @@
 #pragma once
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
+#include <type_traits>
+#include "SDL.h"
 #include "Engine/StdHeaders.h"
 #include "Engine/Types.h"
+#include "Engine/Platform.h"
+#include "Engine/LogFormat.h"
 
-/** Each channel represent engine's module */
-enum eDebugLogChannel
-{
-    CHANNEL_LOGMGR    = 1 << 0,
-    CHANNEL_GT2D      = 1 << 1,
-    CHANNEL_GRAPHICS  = 1 << 4,
-    CHANNEL_INPUT     = 1 << 5,
-    CHANNEL_SOUND     = 1 << 6,
-    CHANNEL_ANIMATION = 1 << 7,
-    CHANNEL_SCRIPT    = 1 << 8,
-    CHANNEL_GAME      = 1 << 9
-};
+/**
+ * Notes out of these masks are skipped with their arguments, see LogNote.
+ * Errors are always kept. Define them for build to override
+ */
+#ifndef GT2D_LOG_CHANNELS
+    #define GT2D_LOG_CHANNELS 0xFFFFFFFF
+#endif
+
+#ifndef GT2D_LOG_PRIORITIES
+    #ifdef _DEBUG
+        #define GT2D_LOG_PRIORITIES (PR_ERROR | PR_WARNING | PR_NOTE)
+    #else
+        #define GT2D_LOG_PRIORITIES (PR_ERROR | PR_WARNING)
+    #endif
+#endif
 
-enum eDebugLogPriority
+/**
+ * Define GT2D_LOG_BINARY to write one binary log instead of text files,
+ * Tools/LogDecoder turns it back into text
+ */
+constexpr b32 IsLogCompiled(s32 channel, s32 priority)
 {
-    PR_ERROR   = 1 << 0,
-    PR_WARNING = 1 << 1,
-    PR_NOTE    = 1 << 2
-};
+    return (priority & PR_ERROR) || ((channel & (s32)GT2D_LOG_CHANNELS) && (priority & (s32)GT2D_LOG_PRIORITIES));
+}
 
+/**
+ * Notes keep format and raw arguments in lock-free ring, writer thread
+ * formats them and puts into files in big batches. Format and name
+ * must be string literals, string arguments are copied. When ring is full
+ * notes are dropped and counted, errors wait until they're written.
+ * Call site which repeats the same note too often is muted for a while
+ * and writer tells how many times it repeated
+ */
 class DebugLogManager
 {
-    HANDLE hConsole;
-    std::FILE* hLogFull;
-
-    std::FILE* hLogMgr;
-    std::FILE* hGT2D;
-    std::FILE* hGraphics;
-    std::FILE* hInput;
-    std::FILE* hSound;
-    std::FILE* hAnim;
-    std::FILE* hScript;
-    std::FILE* hGame;
+    static constexpr i32f ARGS_SIZE = 1024;
+    static constexpr i32f RING_SIZE = 1024;
+    static constexpr i32f CHANNEL_COUNT = 8;
+    static constexpr i32f BATCH_SIZE = 64 * 1024;
+    static constexpr i32f CONSOLE_TEXT_SIZE = 4096;
+
+    /** Notes of one call site over this count in window are muted */
+    static constexpr i32f RATE_SITES = 256;
+    static constexpr i32f RATE_BURST = 4;
+    static constexpr u32 RATE_WINDOW = 1000;
+
+#ifdef GT2D_LOG_BINARY
+    /** Name and format pairs over 3/4 of it are defined again on every note */
+    static constexpr i32f FORMAT_SLOTS = 4096;
+#endif
+
+    /** Slot of ring, sequence tells whose turn it is */
+    struct Record
+    {
+        SDL_atomic_t sequence;
+        s32 channel;
+        s32 priority;
+        s32 repeated;
+        u32 time;
+        const char* name;
+        const char* fmt;
+        s32 argsSize;
+        u8 aArgs[ARGS_SIZE];
+    };
+
+    /** Notes of one call site with the same arguments */
+    struct RateSite
+    {
+        SDL_SpinLock lock;
+        u32 key;
+        const char* name;
+        const char* fmt;
+        u32 windowStart;
+        s32 count;
+        s32 muted;
+    };
+
+    /** File with our own buffer, written when buffer is full or ring is drained */
+    struct Batch
+    {
+        std::FILE* hFile;
+        char* aBuffer;
+        s32 size;
+    };
+
+    Record* m_aRing;
+    SDL_atomic_t m_enqueuePos;
+    SDL_atomic_t m_writtenPos;
+    SDL_atomic_t m_droppedCount;
+
+    RateSite m_aRateSites[RATE_SITES];
+
+    /** Writer thread only */
+    s32 m_dequeuePos;
+    s32 m_reportedDrops;
+
+    SDL_Thread* m_pWriterThread;
+    SDL_sem* m_pWake;
+    SDL_atomic_t m_bQuit;
+
+    /** Notes are written on calling thread without writer */
+    SDL_SpinLock m_syncLock;
+    Record m_syncRecord;
+
+    Batch m_full;
+    Batch m_aChannels[CHANNEL_COUNT];
+    Batch m_console;
+
+    /** Text for game console, handed over once per written pass */
+    char m_aConsoleText[CONSOLE_TEXT_SIZE];
+    s32 m_consoleTextSize;
+
+#ifdef _WIN32
+    void* m_hConsole;
+#endif
+
+    u32 m_startTicks;
+
+#ifdef GT2D_LOG_BINARY
+    struct FormatSlot
+    {
+        const char* name;
+        const char* fmt;
+        u16 id;
+    };
+
+    /** Writer thread only, open addressing by format pointer */
+    FormatSlot* m_aFormats;
+    s32 m_formatCount;
+#endif
 
 public:
     void StartUp();
     void ShutDown();
 
-    void AddNote(s32 channel, s32 priority, const char* name, const char* fmt, ...);
-    void VAddNote(s32 channel, s32 priority, const char* name, const char* fmt, std::va_list vl);
+    /** Doesn't check log masks, call it through LogNote */
+    template<typename... Args>
+    forceinline void Note(s32 channel, s32 priority, const char* name, const char* fmt, Args... args)
+    {
+        u32 site = (u32)(uintptr_t)fmt;
+        (MixSite(site, args), ...);
+
+        Record* pRecord = BeginRecord(channel, priority, name, fmt, site);
+        if (pRecord)
+        {
+            (PackArg(*pRecord, args), ...);
+            EndRecord(*pRecord);
+        }
+    }
+
+    /** Waits until every note added before is written */
+    void Flush();
+
+    forceinline s32 GetDroppedCount() { return SDL_AtomicGet(&m_droppedCount); }
+
+private:
+    static s32 SDLCALL WriterMain(void* pData);
+
+    /** Null if note is muted or dropped */
+    Record* BeginRecord(s32 channel, s32 priority, const char* name, const char* fmt, u32 site);
+    void EndRecord(Record& record);
+
+    /** -1 if note is muted, otherwise count of notes muted before it */
+    s32 CheckRate(const char* name, const char* fmt, u32 site);
+
+    /** Every argument goes into site, so only exactly repeated notes are muted */
+    template<typename T>
+    forceinline static void MixSite(u32& site, T value)
+    {
+        if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+        {
+            for (const char* p = value; p && *p; ++p)
+            {
+                site = (site ^ (u8)*p) * 16777619u;
+            }
+        }
+        else
+        {
+            u8 aBytes[sizeof(T)];
+            std::memcpy(aBytes, &value, sizeof(T));
+            for (i32f i = 0; i < (i32f)sizeof(T); ++i)
+            {
+                site = (site ^ aBytes[i]) * 16777619u;
+            }
+        }
+    }
+
+    template<typename T>
+    forceinline static void PackArg(Record& record, T value)
+    {
+        if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+        {
+            PackString(record, value);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            f64 number = (f64)value;
+            f32 single = (f32)number;
+            if ((f64)single == number)
+            {
+                PackValue(record, LOG_ARG_DOUBLE, &single, sizeof(single));
+            }
+            else
+            {
+                PackValue(record, LOG_ARG_DOUBLE, &number, sizeof(number));
+            }
+        }
+        else if constexpr (std::is_pointer_v<T>)
+        {
+            u64 number = (u64)(uintptr_t)value;
+            PackValue(record, LOG_ARG_POINTER, &number, GetUnsignedSize(number));
+        }
+        else if constexpr (std::is_enum_v<T> || std::is_signed_v<T>)
+        {
+            s64 number = (s64)value;
+            PackValue(record, LOG_ARG_INT, &number, number == (s8)number ? 1 : (number == (s16)number ? 2 : (number == (s32)number ? 4 : 8)));
+        }
+        else
+        {
+            u64 number = (u64)value;
+            PackValue(record, LOG_ARG_UINT, &number, GetUnsignedSize(number));
+        }
+    }
+
+    forceinline static s32 GetUnsignedSize(u64 number)
+    {
+        return number <= UINT8_MAX ? 1 : (number <= UINT16_MAX ? 2 : (number <= UINT32_MAX ? 4 : 8));
+    }
+
+    /** Low bytes of value, so integers should be little-endian */
+    forceinline static void PackValue(Record& record, s32 type, const void* pValue, s32 size)
+    {
+        if (record.argsSize + 1 + size > ARGS_SIZE)
+        {
+            return;
+        }
+
+        record.aArgs[record.argsSize] = (u8)(type | (size << 4));
+        std::memcpy(&record.aArgs[record.argsSize + 1], pValue, size);
+        record.argsSize += 1 + size;
+    }
+
+    static void PackString(Record& record, const char* value);
+
+    /** Writes everything published in order, false if there was nothing */
+    b32 WriteRecords();
+    void WriteRecord(const Record& record);
+    void WriteText(s32 channel, s32 priority, const char* text, s32 length);
+    
+    /** Note of log itself with count and optional string */
+    void WriteNote(s32 channel, s32 priority, const char* name, const char* fmt, s32 count, const char* arg);
+
+#ifdef GT2D_LOG_BINARY
+    void WriteBinary(const Record& record);
+    u16 InternFormat(const char* name, const char* fmt);
+#endif
+    void WriteDrops();
+    void WriteMuted();
+
+    void OpenBatch(Batch& batch, const char* fileName, const char* mode);
+    void CloseBatch(Batch& batch);
+    void Append(Batch& batch, const char* text, s32 length);
+    void FlushBatch(Batch& batch);
+    void FlushBatches();
+
+    void AppendConsoleText(const char* text, s32 length);
+    void FlushConsoleText();
 };
 
 inline DebugLogManager g_debugLogMgr;
+
+/**
+ * Arguments are inside of the check, so they aren't evaluated for skipped note,
+ * and note of constant priority out of GT2D_LOG_PRIORITIES compiles away entirely
+ */
+#define LogNote(CHANNEL, PRIORITY, NAME, ...) \
+    do \
+    { \
+        if (IsLogCompiled((CHANNEL), (PRIORITY))) \
+        { \
+            g_debugLogMgr.Note((CHANNEL), (PRIORITY), (NAME), __VA_ARGS__); \
+        } \
+    } while (0)
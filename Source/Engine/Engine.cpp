@@ -4,6 +4,7 @@
 #include "SDL_ttf.h"
 #include "Math/Math.h"
 #include "Graphics/GraphicsModule.h"
+#include "Graphics/Tilemap.h"
 #include "Input/InputModule.h"
 #include "Sound/SoundModule.h"
 #include "Animation/AnimationModule.h"
@@ -13,12 +14,15 @@
 #include "Engine/Console.h"
 #include "Engine/ClockManager.h"
 #include "Engine/CollisionManager.h"
+#include "Engine/JobSystem.h"
+#include "Engine/MemoryTracker.h"
 #include "Engine/Assert.h"
 #include "Engine/Engine.h"
 
 static constexpr i32f DEFAULT_FPS = 60;
 static constexpr i32f DEFAULT_SCREEN_WIDTH = 1280;
 static constexpr i32f DEFAULT_SCREEN_HEIGHT = 720;
+static constexpr i32f BENCH_WARMUP_FRAMES = 60;
 
 static constexpr char WINDOW_TITLE[] =
 #ifdef _DEBUG
@@ -27,10 +31,14 @@ static constexpr char WINDOW_TITLE[] =
     "Petrol: The Fastest";
 #endif
 
-void Engine::StartUp()
+void Engine::StartUp(const char* scriptPath, s32 location)
 {
+    // SDL allocates through tracker from the very first call
+    MemoryTracker::HookSDL();
+
     // Start up log manager
     g_debugLogMgr.StartUp();
+    g_memoryTracker.StartUp();
 
     { // Init all SDL stuff
         s32 res = SDL_Init(SDL_INIT_EVERYTHING);
@@ -56,14 +64,6 @@ void Engine::StartUp()
             AssertNoEntry();
         }
 
-        // Create renderer
-        if ( nullptr == (m_pRenderer = SDL_CreateRenderer(m_pWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)))
-        {
-            AddNote(PR_ERROR, "Error on creating renderer: %s", SDL_GetError());
-            AssertNoEntry();
-        }
-        SDL_SetRenderDrawBlendMode(m_pRenderer, SDL_BLENDMODE_BLEND);
-
         // Init SDL Image
         if (~IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)
         {
@@ -90,13 +90,30 @@ void Engine::StartUp()
         SDL_GetWindowSize(m_pWindow, &width, &height);
 
         g_math.StartUp();
-        g_graphicsModule.StartUp(m_pWindow, m_pRenderer, width, height);
+        g_jobSystem.StartUp();
+        {
+            MemoryScope scope(MEMORY_GRAPHICS);
+            g_graphicsModule.StartUp(m_pWindow, width, height);
+            g_tilemap.StartUp();
+        }
         g_inputModule.StartUp();
-        g_soundModule.StartUp();
-        g_animModule.StartUp();
-        g_scriptModule.StartUp();
-        g_game.StartUp();
-        g_collisionMgr.StartUp();
+        {
+            MemoryScope scope(MEMORY_SOUND);
+            g_soundModule.StartUp();
+        }
+        {
+            MemoryScope scope(MEMORY_GRAPHICS);
+            g_animModule.StartUp();
+        }
+        {
+            MemoryScope scope(MEMORY_SCRIPT);
+            g_scriptModule.StartUp();
+        }
+        {
+            MemoryScope scope(MEMORY_WORLD);
+            g_game.StartUp(scriptPath, location);
+            g_collisionMgr.StartUp();
+        }
         g_clockMgr.StartUp(DEFAULT_FPS);
     }
 
@@ -115,14 +132,16 @@ void Engine::ShutDown()
         g_animModule.ShutDown();
         g_soundModule.ShutDown();
         g_inputModule.ShutDown();
+        g_tilemap.ShutDown();
         g_graphicsModule.ShutDown();
+        g_jobSystem.ShutDown();
         g_math.ShutDown();
     }
 
     AddNote(PR_NOTE, "Engine modules shut down");
+    g_memoryTracker.ShutDown();
 
     { // Shut down SDL
-        SDL_DestroyRenderer(m_pRenderer);
         SDL_DestroyWindow(m_pWindow);
 
         TTF_Quit();
@@ -145,12 +164,122 @@ s32 Engine::Run()
         {
             break;
         }
+        g_console.Update();
 
-        g_game.Update(g_clockMgr.ComputeDelta());
-        g_game.Render();
+        {
+            MemoryScope scope(MEMORY_WORLD);
+            g_game.Update(g_clockMgr.ComputeDelta());
+        }
+        g_soundModule.Update();
+        {
+            MemoryScope scope(MEMORY_GRAPHICS);
+            g_game.Render();
+        }
+
+        g_memoryTracker.EndFrame();
     }
 
     ShutDown();
 
     return 0;
 }
+
+s32 Engine::RunScriptBench(const char* scriptPath, s32 location, s32 frames)
+{
+    static constexpr const char* API_NAMES[] = { "bindings", "FFI" };
+
+    // Frame time in ms, as ClockManager gives
+    f32 dtTime = 1000.0f / DEFAULT_FPS;
+    f64 aScriptTime[2] = { 0.0, 0.0 };
+    s32 status = 0;
+
+    for (i32f api = 0; api < 2; ++api)
+    {
+        // Every path starts from the same mission state
+        if (api > 0)
+        {
+            g_game.ChangeState(new PlayState(scriptPath, location));
+        }
+
+        // First update enters mission
+        {
+            MemoryScope scope(MEMORY_WORLD);
+            g_game.Update(dtTime);
+        }
+
+        lua_State* pScript = g_game.GetScript();
+        if (!g_game.Running() || !pScript)
+        {
+            AddNote(PR_ERROR, "Script bench: can't enter mission %s", scriptPath);
+            status = 1;
+            break;
+        }
+
+        // FFI is there only when engine is built against LuaJIT
+        if (!g_scriptModule.SelectApi(pScript, api > 0))
+        {
+            AddNote(api > 0 ? PR_NOTE : PR_ERROR, "Script bench: can't route mission through %s", API_NAMES[api]);
+            status = api > 0 ? status : 1;
+            break;
+        }
+
+        // Warm up JIT, then time the same update as Run() does
+        f64 frameTime = 0.0;
+        f64 worldTime = 0.0;
+        f64 maxFrameTime = 0.0;
+        s32 count = 0;
+
+        for (i32f i = 0; i < BENCH_WARMUP_FRAMES + frames; ++i)
+        {
+            if (!g_inputModule.HandleEvents())
+            {
+                break;
+            }
+            g_console.Update();
+
+            u64 start = SDL_GetPerformanceCounter();
+            {
+                MemoryScope scope(MEMORY_WORLD);
+                g_game.Update(dtTime);
+            }
+            f64 time = (f64)(SDL_GetPerformanceCounter() - start) * 1000.0 / (f64)SDL_GetPerformanceFrequency();
+
+            // Mission may stop or switch by itself
+            if (!g_game.Running() || g_game.GetScript() != pScript)
+            {
+                AddNote(PR_WARNING, "Script bench: mission left after %d frames", (s32)i);
+                break;
+            }
+
+            if (i >= BENCH_WARMUP_FRAMES)
+            {
+                frameTime += time;
+                worldTime += g_game.GetWorld().GetUpdateTime();
+                maxFrameTime = time > maxFrameTime ? time : maxFrameTime;
+                ++count;
+            }
+
+            g_soundModule.Update();
+            g_memoryTracker.EndFrame();
+        }
+
+        if (count == 0)
+        {
+            status = 1;
+            break;
+        }
+
+        aScriptTime[api] = (frameTime - worldTime) / count;
+        AddNote(PR_NOTE, "Script bench, %s: %d frames, %.3f ms per frame, %.3f ms script, %.3f ms world, %.3f ms worst",
+                API_NAMES[api], count, frameTime / count, aScriptTime[api], worldTime / count, maxFrameTime);
+    }
+
+    if (aScriptTime[0] > 0.0 && aScriptTime[1] > 0.0)
+    {
+        AddNote(PR_NOTE, "Script bench: FFI vs bindings %.2fx script time", aScriptTime[0] / aScriptTime[1]);
+    }
+
+    ShutDown();
+
+    return status;
+}
@@ -6,16 +6,22 @@
 class Engine final : public EngineModule
 {
     SDL_Window* m_pWindow;
-    SDL_Renderer* m_pRenderer;
 
 public:
     Engine() : EngineModule("GT2D", CHANNEL_GT2D) {}
 
-    void StartUp();
+    /** Main menu is entered if there's no mission path */
+    void StartUp(const char* scriptPath = nullptr, s32 location = 0);
     void ShutDown();
 
     /** Returns exit status */
     s32 Run();
+
+    /**
+     * Runs frames of mission started by StartUp() through regular bindings,
+     * then restarts it and runs them through LuaJIT FFI. Returns exit status
+     */
+    s32 RunScriptBench(const char* scriptPath, s32 location, s32 frames);
 };
 
 inline Engine g_engine;
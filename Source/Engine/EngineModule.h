@@ -9,9 +9,6 @@ class EngineModule
     const char* m_moduleName;
     s32 m_moduleChannel;
 
-protected:
-    void AddNote(s32 priority, const char* fmt, ...) const;
-
 public:
     EngineModule(const char* name, s32 channel) : m_moduleName(name), m_moduleChannel(channel) {}
     virtual ~EngineModule() = default;
@@ -19,3 +16,6 @@ public:
     forceinline const char* GetModuleName() const { return m_moduleName; }
     forceinline s32 GetModuleChannel() const { return m_moduleChannel; }
 };
+
+/** Note of module's channel and name, only for members of modules, see LogNote */
+#define AddNote(PRIORITY, ...) LogNote(GetModuleChannel(), (PRIORITY), GetModuleName(), __VA_ARGS__)
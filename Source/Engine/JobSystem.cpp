@@ -0,0 +1,246 @@
+#include "Math/Math.h"
+#include "Engine/JobSystem.h"
+#include "Engine/MemoryTracker.h"
+
+static thread_local s32 t_currentWorker = 0;
+static thread_local s32 t_jobDepth = 0;
+
+internal void CallJob(JobFunction pFunction, void* pUserdata, s32 first, s32 last)
+{
+    ++t_jobDepth;
+    pFunction(pUserdata, first, last);
+    --t_jobDepth;
+}
+
+void JobSystem::StartUp()
+{
+    // Main thread is a worker too
+    s32 workerCount = Math::Min(Math::Max(SDL_GetCPUCount(), 1), (s32)MAX_WORKERS);
+
+    m_aWorkers = new Worker[workerCount];
+    for (i32f i = 0; i < workerCount; ++i)
+    {
+        m_aWorkers[i].pSystem = this;
+        m_aWorkers[i].index = (s32)i;
+        m_aWorkers[i].pThread = nullptr;
+        m_aWorkers[i].head = 0;
+        m_aWorkers[i].tail = 0;
+        m_aWorkers[i].lock = 0;
+    }
+
+    m_pWakeUp = SDL_CreateSemaphore(0);
+    m_pStart = SDL_CreateSemaphore(0);
+    SDL_AtomicSet(&m_bQuit, 0);
+
+    // Run threads, they wait until count of them is known
+    s32 startedCount = 1;
+    for (i32f i = 1; i < workerCount; ++i)
+    {
+        m_aWorkers[i].pThread = SDL_CreateThread(WorkerMain, "GT2D Worker", &m_aWorkers[i]);
+        if (!m_aWorkers[i].pThread)
+        {
+            AddNote(PR_WARNING, "Can't create worker thread: %s", SDL_GetError());
+            break;
+        }
+        ++startedCount;
+    }
+
+    m_workerCount = startedCount;
+    for (i32f i = 1; i < m_workerCount; ++i)
+    {
+        SDL_SemPost(m_pStart);
+    }
+
+    AddNote(PR_NOTE, "Module started with %d workers", m_workerCount);
+}
+
+void JobSystem::ShutDown()
+{
+    // Wake up everyone and wait until they leave
+    SDL_AtomicSet(&m_bQuit, 1);
+    for (i32f i = 1; i < m_workerCount; ++i)
+    {
+        SDL_SemPost(m_pWakeUp);
+    }
+    for (i32f i = 1; i < m_workerCount; ++i)
+    {
+        SDL_WaitThread(m_aWorkers[i].pThread, nullptr);
+    }
+
+    SDL_DestroySemaphore(m_pWakeUp);
+    SDL_DestroySemaphore(m_pStart);
+    delete[] m_aWorkers;
+    m_workerCount = 0;
+
+    AddNote(PR_NOTE, "Module shut down");
+}
+
+void JobSystem::ParallelFor(s32 count, s32 grain, JobFunction pFunction, void* pUserdata)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    if (grain < 1)
+    {
+        grain = 1;
+    }
+
+    // Not worth to split
+    if (m_workerCount <= 1 || count <= grain)
+    {
+        CallJob(pFunction, pUserdata, 0, count);
+        return;
+    }
+
+    // Spread jobs over workers' queues
+    SDL_atomic_t pending;
+    SDL_AtomicSet(&pending, 0);
+
+    s32 jobCount = 0;
+    for (s32 first = 0; first < count; first += grain)
+    {
+        Job job = { pFunction, pUserdata, first, Math::Min(first + grain, count), &pending };
+        SDL_AtomicAdd(&pending, 1);
+
+        if (!Push(m_aWorkers[jobCount % m_workerCount], job))
+        {
+            // Queue is full, do it right here
+            CallJob(pFunction, pUserdata, job.first, job.last);
+            SDL_AtomicAdd(&pending, -1);
+        }
+        ++jobCount;
+    }
+
+    // Wake up workers
+    s32 wakeCount = Math::Min(jobCount, m_workerCount - 1);
+    for (i32f i = 0; i < wakeCount; ++i)
+    {
+        SDL_SemPost(m_pWakeUp);
+    }
+
+    // Help them while waiting
+    while (SDL_AtomicGet(&pending) > 0)
+    {
+        if (!RunJob(0))
+        {
+            _mm_pause();
+        }
+    }
+}
+
+s32 SDLCALL JobSystem::WorkerMain(void* pData)
+{
+    Worker* pWorker = (Worker*)pData;
+    JobSystem* pSystem = pWorker->pSystem;
+    t_currentWorker = pWorker->index;
+
+    // Jobs run entity passes
+    MemoryScope scope(MEMORY_WORLD);
+
+    // Steal loop reads count of workers
+    SDL_SemWait(pSystem->m_pStart);
+
+    while (!SDL_AtomicGet(&pSystem->m_bQuit))
+    {
+        if (!pSystem->RunJob(pWorker->index))
+        {
+            SDL_SemWait(pSystem->m_pWakeUp);
+        }
+    }
+
+    return 0;
+}
+
+s32 JobSystem::GetCurrentWorker()
+{
+    return t_currentWorker;
+}
+
+b32 JobSystem::IsInJob()
+{
+    return t_jobDepth > 0;
+}
+
+b32 JobSystem::Push(Worker& worker, const Job& job)
+{
+    b32 bPushed = false;
+
+    SDL_AtomicLock(&worker.lock);
+    if (worker.tail - worker.head < QUEUE_SIZE)
+    {
+        worker.aJobs[worker.tail % QUEUE_SIZE] = job;
+        ++worker.tail;
+        bPushed = true;
+    }
+    SDL_AtomicUnlock(&worker.lock);
+
+    return bPushed;
+}
+
+b32 JobSystem::Pop(Worker& worker, Job& job)
+{
+    b32 bPopped = false;
+
+    // Owner takes newest job, it's still hot in cache
+    SDL_AtomicLock(&worker.lock);
+    if (worker.tail > worker.head)
+    {
+        --worker.tail;
+        job = worker.aJobs[worker.tail % QUEUE_SIZE];
+        bPopped = true;
+    }
+    if (worker.tail == worker.head)
+    {
+        worker.head = worker.tail = 0;
+    }
+    SDL_AtomicUnlock(&worker.lock);
+
+    return bPopped;
+}
+
+b32 JobSystem::Steal(Worker& worker, Job& job)
+{
+    b32 bStolen = false;
+
+    // Thief takes oldest job
+    SDL_AtomicLock(&worker.lock);
+    if (worker.tail > worker.head)
+    {
+        job = worker.aJobs[worker.head % QUEUE_SIZE];
+        ++worker.head;
+        bStolen = true;
+    }
+    if (worker.tail == worker.head)
+    {
+        worker.head = worker.tail = 0;
+    }
+    SDL_AtomicUnlock(&worker.lock);
+
+    return bStolen;
+}
+
+b32 JobSystem::RunJob(s32 index)
+{
+    Job job;
+
+    if (!Pop(m_aWorkers[index], job))
+    {
+        // Try to steal starting from the next worker
+        b32 bStolen = false;
+        for (i32f i = 1; i < m_workerCount && !bStolen; ++i)
+        {
+            bStolen = Steal(m_aWorkers[(index + i) % m_workerCount], job);
+        }
+
+        if (!bStolen)
+        {
+            return false;
+        }
+    }
+
+    CallJob(job.pFunction, job.pUserdata, job.first, job.last);
+    SDL_AtomicAdd(job.pPending, -1);
+
+    return true;
+}
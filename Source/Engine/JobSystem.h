@@ -0,0 +1,80 @@
+#pragma once
+
+#include "SDL.h"
+#include "Engine/EngineModule.h"
+
+/** Runs over [first, last) range */
+using JobFunction = void (*)(void* pUserdata, s32 first, s32 last);
+
+struct Job
+{
+    JobFunction pFunction;
+    void* pUserdata;
+    s32 first;
+    s32 last;
+    SDL_atomic_t* pPending;
+};
+
+/**
+ * Work-stealing job system. Every worker owns a queue, takes
+ * its newest jobs first and steals the oldest ones from others.
+ * Main thread is worker 0 and helps while it waits. Jobs must not
+ * call Lua, touch the world lists or spawn other jobs
+ */
+class JobSystem final : public EngineModule
+{
+private:
+    static constexpr i32f MAX_WORKERS = 32;
+    static constexpr i32f QUEUE_SIZE = 1024;
+
+    struct Worker
+    {
+        JobSystem* pSystem;
+        s32 index;
+        SDL_Thread* pThread;
+
+        Job aJobs[QUEUE_SIZE];
+        s32 head;
+        s32 tail;
+        SDL_SpinLock lock;
+    };
+
+private:
+    Worker* m_aWorkers;
+    s32 m_workerCount;
+
+    SDL_sem* m_pWakeUp;
+
+    /** Posted once for every worker thread after m_workerCount is set */
+    SDL_sem* m_pStart;
+    SDL_atomic_t m_bQuit;
+
+public:
+    JobSystem() : EngineModule("JobSystem", CHANNEL_GT2D) {}
+
+    void StartUp();
+    void ShutDown();
+
+    /** Splits [0, count) into grain sized jobs and returns when all of them are done */
+    void ParallelFor(s32 count, s32 grain, JobFunction pFunction, void* pUserdata);
+
+    forceinline s32 GetWorkerCount() const { return m_workerCount; }
+
+    /** Index of worker running on this thread, 0 for main thread */
+    static s32 GetCurrentWorker();
+
+    /** True while this thread runs a job, main thread too when it helps */
+    static b32 IsInJob();
+
+private:
+    static s32 SDLCALL WorkerMain(void* pData);
+
+    b32 Push(Worker& worker, const Job& job);
+    b32 Pop(Worker& worker, Job& job);
+    b32 Steal(Worker& worker, Job& job);
+
+    /** Runs one own or stolen job, false if there was nothing to do */
+    b32 RunJob(s32 index);
+};
+
+inline JobSystem g_jobSystem;
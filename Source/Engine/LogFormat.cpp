@@ -0,0 +1,298 @@
+#include "Engine/StdHeaders.h"
+#include "Engine/LogFormat.h"
+
+static constexpr char PRIORITY_PREFIX_UNDEFINED[] = "Undefined";
+static constexpr char PRIORITY_PREFIX_ERROR[]     = "Error";
+static constexpr char PRIORITY_PREFIX_WARNING[]   = "Warning";
+static constexpr char PRIORITY_PREFIX_NOTE[]      = "Note";
+
+internal s32 ClampLength(s32 length, s32 maxLength)
+{
+    return length < 0 ? 0 : (length > maxLength ? maxLength : length);
+}
+
+const char* GetLogChannelName(s32 channel)
+{
+    switch (channel)
+    {
+    case CHANNEL_LOGMGR:    return "DebugLogManager";
+    case CHANNEL_GT2D:      return "GT2D";
+    case CHANNEL_GRAPHICS:  return "GraphicsModule";
+    case CHANNEL_INPUT:     return "InputModule";
+    case CHANNEL_SOUND:     return "SoundModule";
+    case CHANNEL_ANIMATION: return "AnimationModule";
+    case CHANNEL_SCRIPT:    return "ScriptModule";
+    case CHANNEL_GAME:      return "Game";
+    default:                return "Undefined";
+    }
+}
+
+const char* GetLogPriorityName(s32 priority)
+{
+    switch (priority)
+    {
+    case PR_ERROR:   return PRIORITY_PREFIX_ERROR;
+    case PR_WARNING: return PRIORITY_PREFIX_WARNING;
+    case PR_NOTE:    return PRIORITY_PREFIX_NOTE;
+    default:         return PRIORITY_PREFIX_UNDEFINED;
+    }
+}
+
+/** Reads packed arguments one by one, integers are widened and doubles are always f64 */
+struct LogArgReader
+{
+    const u8* pArgs;
+    s32 size;
+    s32 offset;
+
+    b32 Next(s32& type, u64& value, const char*& string)
+    {
+        if (offset >= size)
+        {
+            return false;
+        }
+
+        type = pArgs[offset] & 0xF;
+        s32 valueSize = pArgs[offset] >> 4;
+        ++offset;
+
+        if (type == LOG_ARG_STRING)
+        {
+            u16 length;
+            if (offset + (s32)sizeof(length) > size)
+            {
+                return false;
+            }
+
+            std::memcpy(&length, pArgs + offset, sizeof(length));
+            string = (const char*)(pArgs + offset + sizeof(length));
+            offset += (s32)sizeof(length) + length + 1;
+            return offset <= size;
+        }
+
+        if (valueSize > 8 || offset + valueSize > size)
+        {
+            return false;
+        }
+
+        value = 0;
+        std::memcpy(&value, pArgs + offset, valueSize);
+        offset += valueSize;
+
+        if (type == LOG_ARG_INT && valueSize < 8 && (value >> (valueSize * 8 - 1)) & 1)
+        {
+            value |= ~0ull << (valueSize * 8);
+        }
+        else if (type == LOG_ARG_DOUBLE && valueSize == sizeof(f32))
+        {
+            f32 single;
+            std::memcpy(&single, &value, sizeof(single));
+            f64 number = single;
+            std::memcpy(&value, &number, sizeof(number));
+        }
+        return true;
+    }
+};
+
+internal s64 ArgToInt(s32 type, u64 value)
+{
+    if (type == LOG_ARG_DOUBLE)
+    {
+        f64 number;
+        std::memcpy(&number, &value, sizeof(number));
+        return (s64)number;
+    }
+    return (s64)value;
+}
+
+/** Integer as printf reads it by length of conversion, so -1 of s32 is ffffffff for %x */
+internal u64 ArgToBits(s32 type, u64 value, s32 bits)
+{
+    u64 number = (u64)ArgToInt(type, value);
+    return bits < 64 ? number & ((1ull << bits) - 1) : number;
+}
+
+internal s64 ArgToSigned(s32 type, u64 value, s32 bits)
+{
+    u64 number = ArgToBits(type, value, bits);
+    if (bits < 64 && (number >> (bits - 1)) & 1)
+    {
+        number |= ~0ull << bits;
+    }
+    return (s64)number;
+}
+
+internal f64 ArgToDouble(s32 type, u64 value)
+{
+    switch (type)
+    {
+    case LOG_ARG_INT:    return (f64)(s64)value;
+    case LOG_ARG_DOUBLE: { f64 number; std::memcpy(&number, &value, sizeof(number)); return number; }
+    default:             return (f64)value;
+    }
+}
+
+s32 FormatLogArgs(char* text, s32 maxLength, const char* fmt, const u8* pArgs, s32 argsSize)
+{
+    LogArgReader reader = { pArgs, argsSize, 0 };
+    s32 length = 0;
+
+    for (const char* p = fmt; *p && length < maxLength - 1; )
+    {
+        // Plain text
+        if (*p != '%')
+        {
+            text[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            text[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Parse spec without length, stars are replaced by arguments
+        char spec[64];
+        s32 specLength = 0;
+        spec[specLength++] = *p++;
+
+        s32 type = 0;
+        u64 value = 0;
+        const char* string = nullptr;
+
+        while (*p && std::strchr("-+ #0", *p) && specLength < 16)
+        {
+            spec[specLength++] = *p++;
+        }
+        for (s32 part = 0; part < 2; ++part)
+        {
+            if (part == 1)
+            {
+                if (*p != '.')
+                {
+                    break;
+                }
+                spec[specLength++] = *p++;
+            }
+
+            if (*p == '*')
+            {
+                ++p;
+                s32 number = reader.Next(type, value, string) && type != LOG_ARG_STRING ? (s32)ArgToInt(type, value) : 0;
+                specLength += ClampLength(std::snprintf(spec + specLength, 16, "%d", number), 15);
+            }
+            else
+            {
+                while (*p >= '0' && *p <= '9' && specLength < 40)
+                {
+                    spec[specLength++] = *p++;
+                }
+            }
+        }
+
+        // Length decides width of integer, int by default
+        s32 bits = 32;
+        while (*p && std::strchr("hlLqjzt", *p))
+        {
+            switch (*p)
+            {
+            case 'h': bits = p[1] == 'h' ? 8 : 16; p += p[1] == 'h'; break;
+            case 'l': bits = p[1] == 'l' ? 64 : (s32)sizeof(long) * 8; p += p[1] == 'l'; break;
+            case 'q':
+            case 'j': bits = 64; break;
+            case 'z':
+            case 't': bits = (s32)sizeof(size_t) * 8; break;
+            default: {} break;
+            }
+            ++p;
+        }
+
+        char conversion = *p;
+        if (!conversion)
+        {
+            break;
+        }
+        ++p;
+
+        if (conversion == 'n')
+        {
+            continue;
+        }
+
+        char* out = text + length;
+        s32 room = maxLength - length;
+        s32 written = 0;
+
+        if (!reader.Next(type, value, string))
+        {
+            written = std::snprintf(out, room, "<?>");
+        }
+        else if (conversion == 's' || type == LOG_ARG_STRING)
+        {
+            // Strings go only to %s and only strings go there
+            spec[specLength++] = 's';
+            spec[specLength] = '\0';
+            if (type == LOG_ARG_STRING)
+            {
+                written = std::snprintf(out, room, spec, string);
+            }
+            else
+            {
+                char number[32];
+                if (type == LOG_ARG_DOUBLE)
+                {
+                    std::snprintf(number, sizeof(number), "%g", ArgToDouble(type, value));
+                }
+                else if (type == LOG_ARG_INT)
+                {
+                    std::snprintf(number, sizeof(number), "%lld", (long long)(s64)value);
+                }
+                else
+                {
+                    std::snprintf(number, sizeof(number), "%llu", (unsigned long long)value);
+                }
+                written = std::snprintf(out, room, spec, number);
+            }
+        }
+        else if (std::strchr("fFeEgGaA", conversion))
+        {
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            written = std::snprintf(out, room, spec, ArgToDouble(type, value));
+        }
+        else if (conversion == 'p')
+        {
+            spec[specLength++] = 'p';
+            spec[specLength] = '\0';
+            written = std::snprintf(out, room, spec, (void*)(uintptr_t)value);
+        }
+        else if (conversion == 'c')
+        {
+            spec[specLength++] = 'c';
+            spec[specLength] = '\0';
+            written = std::snprintf(out, room, spec, (int)ArgToInt(type, value));
+        }
+        else if (conversion == 'd' || conversion == 'i')
+        {
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'd';
+            spec[specLength] = '\0';
+            written = std::snprintf(out, room, spec, (long long)ArgToSigned(type, value, bits));
+        }
+        else
+        {
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'l';
+            spec[specLength++] = std::strchr("uoxX", conversion) ? conversion : 'u';
+            spec[specLength] = '\0';
+            written = std::snprintf(out, room, spec, (unsigned long long)ArgToBits(type, value, bits));
+        }
+
+        length += ClampLength(written, room - 1);
+    }
+
+    text[length] = '\0';
+    return length;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+/** Each channel represent engine's module */
+enum eDebugLogChannel
+{
+    CHANNEL_LOGMGR    = 1 << 0,
+    CHANNEL_GT2D      = 1 << 1,
+    CHANNEL_GRAPHICS  = 1 << 4,
+    CHANNEL_INPUT     = 1 << 5,
+    CHANNEL_SOUND     = 1 << 6,
+    CHANNEL_ANIMATION = 1 << 7,
+    CHANNEL_SCRIPT    = 1 << 8,
+    CHANNEL_GAME      = 1 << 9
+};
+
+enum eDebugLogPriority
+{
+    PR_ERROR   = 1 << 0,
+    PR_WARNING = 1 << 1,
+    PR_NOTE    = 1 << 2
+};
+
+/**
+ * Type of packed argument goes into low 4 bits of its first byte, size of
+ * value into high ones. Integers keep least bytes they fit in, doubles are
+ * stored as floats when it's exact. Strings are stored with u16 length and null
+ */
+enum eLogArg
+{
+    LOG_ARG_INT = 0,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_POINTER,
+    LOG_ARG_STRING
+};
+
+/**
+ * Binary log, little-endian:
+ *   LogFileHeader
+ *   LogEntry followed by size bytes, one after another
+ * Format entry defines name and format of id, both null-terminated.
+ * Later definition of the same id replaces previous one.
+ * Note entry refers to format and keeps its packed arguments
+ */
+static constexpr char LOG_MAGIC[4] = { 'G', 'T', 'L', 'G' };
+static constexpr u32 LOG_VERSION = 1;
+
+enum eLogEntry
+{
+    LOG_ENTRY_FORMAT = 1,
+    LOG_ENTRY_NOTE
+};
+
+struct LogFileHeader
+{
+    char magic[4];
+    u32 version;
+
+    /** Seconds since epoch when log was started */
+    u64 startTime;
+};
+
+struct LogEntry
+{
+    /** Milliseconds since log was started */
+    u32 time;
+    u16 format;
+    u16 channel;
+    u8 kind;
+    u8 priority;
+    u16 size;
+};
+
+const char* GetLogChannelName(s32 channel);
+const char* GetLogPriorityName(s32 priority);
+
+/**
+ * Same as snprintf() but takes packed arguments. Every spec gets length
+ * of stored type, mismatched arguments are converted and missing ones
+ * are printed as <?>. Returns length without null
+ */
+s32 FormatLogArgs(char* text, s32 maxLength, const char* fmt, const u8* pArgs, s32 argsSize);
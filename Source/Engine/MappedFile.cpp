@@ -0,0 +1,111 @@
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#include "Engine/MappedFile.h"
+
+MappedFile::MappedFile()
+{
+    m_pData = nullptr;
+    m_size = 0;
+
+#ifdef _WIN32
+    m_hFile = INVALID_HANDLE_VALUE;
+    m_hMapping = nullptr;
+#else
+    m_fd = -1;
+#endif
+}
+
+b32 MappedFile::Open(const char* path)
+{
+    Close();
+
+#ifdef _WIN32
+    m_hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_hMapping)
+    {
+        Close();
+        return false;
+    }
+
+    m_pData = (const u8*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+    m_size = (u64)size.QuadPart;
+#else
+    m_fd = open(path, O_RDONLY);
+    if (m_fd == -1)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0 || info.st_size == 0)
+    {
+        Close();
+        return false;
+    }
+
+    void* pData = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    m_pData = pData != MAP_FAILED ? (const u8*)pData : nullptr;
+    m_size = (u64)info.st_size;
+#endif
+
+    if (!m_pData)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (m_pData)
+    {
+        UnmapViewOfFile(m_pData);
+    }
+    if (m_hMapping)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_pData)
+    {
+        munmap((void*)m_pData, (size_t)m_size);
+    }
+    if (m_fd != -1)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+#endif
+
+    m_pData = nullptr;
+    m_size = 0;
+}
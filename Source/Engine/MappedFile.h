@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+/**
+ * Read-only file mapped into memory. Pages are read by system
+ * when they're touched first, so unused parts of big files
+ * don't take memory
+ */
+class MappedFile
+{
+    const u8* m_pData;
+    u64 m_size;
+
+#ifdef _WIN32
+    void* m_hFile;
+    void* m_hMapping;
+#else
+    s32 m_fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** False on error, previous file is closed anyway */
+    b32 Open(const char* path);
+    void Close();
+
+    forceinline b32 IsOpen() const { return m_pData != nullptr; }
+    forceinline const u8* GetData() const { return m_pData; }
+    forceinline u64 GetSize() const { return m_size; }
+};
@@ -0,0 +1,348 @@
+#include <new>
+#include "SDL.h"
+#include "Engine/StdHeaders.h"
+#include "Engine/MemoryTracker.h"
+
+static constexpr u32 ALLOCATION_MAGIC = 0x6D656D47; // "Gmem"
+
+static constexpr s32 MB = 1024 * 1024;
+
+static constexpr s32 DEFAULT_BUDGETS[MEMORY_TAG_COUNT] = {
+    0,        // General
+    256 * MB, // Graphics
+    128 * MB, // Sound
+    64 * MB,  // Script
+    64 * MB,  // World
+    8 * MB,   // AI
+    32 * MB   // Containers
+};
+
+static constexpr const char* TAG_NAMES[MEMORY_TAG_COUNT] = {
+    "General",
+    "Graphics",
+    "Sound",
+    "Script",
+    "World",
+    "AI",
+    "Containers"
+};
+
+/** In front of every block, 16 bytes keep malloc's alignment */
+struct AllocationHeader
+{
+    u64 size;
+    u32 tag;
+    u32 magic;
+};
+
+/** Zero-initialized before any constructor runs, so allocations of static objects are counted too */
+struct TagCounters
+{
+    SDL_atomic_t liveBytes;
+    SDL_atomic_t peakBytes;
+    SDL_atomic_t liveAllocs;
+    SDL_atomic_t frameAllocs;
+    SDL_atomic_t frameBytes;
+};
+
+static TagCounters s_aCounters[MEMORY_TAG_COUNT];
+
+internal void CountBytes(TagCounters& counters, s32 bytes)
+{
+    s32 live = SDL_AtomicAdd(&counters.liveBytes, bytes) + bytes;
+    s32 peak = SDL_AtomicGet(&counters.peakBytes);
+    while (live > peak && !SDL_AtomicCAS(&counters.peakBytes, peak, live))
+    {
+        peak = SDL_AtomicGet(&counters.peakBytes);
+    }
+}
+
+internal void CountAllocation(TagCounters& counters, s32 bytes)
+{
+    SDL_AtomicAdd(&counters.frameAllocs, 1);
+    SDL_AtomicAdd(&counters.frameBytes, bytes);
+}
+
+internal void* SDLCALL AllocateZeroed(size_t count, size_t size)
+{
+    if (size && count > SIZE_MAX / size)
+    {
+        return nullptr;
+    }
+
+    void* p = MemoryTracker::Allocate(count * size);
+    if (p)
+    {
+        std::memset(p, 0, count * size);
+    }
+    return p;
+}
+
+internal void* AllocateOrDie(size_t size)
+{
+    void* p = MemoryTracker::Allocate(size);
+    if (!p)
+    {
+        LogNote(CHANNEL_GT2D, PR_ERROR, "MemoryTracker", "Out of memory on %u bytes", (u32)size);
+        ForceShutDown();
+    }
+    return p;
+}
+
+void MemoryTracker::StartUp()
+{
+    for (i32f i = 0; i < MEMORY_TAG_COUNT; ++i)
+    {
+        m_aBudgets[i] = DEFAULT_BUDGETS[i];
+        m_aOverBudget[i] = false;
+        m_aFrameAllocs[i] = 0;
+        m_aFrameBytes[i] = 0;
+    }
+
+    AddNote(PR_NOTE, "Module started");
+}
+
+void MemoryTracker::ShutDown()
+{
+    // What's left here is freed by modules which are still alive or leaks
+    Report();
+
+    AddNote(PR_NOTE, "Module shut down");
+}
+
+void MemoryTracker::HookSDL()
+{
+    SDL_SetMemoryFunctions(Allocate, AllocateZeroed, Reallocate, Free);
+}
+
+void MemoryTracker::EndFrame()
+{
+    for (i32f i = 0; i < MEMORY_TAG_COUNT; ++i)
+    {
+        m_aFrameAllocs[i] = SDL_AtomicSet(&s_aCounters[i].frameAllocs, 0);
+        m_aFrameBytes[i] = SDL_AtomicSet(&s_aCounters[i].frameBytes, 0);
+
+        // Warn once when tag gets over its budget
+        if (!m_aBudgets[i])
+        {
+            continue;
+        }
+
+        s32 live = SDL_AtomicGet(&s_aCounters[i].liveBytes);
+        if (live > m_aBudgets[i] && !m_aOverBudget[i])
+        {
+            AddNote(PR_WARNING, "%s is over budget: %.2f MB of %.2f MB", TAG_NAMES[i], live / (f64)MB, m_aBudgets[i] / (f64)MB);
+            m_aOverBudget[i] = true;
+        }
+        else if (live <= m_aBudgets[i])
+        {
+            m_aOverBudget[i] = false;
+        }
+    }
+}
+
+void MemoryTracker::SetBudget(s32 tag, s32 bytes)
+{
+    if (tag < 0 || tag >= MEMORY_TAG_COUNT)
+    {
+        AddNote(PR_WARNING, "SetBudget(): unknown tag %d", tag);
+        return;
+    }
+
+    m_aBudgets[tag] = bytes > 0 ? bytes : 0;
+    m_aOverBudget[tag] = false;
+}
+
+void MemoryTracker::GetStats(s32 tag, MemoryStats& stats) const
+{
+    TagCounters& counters = s_aCounters[tag];
+
+    stats.liveBytes = SDL_AtomicGet(&counters.liveBytes);
+    stats.peakBytes = SDL_AtomicGet(&counters.peakBytes);
+    stats.liveAllocs = SDL_AtomicGet(&counters.liveAllocs);
+    stats.frameAllocs = m_aFrameAllocs[tag];
+    stats.frameBytes = m_aFrameBytes[tag];
+    stats.budget = m_aBudgets[tag];
+}
+
+void MemoryTracker::Report()
+{
+    for (i32f i = 0; i < MEMORY_TAG_COUNT; ++i)
+    {
+        MemoryStats stats;
+        GetStats((s32)i, stats);
+
+        AddNote(
+            PR_NOTE, "%-10s live %8.2f MB, peak %8.2f MB, %7d blocks, last frame %5d allocs %8.1f KB, budget %.0f MB",
+            TAG_NAMES[i], stats.liveBytes / (f64)MB, stats.peakBytes / (f64)MB, stats.liveAllocs,
+            stats.frameAllocs, stats.frameBytes / 1024.0, stats.budget / (f64)MB
+        );
+    }
+}
+
+b32 MemoryTracker::WriteReport(const char* path)
+{
+    std::FILE* hFile = std::fopen(path, "w");
+    if (!hFile)
+    {
+        AddNote(PR_WARNING, "Can't open memory report: %s", path);
+        return false;
+    }
+
+    std::fprintf(hFile, "%-10s %12s %12s %10s %12s %12s %12s\n", "Tag", "Live", "Peak", "Blocks", "FrameAllocs", "FrameBytes", "Budget");
+    for (i32f i = 0; i < MEMORY_TAG_COUNT; ++i)
+    {
+        MemoryStats stats;
+        GetStats((s32)i, stats);
+
+        std::fprintf(
+            hFile, "%-10s %12d %12d %10d %12d %12d %12d\n",
+            TAG_NAMES[i], stats.liveBytes, stats.peakBytes, stats.liveAllocs, stats.frameAllocs, stats.frameBytes, stats.budget
+        );
+    }
+
+    std::fclose(hFile);
+    return true;
+}
+
+const char* MemoryTracker::GetTagName(s32 tag)
+{
+    return tag >= 0 && tag < MEMORY_TAG_COUNT ? TAG_NAMES[tag] : "Undefined";
+}
+
+void* MemoryTracker::Allocate(size_t size)
+{
+    AllocationHeader* pHeader = (AllocationHeader*)std::malloc(sizeof(AllocationHeader) + size);
+    if (!pHeader)
+    {
+        return nullptr;
+    }
+
+    pHeader->size = size;
+    pHeader->tag = (u32)t_memoryTag;
+    pHeader->magic = ALLOCATION_MAGIC;
+
+    TagCounters& counters = s_aCounters[pHeader->tag];
+    CountBytes(counters, (s32)size);
+    CountAllocation(counters, (s32)size);
+    SDL_AtomicAdd(&counters.liveAllocs, 1);
+
+    return pHeader + 1;
+}
+
+void* MemoryTracker::Reallocate(void* p, size_t size)
+{
+    if (!p)
+    {
+        return Allocate(size);
+    }
+
+    // Block keeps tag of who allocated it first
+    AllocationHeader* pHeader = (AllocationHeader*)p - 1;
+    u64 oldSize = pHeader->size;
+    u32 tag = pHeader->tag;
+
+    pHeader = (AllocationHeader*)std::realloc(pHeader, sizeof(AllocationHeader) + size);
+    if (!pHeader)
+    {
+        return nullptr;
+    }
+
+    pHeader->size = size;
+
+    TagCounters& counters = s_aCounters[tag];
+    CountBytes(counters, (s32)((s64)size - (s64)oldSize));
+    if (size > oldSize)
+    {
+        CountAllocation(counters, (s32)(size - oldSize));
+    }
+
+    return pHeader + 1;
+}
+
+void MemoryTracker::Free(void* p)
+{
+    if (!p)
+    {
+        return;
+    }
+
+    AllocationHeader* pHeader = (AllocationHeader*)p - 1;
+#ifdef _DEBUG
+    if (pHeader->magic != ALLOCATION_MAGIC)
+    {
+        // Block came from other allocator or was freed twice
+        ForceShutDown();
+    }
+    pHeader->magic = 0;
+#endif
+
+    TagCounters& counters = s_aCounters[pHeader->tag];
+    CountBytes(counters, -(s32)pHeader->size);
+    SDL_AtomicAdd(&counters.liveAllocs, -1);
+
+    std::free(pHeader);
+}
+
+void MemoryTracker::Track(s32 tag, s64 delta, s32 blocks)
+{
+    TagCounters& counters = s_aCounters[tag];
+    CountBytes(counters, (s32)delta);
+    SDL_AtomicAdd(&counters.liveAllocs, blocks);
+
+    if (delta > 0)
+    {
+        CountAllocation(counters, (s32)delta);
+    }
+}
+
+/** Every new and delete of engine goes through tracker */
+void* operator new(size_t size)
+{
+    return AllocateOrDie(size);
+}
+
+void* operator new[](size_t size)
+{
+    return AllocateOrDie(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return MemoryTracker::Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return MemoryTracker::Allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    MemoryTracker::Free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    MemoryTracker::Free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    MemoryTracker::Free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    MemoryTracker::Free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    MemoryTracker::Free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    MemoryTracker::Free(p);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Engine/EngineModule.h"
+
+/** Subsystem which owns allocation */
+enum eMemoryTag
+{
+    MEMORY_GENERAL = 0,
+    MEMORY_GRAPHICS,
+    MEMORY_SOUND,
+    MEMORY_SCRIPT,
+    MEMORY_WORLD,
+    MEMORY_AI,
+    MEMORY_CONTAINERS,
+
+    MEMORY_TAG_COUNT
+};
+
+struct MemoryStats
+{
+    s32 liveBytes;
+    s32 peakBytes;
+    s32 liveAllocs;
+
+    /** Of the last finished frame */
+    s32 frameAllocs;
+    s32 frameBytes;
+
+    /** 0 if there's no budget */
+    s32 budget;
+};
+
+/** Tag of allocations made on this thread */
+inline thread_local s32 t_memoryTag = MEMORY_GENERAL;
+
+/**
+ * Allocations made on this thread until scope ends get the tag.
+ * Scopes nest, inner tag wins. Fallback scope only tags allocations
+ * which would be General, so containers don't hide their owners
+ */
+class MemoryScope
+{
+    s32 m_prevTag;
+
+public:
+    forceinline MemoryScope(s32 tag, b32 bFallback = false) : m_prevTag(t_memoryTag)
+    {
+        if (!bFallback || m_prevTag == MEMORY_GENERAL)
+        {
+            t_memoryTag = tag;
+        }
+    }
+
+    forceinline ~MemoryScope() { t_memoryTag = m_prevTag; }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+};
+
+/**
+ * Counts every operator new and SDL allocation by tag of current
+ * MemoryScope, Lua states report their own memory as Script.
+ * Counters are 32-bit, so every tag is expected to stay under 2 GB.
+ * Budgets are checked once per frame and warn when live bytes get over them
+ */
+class MemoryTracker final : public EngineModule
+{
+    s32 m_aBudgets[MEMORY_TAG_COUNT];
+    b32 m_aOverBudget[MEMORY_TAG_COUNT];
+    s32 m_aFrameAllocs[MEMORY_TAG_COUNT];
+    s32 m_aFrameBytes[MEMORY_TAG_COUNT];
+
+public:
+    MemoryTracker() : EngineModule("MemoryTracker", CHANNEL_GT2D) {}
+
+    void StartUp();
+    void ShutDown();
+
+    /** SDL must get our memory functions before it allocates anything, so it goes before other modules */
+    static void HookSDL();
+
+    void EndFrame();
+
+    void SetBudget(s32 tag, s32 bytes);
+    void GetStats(s32 tag, MemoryStats& stats) const;
+
+    /** Writes table of all tags to log or file */
+    void Report();
+    b32 WriteReport(const char* path);
+
+    static const char* GetTagName(s32 tag);
+
+    /** Tagged malloc family, pointers carry their size and tag */
+    static void* Allocate(size_t size);
+    static void* Reallocate(void* p, size_t size);
+    static void Free(void* p);
+
+    /** For allocators which know sizes themselves, blocks is +1 for new block and -1 for freed one */
+    static void Track(s32 tag, s64 delta, s32 blocks);
+};
+
+inline MemoryTracker g_memoryTracker;
@@ -1,8 +1,25 @@
 #pragma once
 
-#include <intrin.h>
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#else
+    #include <x86intrin.h>
+#endif
 
 #define internal static
-#define forceinline __forceinline
 
-#define ForceShutDown() __debugbreak()
+#if defined(_MSC_VER)
+    #define forceinline __forceinline
+    #define ForceShutDown() __debugbreak()
+#else
+    #define forceinline inline __attribute__((always_inline))
+    #define ForceShutDown() __builtin_trap()
+#endif
+
+/** Widest instruction set kernels may use, scalar code otherwise */
+#if defined(__AVX2__)
+    #define SIMD_AVX2
+#endif
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SIMD_SSE2
+#endif
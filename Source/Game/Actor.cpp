@@ -3,6 +3,8 @@
 #include "Game/Game.h"
 #include "Game/Weapon.h"
 #include "Game/Actor.h"
+#include "Script/ScriptModule.h"
+#include "Script/ScriptScheduler.h"
 
 void Actor::Init(const Vector2& vPosition, s32 width, s32 height, const Texture* pTexture)
 {
@@ -24,8 +26,10 @@ void Actor::Init(const Vector2& vPosition, s32 width, s32 height, const Texture*
     m_attackRate = ACTOR_DEFAULT_ATTACK_RATE;
     m_pWeapon = nullptr;
 
-    // Init AI
+    // Init AI, position is updated by world after all actors made their decision
     m_state.SetActor(this);
+    m_randomState = (u32)std::rand() * 2654435761u | 1u;
+    SetPasses(ENTITY_PASS_THINK | ENTITY_PASS_LOGIC | ENTITY_PASS_WALK | ENTITY_PASS_ANIMATE);
 
     // Init default actor animations
     for (i32f i = 0; i < MAX_ACTOR_ANIMATIONS; ++i)
@@ -45,7 +49,8 @@ void Actor::Update(f32 dtTime)
     // Handle only animation if actor is dead
     if (HandleDeath())
     {
-        HandleAnimation(dtTime);
+        Velocity().Zero();
+        HandleAnimation();
         return;
     }
 
@@ -55,8 +60,33 @@ void Actor::Update(f32 dtTime)
     HandleAICommand(dtTime);
 
     // React via changing state and it's animation
-    HandleActorState(dtTime);
-    HandleAnimation(dtTime);
+    HandleActorState();
+    HandleAnimation();
+}
+
+void Actor::Think()
+{
+    // Dead actors don't handle tasks
+    if (m_health <= 0 || m_actorState == ACTOR_STATE_DEAD)
+    {
+        return;
+    }
+
+    for (auto it = m_lstTask.Begin(); it; ++it)
+    {
+        if (it->data->IsParallel())
+        {
+            it->data->HandleParallel();
+        }
+    }
+}
+
+void Actor::OnAnimationEnd()
+{
+    if (m_actorState == ACTOR_STATE_ANIMATE_ONCE)
+    {
+        SetActorState(ACTOR_STATE_AFTER_ANIMATION);
+    }
 }
 
 void Actor::AddHealth(f32 diff)
@@ -67,6 +97,28 @@ void Actor::AddHealth(f32 diff)
     }
 }
 
+void Actor::SetActorState(s32 state)
+{
+    b32 bAnimationEnded = m_actorState == ACTOR_STATE_ANIMATE_ONCE && state != ACTOR_STATE_ANIMATE_ONCE;
+    m_actorState = state;
+
+    // Scripts waiting for animation shouldn't wait forever when something else took actor
+    if (bAnimationEnded)
+    {
+        g_scriptModule.SignalEvent(this, SCRIPT_EVENT_ANIMATION_END);
+    }
+}
+
+void Actor::PlayAnimOnce(const Animation* pAnim)
+{
+    Anim() = pAnim;
+    AnimFrame() = 0;
+    AnimElapsed() = 0.0f;
+    AnimMode() = ANIMATION_MODE_ONCE;
+
+    SetActorState(ACTOR_STATE_ANIMATE_ONCE);
+}
+
 void Actor::PushTask(AITask* pTask)
 {
     if (pTask)
@@ -97,48 +149,49 @@ b32 Actor::HandleDeath()
     // Play sound
     if (m_pDeathSound)
     {
-        g_soundModule.PlaySound(m_pDeathSound);
+        g_soundModule.PlaySoundAt(m_pDeathSound, Position());
     }
 
-    // Init animation
-    m_animFrame = 0;
-    m_animElapsed = 0.0f;
+    // Init animation, it stops on the last frame
+    AnimFrame() = 0;
+    AnimElapsed() = 0.0f;
+    AnimMode() = ANIMATION_MODE_ONCE;
 
     // Set state
-    m_actorState = ACTOR_STATE_DEAD;
+    SetActorState(ACTOR_STATE_DEAD);
+    g_scriptModule.SignalEvent(this, SCRIPT_EVENT_DEATH);
 
     return true;
 }
 
-void Actor::HandleActorState(f32 dtTime)
+void Actor::HandleActorState()
 {
     switch (m_actorState)
     {
     case ACTOR_STATE_MOVE:
     {
         // Idle if we don't move
-        if (!m_vVelocity.x && !m_vVelocity.y)
+        if (!Velocity().x && !Velocity().y)
         {
-            m_actorState = ACTOR_STATE_IDLE;
+            SetActorState(ACTOR_STATE_IDLE);
         }
     } break;
 
     case ACTOR_STATE_ATTACK:
     {
         // Idle if we don't attack too long
-        if (m_animElapsed >= m_pAnim->frameDuration)
+        if (AnimElapsed() >= Anim()->frameDuration)
         {
-            m_actorState = ACTOR_STATE_IDLE;
+            SetActorState(ACTOR_STATE_IDLE);
         }
     } break;
 
     case ACTOR_STATE_ANIMATE_ONCE:
     {
-        // If we ended
-        if (!m_pAnim || (m_animFrame >= m_pAnim->count - 1 &&
-                         m_animElapsed + dtTime >= m_pAnim->frameDuration))
+        // End is reported by animation pass, but there's nothing to wait without animation
+        if (!Anim())
         {
-            m_actorState = ACTOR_STATE_AFTER_ANIMATION;
+            SetActorState(ACTOR_STATE_AFTER_ANIMATION);
         }
     } break;
 
@@ -154,13 +207,13 @@ void Actor::HandleAITasks()
         return;
     }
 
-    // Handle first task, don't delete it
-    it->data->Handle();
+    // Handle first task, don't delete it. Parallel tasks may be handled already by Think()
+    it->data->HandleSerial();
 
     // Handle other tasks and if they're done - delete them
     for (++it; it; )
     {
-        it->data->Handle();
+        it->data->HandleSerial();
         if (it->data->GetStatus() != AITASK_INPROCESS)
         {
             AITask* pRemove = it->data;
@@ -178,7 +231,7 @@ void Actor::HandleAITasks()
 void Actor::HandleAICommand(f32 dtTime)
 {
     // Zero velocity
-    m_vVelocity.Zero();
+    Velocity().Zero();
 
     // Handle command list
     while (!m_lstCommand.IsEmpty())
@@ -200,44 +253,23 @@ void Actor::HandleAICommand(f32 dtTime)
         }
         m_lstCommand.Pop();
     }
-
-    // Update position
-    Vector2 vNewPosition = m_vPosition + m_vVelocity;
-    if (m_bCollidable && !g_collisionMgr.IsOnGround(vNewPosition, m_hitBox))
-    {
-        // Try move only through x-axis
-        vNewPosition.y -= m_vVelocity.y;
-        if (!g_collisionMgr.IsOnGround(vNewPosition, m_hitBox))
-        {
-            // Try to move only through y-axis
-            vNewPosition.x -= m_vVelocity.x;
-            vNewPosition.y += m_vVelocity.y;
-            if (!g_collisionMgr.IsOnGround(vNewPosition, m_hitBox))
-            {
-                // So we'll not move...
-                vNewPosition.y -= m_vVelocity.y;
-            }
-        }
-    }
-
-    m_vPosition = vNewPosition;
 }
 
 void Actor::CommandMove(s32 cmd, f32 dtTime)
 {
     switch (cmd)
     {
-    case AICMD_MOVE_UP:    m_vVelocity.y -= m_vSpeed.y * dtTime; break;
-    case AICMD_MOVE_LEFT:  m_vVelocity.x -= m_vSpeed.x * dtTime; break;
-    case AICMD_MOVE_DOWN:  m_vVelocity.y += m_vSpeed.y * dtTime; break;
-    case AICMD_MOVE_RIGHT: m_vVelocity.x += m_vSpeed.x * dtTime; break;
+    case AICMD_MOVE_UP:    Velocity().y -= m_vSpeed.y * dtTime; break;
+    case AICMD_MOVE_LEFT:  Velocity().x -= m_vSpeed.x * dtTime; break;
+    case AICMD_MOVE_DOWN:  Velocity().y += m_vSpeed.y * dtTime; break;
+    case AICMD_MOVE_RIGHT: Velocity().x += m_vSpeed.x * dtTime; break;
 
     default: break;
     }
 
     if (m_actorState == ACTOR_STATE_IDLE || m_actorState == ACTOR_STATE_AFTER_ANIMATION)
     {
-        m_actorState = ACTOR_STATE_MOVE;
+        SetActorState(ACTOR_STATE_MOVE);
     }
 }
 
@@ -250,13 +282,13 @@ void Actor::CommandAttack()
     // If we already attacking
     if (m_actorState == ACTOR_STATE_ATTACK)
     {
-        if (m_animElapsed >= m_attackRate)
+        if (AnimElapsed() >= m_attackRate)
         {
-            m_animElapsed = 0.0f;
-            ++m_animFrame;
-            if (m_animFrame >= m_pAnim->count)
+            AnimElapsed() = 0.0f;
+            ++AnimFrame();
+            if (AnimFrame() >= Anim()->count)
             {
-                m_animFrame = 0;
+                AnimFrame() = 0;
             }
 
             bHit = true;
@@ -264,21 +296,21 @@ void Actor::CommandAttack()
     }
     else
     {
-        m_pAnim = m_pWeapon ? m_pWeapon->GetAnimation() : m_aActorAnims[ACTOR_ANIMATION_IDLE];
-        m_animFrame = 0;
-        m_animElapsed = 0.0f;
+        Anim() = m_pWeapon ? m_pWeapon->GetAnimation() : m_aActorAnims[ACTOR_ANIMATION_IDLE];
+        AnimFrame() = 0;
+        AnimElapsed() = 0.0f;
 
         bHit = true;
-        m_actorState = ACTOR_STATE_ATTACK;
+        SetActorState(ACTOR_STATE_ATTACK);
     }
 
     // Play sound
     if (bHit && m_pWeapon)
     {
-        m_pWeapon->PlaySound();
+        m_pWeapon->PlaySoundAt(Position());
 
         // Get point for the hit registration
-        Vector2 vPoint = m_vPosition;
+        Vector2 vPoint = Position();
         vPoint.x += m_bLookRight ? m_pWeapon->GetHitBox().x2 : m_pWeapon->GetHitBox().x1;
 
         // Get collided actors with this hit
@@ -299,15 +331,15 @@ void Actor::CommandAttack()
             this
         );
 
-        // Remove health from collided actors
+        // Remove health from collided actors at sync point
         for (auto it = lstActor.Begin(); it; ++it)
         {
-            static_cast<Actor*>(it->data)->AddHealth(-m_pWeapon->GetDamage());
+            g_game.GetWorld().GetCommands().Damage(this, static_cast<Actor*>(it->data), m_pWeapon->GetDamage());
         }
     }
 }
 
-void Actor::HandleAnimation(f32 dtTime)
+void Actor::HandleAnimation()
 {
     // Check if default animations aren't initialized
     if (!m_aActorAnims[ACTOR_ANIMATION_IDLE])
@@ -316,11 +348,11 @@ void Actor::HandleAnimation(f32 dtTime)
     }
 
     // Set default animation if we don't have
-    if (!m_pAnim)
+    if (!Anim())
     {
-        m_pAnim = m_aActorAnims[ACTOR_ANIMATION_IDLE];
-        m_animFrame = 0;
-        m_animElapsed = 0.0f;
+        Anim() = m_aActorAnims[ACTOR_ANIMATION_IDLE];
+        AnimFrame() = 0;
+        AnimElapsed() = 0.0f;
         if (!m_bLookRight)
         {
             m_flip = SDL_FLIP_HORIZONTAL;
@@ -328,82 +360,72 @@ void Actor::HandleAnimation(f32 dtTime)
         return;
     }
 
-    // Update timer
-    m_animElapsed += dtTime;
-
     switch (m_actorState)
     {
     case ACTOR_STATE_IDLE:            AnimateIdle(); break;
-    case ACTOR_STATE_AFTER_ANIMATION: AnimateAfterAnimation(); return;
+    case ACTOR_STATE_AFTER_ANIMATION: AnimateAfterAnimation(); break;
     case ACTOR_STATE_MOVE:            AnimateMove(); break;
-    case ACTOR_STATE_ATTACK:          AnimateAttack(); return;
+    case ACTOR_STATE_ATTACK:          AnimateAttack(); break;
+    case ACTOR_STATE_DEAD:            AnimateDead(); break;
     case ACTOR_STATE_INCAR:           AnimateInCar(); break;
 
-    case ACTOR_STATE_DEAD:
+    case ACTOR_STATE_ANIMATE_LOOPED:
     {
-        if (AnimateDead())
-        {
-            return;
-        }
+        AnimMode() = ANIMATION_MODE_LOOP;
+        m_flip = m_bLookRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
     } break;
 
+    // ONCE mode was set when animation started
     default:
     {
         m_flip = m_bLookRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
     } break;
     }
-
-    // Update frame
-    if (m_animElapsed > m_pAnim->frameDuration)
-    {
-        m_animElapsed = 0;
-        ++m_animFrame;
-    }
-
-    // Loop animation and reset new animations with smaller count
-    if (m_animFrame >= m_pAnim->count)
-    {
-        m_animFrame = 0;
-    }
 }
 
 void Actor::AnimateIdle()
 {
-    m_pAnim = m_aActorAnims[ACTOR_ANIMATION_IDLE];
+    Anim() = m_aActorAnims[ACTOR_ANIMATION_IDLE];
+    AnimMode() = ANIMATION_MODE_LOOP;
 
     m_flip = m_bLookRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
 }
 
 void Actor::AnimateAfterAnimation()
 {
+    // Last frame of played animation stays
+    AnimMode() = ANIMATION_MODE_HOLD;
+
     m_flip = m_bLookRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
 }
 
 void Actor::AnimateMove()
 {
-    if (m_vVelocity.x > 0)
+    AnimMode() = ANIMATION_MODE_LOOP;
+
+    if (Velocity().x > 0)
     {
-        m_pAnim = m_aActorAnims[ACTOR_ANIMATION_HORIZONTAL];
+        Anim() = m_aActorAnims[ACTOR_ANIMATION_HORIZONTAL];
 
         m_bLookRight = true;
         m_flip = SDL_FLIP_NONE;
     }
-    else if (m_vVelocity.x < 0)
+    else if (Velocity().x < 0)
     {
-        m_pAnim = m_aActorAnims[ACTOR_ANIMATION_HORIZONTAL];
+        Anim() = m_aActorAnims[ACTOR_ANIMATION_HORIZONTAL];
 
         m_bLookRight = false;
         m_flip = SDL_FLIP_HORIZONTAL;
     }
-    else if (m_vVelocity.y > 0)
+    else if (Velocity().y > 0)
     {
-        m_pAnim = m_aActorAnims[ACTOR_ANIMATION_BOTTOM];
+        Anim() = m_aActorAnims[ACTOR_ANIMATION_BOTTOM];
 
         m_flip = SDL_FLIP_NONE;
     }
-    else if (m_vVelocity.y < 0)
+    else if (Velocity().y < 0)
     {
-        m_pAnim = m_aActorAnims[ACTOR_ANIMATION_TOP];
+        Anim() = m_aActorAnims[ACTOR_ANIMATION_TOP];
 
         m_flip = SDL_FLIP_NONE;
     }
@@ -411,13 +433,16 @@ void Actor::AnimateMove()
 
 void Actor::AnimateAttack()
 {
+    // Frames follow attacks, only time goes
+    AnimMode() = ANIMATION_MODE_HOLD;
+
     // Check if we need flip
-    if (m_vVelocity.x > 0)
+    if (Velocity().x > 0)
     {
         m_bLookRight = true;
         m_flip = SDL_FLIP_NONE;
     }
-    else if (m_vVelocity.x < 0)
+    else if (Velocity().x < 0)
     {
         m_bLookRight = false;
         m_flip = SDL_FLIP_HORIZONTAL;
@@ -428,15 +453,14 @@ void Actor::AnimateAttack()
     }
 }
 
-b32 Actor::AnimateDead()
+void Actor::AnimateDead()
 {
-    m_pAnim = m_aActorAnims[ACTOR_ANIMATION_DEAD];
-
-    // Check if we done
-    return m_animFrame == m_pAnim->count - 1;
+    // Played once since death, then held on the last frame
+    Anim() = m_aActorAnims[ACTOR_ANIMATION_DEAD];
 }
 
 void Actor::AnimateInCar()
 {
-    m_pAnim = m_aActorAnims[ACTOR_ANIMATION_INCAR];
+    Anim() = m_aActorAnims[ACTOR_ANIMATION_INCAR];
+    AnimMode() = ANIMATION_MODE_LOOP;
 }
@@ -79,6 +79,9 @@ private:
     TList<AITask*> m_lstTask;
     TList<s32> m_lstCommand;
 
+    /** Own random state, tasks roll dice in parallel */
+    u32 m_randomState;
+
 public:
     /** Animations */
     const Animation* m_aActorAnims[MAX_ACTOR_ANIMATIONS];
@@ -87,9 +90,17 @@ public:
     virtual void Init(const Vector2& vPosition, s32 width, s32 height, const Texture* pTexture) override;
     virtual void Clean() override;
     virtual void Update(f32 dtTime) override;
+    virtual void Think() override;
+    virtual void OnAnimationEnd() override;
 
     void AddHealth(f32 diff);
 
+    /** Leaving ANIMATE_ONCE in any way signals animation end */
+    void SetActorState(s32 state);
+
+    /** Animation is played from the first frame, actor is ANIMATE_ONCE until it ends */
+    void PlayAnimOnce(const Animation* pAnim);
+
     forceinline void SetState(const char* functionName) { m_state.SetFunctionName(functionName); }
     forceinline const AIState& GetState() const { return m_state; }
 
@@ -99,26 +110,30 @@ public:
 
     forceinline void PushCommand(s32 enumCmd) { m_lstCommand.Push(enumCmd); }
 
+    /** In [0, max), safe in Think() */
+    forceinline s32 Random(s32 max) { return (s32)(Math::XorShift(m_randomState) % (u32)max); }
+
 private:
     b32 HandleDeath();
-    void HandleActorState(f32 dtTime);
+    void HandleActorState();
 
     forceinline void HandleAIState() { m_state.Handle(); }
     void HandleAITasks();
     void HandleAICommand(f32 dtTime);
 
-    forceinline void CommandIdle() { m_actorState = ACTOR_STATE_IDLE; }
+    forceinline void CommandIdle() { SetActorState(ACTOR_STATE_IDLE); }
     forceinline void CommandTurnLeft() { m_bLookRight = false; }
     forceinline void CommandTurnRight() { m_bLookRight = true; }
     void CommandMove(s32 cmd, f32 dtTime);
     void CommandAttack();
 
-    void HandleAnimation(f32 dtTime);
+    /** Picks animation and its mode for state, frames are advanced by AnimationModule */
+    void HandleAnimation();
 
     void AnimateIdle();
     void AnimateAfterAnimation();
     void AnimateMove();
     void AnimateAttack();
-    b32 AnimateDead();
+    void AnimateDead();
     void AnimateInCar();
 };
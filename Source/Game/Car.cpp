@@ -13,15 +13,12 @@ void Car::Init(const Vector2& vPosition, s32 width, s32 height, const Texture* p
         m_aPlacePositions[i] = { 0.0f, 0.0f };
     }
 
-    m_vMaxSpeed.Zero();
-    m_vAcceleration.Zero();
+    // Motion and animation are batched by world, we only carry passengers
+    SetPasses(ENTITY_PASS_LOGIC | ENTITY_PASS_MOTION | ENTITY_PASS_INTEGRATE | ENTITY_PASS_ANIMATE);
 }
 
 void Car::Update(f32 dtTime)
 {
-    HandleVelocity(dtTime);
-    HandlePosition(dtTime);
-    HandleAnimation(dtTime);
     HandleActors();
 }
 
@@ -39,7 +36,7 @@ void Car::PutActor(Actor* pActor, s32 place)
 
     // Place actor and set params
     m_aPlaces[place] = pActor;
-    pActor->m_actorState = ACTOR_STATE_INCAR;
+    pActor->SetActorState(ACTOR_STATE_INCAR);
     pActor->m_renderMode = RENDER_MODE_FOREGROUND;
     HandleActor(place);
 }
@@ -49,7 +46,7 @@ void Car::EjectActor(s32 place)
     // Reset actor's params
     if (g_game.GetWorld().HasEntity(m_aPlaces[place]))
     {
-        m_aPlaces[place]->m_actorState = ACTOR_STATE_IDLE;
+        m_aPlaces[place]->SetActorState(ACTOR_STATE_IDLE);
         m_aPlaces[place]->m_renderMode = RENDER_MODE_DYNAMIC;
     }
 
@@ -57,55 +54,6 @@ void Car::EjectActor(s32 place)
     m_aPlaces[place] = nullptr;
 }
 
-void Car::HandleVelocity(f32 dtTime)
-{
-    // Velocity
-    m_vVelocity += m_vAcceleration * dtTime;
-
-    // X
-    if (std::fabsf(m_vVelocity.x) > std::fabsf(m_vMaxSpeed.x))
-    {
-        m_vVelocity.x = m_vMaxSpeed.x;
-        if (m_vAcceleration.x < 0)
-        {
-            m_vVelocity.x = -m_vVelocity.x;
-        }
-    }
-
-    // Y
-    if (std::fabsf(m_vVelocity.y) > std::fabsf(m_vMaxSpeed.y))
-    {
-        m_vVelocity.y = m_vMaxSpeed.y;
-        if (m_vAcceleration.y < 0)
-        {
-            m_vVelocity.y = -m_vVelocity.y;
-        }
-    }
-}
-
-void Car::HandleAnimation(f32 dtTime)
-{
-    if (!m_pAnim)
-    {
-        return;
-    }
-
-    // Update frames
-    if (m_animElapsed >= m_pAnim->frameDuration)
-    {
-        m_animElapsed = 0;
-        ++m_animFrame;
-
-        if (m_animFrame >= m_pAnim->count)
-        {
-            m_animFrame = 0;
-        }
-    }
-
-    // Update timer
-    m_animElapsed += dtTime;
-}
-
 void Car::HandleActors()
 {
     // Handle actors
@@ -130,10 +78,11 @@ void Car::HandleActors()
 void Car::HandleActor(s32 place)
 {
     // Position
-    m_aPlaces[place]->m_vPosition = {
-        m_vPosition.x + (m_aPlacePositions[place].x * (m_flip == SDL_FLIP_NONE ? 1 : -1)),
-        m_vPosition.y + m_aPlacePositions[place].y
-    };
+    const Vector2& vPosition = Position();
+    m_aPlaces[place]->SetPosition({
+        vPosition.x + (m_aPlacePositions[place].x * (m_flip == SDL_FLIP_NONE ? 1 : -1)),
+        vPosition.y + m_aPlacePositions[place].y
+    });
 
     // zIndex
     if (m_flip == SDL_FLIP_NONE)
@@ -13,9 +13,6 @@ private:
 public:
     Vector2 m_aPlacePositions[MAX_CAR_PLACES];
 
-    Vector2 m_vMaxSpeed;
-    Vector2 m_vAcceleration;
-
 public:
     virtual void Init(const Vector2& vPosition, s32 width, s32 height, const Texture* pTexture) override;
     virtual void Update(f32 dtTime) override;
@@ -24,9 +21,6 @@ public:
     void EjectActor(s32 place);
 
 private:
-    void HandleVelocity(f32 dtTime);
-    forceinline void HandlePosition(f32 dtTime) { m_vPosition += m_vVelocity * dtTime; }
-    void HandleAnimation(f32 dtTIme);
     void HandleActors();
 
     void HandleActor(s32 place);
@@ -1,6 +1,8 @@
 #include "Game/Game.h"
 #include "Game/Actor.h"
 #include "Game/Dialog.h"
+#include "Script/ScriptModule.h"
+#include "Script/ScriptScheduler.h"
 
 #define DIALOG_TEXT_MARGIN_LEFT ((f32)m_width / 20.0f)
 #define DIALOG_TEXT_MARGIN_TOP  ((f32)m_height / 15.0f)
@@ -11,11 +13,15 @@ void Dialog::Init(const Vector2& vPosition, s32 width, s32 height, const Texture
 {
     Entity::Init(vPosition, width, height, pTexture);
     m_type = ENTITY_TYPE_DIALOG;
-    m_bCollidable = false;
+    Collidable() = false;
+    SetPasses(ENTITY_PASS_LOGIC);
 
     m_renderMode = RENDER_MODE_FOREGROUND;
     m_zIndex = 100;
 
+    // Places itself next to attached entity while drawing
+    SetCulled(false);
+
     m_pAttached = nullptr;
     m_time = 0.0f;
     m_bRunning = false;
@@ -35,6 +41,7 @@ void Dialog::Update(f32 dtTime)
     {
         m_bRunning = false;
         g_game.GetWorld().RemoveEntity(this);
+        g_scriptModule.SignalEvent(this, SCRIPT_EVENT_DIALOG_CLOSE);
         return;
     }
 
@@ -53,10 +60,10 @@ void Dialog::Draw()
     HandlePosition();
 
     // Draw dialog box
-    s32 zIndex = m_zIndex + (s32)m_vPosition.y;
+    s32 zIndex = m_zIndex + (s32)Position().y;
 
     SDL_Rect dest = {
-        (s32)m_vPosition.x, (s32)m_vPosition.y,
+        (s32)Position().x, (s32)Position().y,
         m_width, m_height
     };
     g_graphicsModule.DrawFrame(m_renderMode, zIndex, false, dest, m_pTexture, 0, 0, 0.0f, m_flip);
@@ -150,11 +157,11 @@ void Dialog::HandlePosition()
     // X
     if (m_pAttached->m_bLookRight)
     {
-        m_vPosition.x = m_pAttached->m_vPosition.x + m_pAttached->m_hitBox.x2;
-        if (m_vPosition.x - cameraX > g_graphicsModule.GetScreenWidth() - m_width)
+        Position().x = m_pAttached->Position().x + m_pAttached->HitBox().x2;
+        if (Position().x - cameraX > g_graphicsModule.GetScreenWidth() - m_width)
         {
             // Turn left
-            m_vPosition.x = m_pAttached->m_vPosition.x + m_pAttached->m_hitBox.x1 - m_width;
+            Position().x = m_pAttached->Position().x + m_pAttached->HitBox().x1 - m_width;
             m_flip = SDL_FLIP_HORIZONTAL;
         }
         else
@@ -165,11 +172,11 @@ void Dialog::HandlePosition()
     }
     else
     {
-        m_vPosition.x = m_pAttached->m_vPosition.x + m_pAttached->m_hitBox.x1 - m_width;
-        if (m_vPosition.x - cameraX < 0)
+        Position().x = m_pAttached->Position().x + m_pAttached->HitBox().x1 - m_width;
+        if (Position().x - cameraX < 0)
         {
             // Turn right
-            m_vPosition.x = m_pAttached->m_vPosition.x + m_pAttached->m_hitBox.x2;
+            Position().x = m_pAttached->Position().x + m_pAttached->HitBox().x2;
             m_flip = SDL_FLIP_NONE;
         }
         else
@@ -180,7 +187,7 @@ void Dialog::HandlePosition()
     }
 
     // Y
-    m_vPosition.y = m_pAttached->m_vPosition.y + m_pAttached->m_hitBox.y1 - m_height;
+    Position().y = m_pAttached->Position().y + m_pAttached->HitBox().y1 - m_height;
 }
 
 i32f Dialog::WordLength(const char* text)
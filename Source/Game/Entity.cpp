@@ -1,12 +1,18 @@
 #include "Graphics/GraphicsModule.h"
+#include "Game/Game.h"
 #include "Game/Entity.h"
 
 void Entity::Init(const Vector2& vPosition, s32 width, s32 height, const Texture* pTexture)
 {
     m_type = ENTITY_TYPE_ENTITY;
 
-    m_vPosition = vPosition;
-    m_vVelocity = { 0.0f, 0.0f };
+    // Position may point into the store, so copy it before store grows
+    Vector2 vStart = vPosition;
+
+    m_pStore = &g_game.GetWorld().GetEntityStore();
+    m_storeIndex = m_pStore->Allocate(this);
+
+    Position() = vStart;
 
     m_width = width;
     m_height = height;
@@ -16,32 +22,63 @@ void Entity::Init(const Vector2& vPosition, s32 width, s32 height, const Texture
 
     f32 fWidthDiv2 = (f32)width/2.0f - g_graphicsModule.UnitsToPixelsX(1.0f);
     f32 fHeightDiv2 = (f32)height/2.0f - g_graphicsModule.UnitsToPixelsY(1.0f);
-    m_hitBox = { -fWidthDiv2, -fHeightDiv2, fWidthDiv2, fHeightDiv2 };
-    m_bCollidable = true;
-
-    m_animFrame = 0;
-    m_animElapsed = 0.0f;
-    m_pAnim = nullptr;
+    HitBox() = { -fWidthDiv2, -fHeightDiv2, fWidthDiv2, fHeightDiv2 };
+    Collidable() = true;
 
     m_renderMode = RENDER_MODE_DYNAMIC;
     m_zIndex = 0;
     m_bHUD = false;
     m_pTexture = pTexture;
+
+    SetCulled(true);
+}
+
+void Entity::SetPosition(const Vector2& vPosition)
+{
+    Position() = vPosition;
+    m_pStore->MarkMoved(m_storeIndex);
+    OnMove();
+}
+
+void Entity::SetHitBox(const FRect& hitBox)
+{
+    HitBox() = hitBox;
+    m_pStore->MarkMoved(m_storeIndex);
+    OnMove();
+}
+
+void Entity::SetCulled(b32 bCulled)
+{
+    static constexpr f32 UNCULLED_EXTENT = 1e30f;
+
+    FRect& drawBox = m_pStore->m_aDrawBox[m_storeIndex];
+    if (bCulled)
+    {
+        // Half diagonal, so rotated sprites fit too
+        f32 extent = std::sqrtf((f32)(m_width * m_width + m_height * m_height)) / 2.0f;
+        drawBox = { -extent, -extent, extent, extent };
+    }
+    else
+    {
+        drawBox = { -UNCULLED_EXTENT, -UNCULLED_EXTENT, UNCULLED_EXTENT, UNCULLED_EXTENT };
+    }
 }
 
 void Entity::Draw()
 {
+    const Vector2& vPosition = Position();
     SDL_Rect dstRect = {
-        (s32)(m_vPosition.x + 0.5f) - m_width/2, (s32)(m_vPosition.y+ 0.5f) - m_height/2,
+        (s32)(vPosition.x + 0.5f) - m_width/2, (s32)(vPosition.y+ 0.5f) - m_height/2,
         m_width, m_height
     };
 
-    if (m_pAnim)
+    const Animation* pAnim = Anim();
+    if (pAnim)
     {
-        g_graphicsModule.DrawFrame(m_renderMode, m_zIndex, m_bHUD, dstRect, m_pTexture, m_pAnim->row, m_animFrame, m_angle, m_flip);
+        g_graphicsModule.DrawFrame(m_renderMode, m_zIndex, m_bHUD, dstRect, m_pTexture, pAnim->row, AnimFrame(), m_angle, m_flip);
     }
     else
     {
-        g_graphicsModule.DrawFrame(m_renderMode, m_zIndex, m_bHUD, dstRect, m_pTexture, 0, m_animFrame, m_angle, m_flip);
+        g_graphicsModule.DrawFrame(m_renderMode, m_zIndex, m_bHUD, dstRect, m_pTexture, 0, AnimFrame(), m_angle, m_flip);
     }
 }
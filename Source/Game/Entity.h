@@ -2,6 +2,7 @@
 
 #include "Graphics/GraphicsModule.h"
 #include "Animation/AnimationModule.h"
+#include "Game/EntityStore.h"
 
 enum eEntityType
 {
@@ -17,28 +18,24 @@ class Entity
 protected:
     s32 m_type;
 
-public:
-    Vector2 m_vPosition;
-    Vector2 m_vVelocity;
+private:
+    /** Hot data lives in world's entity store */
+    EntityStore* m_pStore;
+    s32 m_storeIndex;
+
+    friend class EntityStore;
 
+public:
     s32 m_width;
     s32 m_height;
 
     f32 m_angle;
     SDL_RendererFlip m_flip;
 
-    /** Relative to entity position */
-    FRect m_hitBox;
-
-    s32 m_animFrame;
-    f32 m_animElapsed;
-    const Animation* m_pAnim;
-
     s32 m_renderMode;
     s32 m_zIndex;
     const Texture* m_pTexture;
 
-    b32 m_bCollidable : 1;
     b32 m_bHUD : 1;
 
 public:
@@ -48,7 +45,52 @@ public:
     virtual void Clean() {}
 
     virtual void Update(f32 dtTime) {}
+
+    /** Runs on job system before Update(), may only read the world and change entity itself */
+    virtual void Think() {}
+
+    /** ONCE animation reached its end, called before Think() */
+    virtual void OnAnimationEnd() {}
+
+    /** Position or hit box was set, passes don't call it */
+    virtual void OnMove() {}
     virtual void Draw();
 
     forceinline s32 GetType() const { return m_type; }
+    forceinline s32 GetStoreIndex() const { return m_storeIndex; }
+
+    /** Facade over entity store, references are valid until entity is added or removed */
+    forceinline Vector2& Position() { return m_pStore->m_aPosition[m_storeIndex]; }
+    forceinline const Vector2& Position() const { return m_pStore->m_aPosition[m_storeIndex]; }
+    forceinline Vector2& Velocity() { return m_pStore->m_aVelocity[m_storeIndex]; }
+    forceinline const Vector2& Velocity() const { return m_pStore->m_aVelocity[m_storeIndex]; }
+    forceinline Vector2& Acceleration() { return m_pStore->m_aAcceleration[m_storeIndex]; }
+    forceinline Vector2& MaxSpeed() { return m_pStore->m_aMaxSpeed[m_storeIndex]; }
+
+    /** Relative to entity position */
+    forceinline FRect& HitBox() { return m_pStore->m_aHitBox[m_storeIndex]; }
+    forceinline const FRect& HitBox() const { return m_pStore->m_aHitBox[m_storeIndex]; }
+
+    /** Box used for culling, relative to entity position */
+    forceinline const FRect& DrawBox() const { return m_pStore->m_aDrawBox[m_storeIndex]; }
+
+    forceinline s32& AnimFrame() { return m_pStore->m_aAnimFrame[m_storeIndex]; }
+    forceinline s32 AnimFrame() const { return m_pStore->m_aAnimFrame[m_storeIndex]; }
+    forceinline f32& AnimElapsed() { return m_pStore->m_aAnimElapsed[m_storeIndex]; }
+    forceinline f32 AnimElapsed() const { return m_pStore->m_aAnimElapsed[m_storeIndex]; }
+    forceinline const Animation*& Anim() { return m_pStore->m_apAnim[m_storeIndex]; }
+    forceinline const Animation* Anim() const { return m_pStore->m_apAnim[m_storeIndex]; }
+    forceinline u8& AnimMode() { return m_pStore->m_aAnimMode[m_storeIndex]; }
+
+    forceinline b32& Collidable() { return m_pStore->m_abCollidable[m_storeIndex]; }
+    forceinline b32 Collidable() const { return m_pStore->m_abCollidable[m_storeIndex]; }
+
+    forceinline void SetPasses(u32 passes) { m_pStore->m_aPasses[m_storeIndex] = passes; }
+
+    /** Teleports which triggers have to know about, main thread only */
+    void SetPosition(const Vector2& vPosition);
+    void SetHitBox(const FRect& hitBox);
+
+    /** Entities which aren't drawn around their position (HUD, dialogs) shouldn't be culled */
+    void SetCulled(b32 bCulled);
 };
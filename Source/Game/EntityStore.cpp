@@ -0,0 +1,438 @@
+#include "Engine/JobSystem.h"
+#include "Game/Entity.h"
+#include "Game/EntityStore.h"
+
+template<typename T>
+internal void GrowArray(T*& a, s32 count, s32 capacity)
+{
+    T* aNew = new T[capacity];
+    for (i32f i = 0; i < count; ++i)
+    {
+        aNew[i] = a[i];
+    }
+
+    delete[] a;
+    a = aNew;
+}
+
+internal s32 CompareIndex(const void* pA, const void* pB)
+{
+    return *(const s32*)pA - *(const s32*)pB;
+}
+
+internal s32 CompareStoreIndex(const void* pA, const void* pB)
+{
+    return (*(const Entity**)pA)->GetStoreIndex() - (*(const Entity**)pB)->GetStoreIndex();
+}
+
+internal s32 CompareDrawOrder(const void* pA, const void* pB)
+{
+    u64 a = *(const u64*)pA;
+    u64 b = *(const u64*)pB;
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+void EntityStore::StartUp()
+{
+    m_count = 0;
+    m_capacity = INITIAL_CAPACITY;
+
+    m_apOwner = new Entity*[m_capacity];
+
+    m_aPosition = new Vector2[m_capacity];
+    m_aVelocity = new Vector2[m_capacity];
+    m_aAcceleration = new Vector2[m_capacity];
+    m_aMaxSpeed = new Vector2[m_capacity];
+
+    m_aHitBox = new FRect[m_capacity];
+    m_aDrawBox = new FRect[m_capacity];
+
+    m_aAnimFrame = new s32[m_capacity];
+    m_aAnimElapsed = new f32[m_capacity];
+    m_apAnim = new const Animation*[m_capacity];
+    m_aAnimMode = new u8[m_capacity];
+    m_aAnimEnded = new s32[m_capacity];
+    SDL_AtomicSet(&m_animEndedCount, 0);
+
+    m_abCollidable = new b32[m_capacity];
+    m_aPasses = new u32[m_capacity];
+
+    m_aWatcher = new s32[m_capacity];
+    m_abMoved = new b32[m_capacity];
+    m_apMoved = new Entity*[m_capacity];
+    SDL_AtomicSet(&m_movedCount, 0);
+
+    m_aSpawnOrder = new u32[m_capacity];
+    m_spawnCounter = 0;
+
+    m_queryCount = Math::Max(g_jobSystem.GetWorkerCount(), 1);
+    m_apQuery = new s32*[m_queryCount];
+    for (i32f i = 0; i < m_queryCount; ++i)
+    {
+        m_apQuery[i] = new s32[m_capacity];
+    }
+    m_aDrawOrder = new u64[m_capacity];
+}
+
+void EntityStore::ShutDown()
+{
+    delete[] m_apOwner;
+    m_tabOwners.Clean();
+
+    delete[] m_aPosition;
+    delete[] m_aVelocity;
+    delete[] m_aAcceleration;
+    delete[] m_aMaxSpeed;
+
+    delete[] m_aHitBox;
+    delete[] m_aDrawBox;
+
+    delete[] m_aAnimFrame;
+    delete[] m_aAnimElapsed;
+    delete[] m_apAnim;
+    delete[] m_aAnimMode;
+    delete[] m_aAnimEnded;
+
+    delete[] m_abCollidable;
+    delete[] m_aPasses;
+    delete[] m_aWatcher;
+    delete[] m_abMoved;
+    delete[] m_apMoved;
+    delete[] m_aSpawnOrder;
+
+    for (i32f i = 0; i < m_queryCount; ++i)
+    {
+        delete[] m_apQuery[i];
+    }
+    delete[] m_apQuery;
+    m_queryCount = 0;
+    delete[] m_aDrawOrder;
+
+    m_count = 0;
+    m_capacity = 0;
+}
+
+s32 EntityStore::Allocate(Entity* pEntity)
+{
+    if (m_count >= m_capacity)
+    {
+        Grow();
+    }
+
+    s32 index = m_count++;
+
+    m_apOwner[index] = pEntity;
+    m_tabOwners.Insert(pEntity, index);
+
+    m_aPosition[index].Zero();
+    m_aVelocity[index].Zero();
+    m_aAcceleration[index].Zero();
+    m_aMaxSpeed[index].Zero();
+
+    m_aHitBox[index] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    m_aDrawBox[index] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    m_aAnimFrame[index] = 0;
+    m_aAnimElapsed[index] = 0.0f;
+    m_apAnim[index] = nullptr;
+    m_aAnimMode[index] = ANIMATION_MODE_LOOP;
+
+    m_abCollidable[index] = false;
+    m_aPasses[index] = ENTITY_PASS_NONE;
+    m_aWatcher[index] = -1;
+    m_abMoved[index] = false;
+    m_aSpawnOrder[index] = m_spawnCounter++;
+
+    return index;
+}
+
+void EntityStore::Free(s32 index)
+{
+    if (index < 0 || index >= m_count)
+    {
+        return;
+    }
+
+    m_tabOwners.Remove(m_apOwner[index]);
+
+    // Removed entity mustn't stay in moved list, it's short so just scan it
+    if (m_abMoved[index])
+    {
+        s32 movedCount = SDL_AtomicGet(&m_movedCount);
+        for (i32f i = 0; i < movedCount; ++i)
+        {
+            if (m_apMoved[i] == m_apOwner[index])
+            {
+                m_apMoved[i] = m_apMoved[--movedCount];
+                break;
+            }
+        }
+        SDL_AtomicSet(&m_movedCount, movedCount);
+    }
+
+    // Move last slot into the freed one
+    s32 last = --m_count;
+    if (index != last)
+    {
+        m_apOwner[index] = m_apOwner[last];
+        *m_tabOwners.Find(m_apOwner[index]) = index;
+
+        m_aPosition[index] = m_aPosition[last];
+        m_aVelocity[index] = m_aVelocity[last];
+        m_aAcceleration[index] = m_aAcceleration[last];
+        m_aMaxSpeed[index] = m_aMaxSpeed[last];
+
+        m_aHitBox[index] = m_aHitBox[last];
+        m_aDrawBox[index] = m_aDrawBox[last];
+
+        m_aAnimFrame[index] = m_aAnimFrame[last];
+        m_aAnimElapsed[index] = m_aAnimElapsed[last];
+        m_apAnim[index] = m_apAnim[last];
+        m_aAnimMode[index] = m_aAnimMode[last];
+
+        m_abCollidable[index] = m_abCollidable[last];
+        m_aPasses[index] = m_aPasses[last];
+        m_aWatcher[index] = m_aWatcher[last];
+        m_abMoved[index] = m_abMoved[last];
+        m_aSpawnOrder[index] = m_aSpawnOrder[last];
+
+        m_apOwner[index]->m_storeIndex = index;
+    }
+}
+
+void EntityStore::UpdateMotion(f32 dtTime)
+{
+    PassData data = { this, dtTime, {} };
+    g_jobSystem.ParallelFor(m_count, JOB_GRAIN, MotionJob, &data);
+}
+
+void EntityStore::UpdateThink()
+{
+    DispatchAnimationEnds();
+
+    PassData data = { this, 0.0f, {} };
+    g_jobSystem.ParallelFor(m_count, THINK_GRAIN, ThinkJob, &data);
+}
+
+void EntityStore::UpdateLogic(f32 dtTime)
+{
+    // Entities added by scripts during this pass are updated next frame,
+    // arrays may grow here so don't keep pointers into them
+    s32 count = m_count;
+    for (i32f i = 0; i < count; ++i)
+    {
+        if (m_aPasses[i] & ENTITY_PASS_LOGIC)
+        {
+            m_apOwner[i]->Update(dtTime);
+        }
+    }
+}
+
+void EntityStore::UpdateWalk(const SRect& ground)
+{
+    PassData data = { this, 0.0f, ground };
+    g_jobSystem.ParallelFor(m_count, JOB_GRAIN, WalkJob, &data);
+}
+
+void EntityStore::MarkMoved(s32 index)
+{
+    if (m_aWatcher[index] < 0 || m_abMoved[index])
+    {
+        return;
+    }
+
+    // Every slot is reported once, so list never gets longer than store
+    m_abMoved[index] = true;
+    m_apMoved[SDL_AtomicAdd(&m_movedCount, 1)] = m_apOwner[index];
+}
+
+s32 EntityStore::CollectMoved(Entity**& apMoved)
+{
+    s32 count = SDL_AtomicGet(&m_movedCount);
+    SDL_AtomicSet(&m_movedCount, 0);
+
+    for (i32f i = 0; i < count; ++i)
+    {
+        m_abMoved[m_apMoved[i]->GetStoreIndex()] = false;
+    }
+
+    // Jobs report in any order
+    std::qsort(m_apMoved, count, sizeof(Entity*), CompareStoreIndex);
+
+    apMoved = m_apMoved;
+    return count;
+}
+
+s32 EntityStore::Query(const FRect& rect)
+{
+    return Kernels::Overlap(m_aPosition, m_aHitBox, rect, m_apQuery[JobSystem::GetCurrentWorker()], m_count);
+}
+
+s32 EntityStore::QueryDrawable(const FRect& rect)
+{
+    s32* aQuery = m_apQuery[0];
+    s32 count = Kernels::Overlap(m_aPosition, m_aDrawBox, rect, aQuery, m_count);
+
+    // World list has newest entities first, sort by inverted spawn order to draw same way
+    for (i32f i = 0; i < count; ++i)
+    {
+        m_aDrawOrder[i] = ((u64)~m_aSpawnOrder[aQuery[i]] << 32) | (u64)aQuery[i];
+    }
+    std::qsort(m_aDrawOrder, count, sizeof(u64), CompareDrawOrder);
+
+    for (i32f i = 0; i < count; ++i)
+    {
+        aQuery[i] = (s32)(m_aDrawOrder[i] & 0xFFFFFFFF);
+    }
+
+    return count;
+}
+
+void EntityStore::Grow()
+{
+    s32 capacity = m_capacity * 2;
+
+    GrowArray(m_apOwner, m_count, capacity);
+
+    GrowArray(m_aPosition, m_count, capacity);
+    GrowArray(m_aVelocity, m_count, capacity);
+    GrowArray(m_aAcceleration, m_count, capacity);
+    GrowArray(m_aMaxSpeed, m_count, capacity);
+
+    GrowArray(m_aHitBox, m_count, capacity);
+    GrowArray(m_aDrawBox, m_count, capacity);
+
+    GrowArray(m_aAnimFrame, m_count, capacity);
+    GrowArray(m_aAnimElapsed, m_count, capacity);
+    GrowArray(m_apAnim, m_count, capacity);
+    GrowArray(m_aAnimMode, m_count, capacity);
+
+    // Ends may be dispatched while owners spawn entities
+    GrowArray(m_aAnimEnded, SDL_AtomicGet(&m_animEndedCount), capacity);
+
+    GrowArray(m_abCollidable, m_count, capacity);
+    GrowArray(m_aPasses, m_count, capacity);
+    GrowArray(m_aWatcher, m_count, capacity);
+    GrowArray(m_abMoved, m_count, capacity);
+    GrowArray(m_apMoved, SDL_AtomicGet(&m_movedCount), capacity);
+    GrowArray(m_aSpawnOrder, m_count, capacity);
+
+    // Query results are scratch, don't keep them
+    for (i32f i = 0; i < m_queryCount; ++i)
+    {
+        delete[] m_apQuery[i];
+        m_apQuery[i] = new s32[capacity];
+    }
+    delete[] m_aDrawOrder;
+    m_aDrawOrder = new u64[capacity];
+
+    m_capacity = capacity;
+}
+
+void EntityStore::MotionJob(void* pUserdata, s32 first, s32 last)
+{
+    PassData* pData = (PassData*)pUserdata;
+    pData->pStore->PassMotion(pData->dtTime, first, last);
+    pData->pStore->PassIntegrate(pData->dtTime, first, last);
+    pData->pStore->PassAnimate(pData->dtTime, first, last);
+}
+
+void EntityStore::ThinkJob(void* pUserdata, s32 first, s32 last)
+{
+    EntityStore* pStore = ((PassData*)pUserdata)->pStore;
+    for (i32f i = first; i < last; ++i)
+    {
+        if (pStore->m_aPasses[i] & ENTITY_PASS_THINK)
+        {
+            pStore->m_apOwner[i]->Think();
+        }
+    }
+}
+
+void EntityStore::WalkJob(void* pUserdata, s32 first, s32 last)
+{
+    PassData* pData = (PassData*)pUserdata;
+    pData->pStore->PassWalk(pData->ground, first, last);
+}
+
+void EntityStore::PassMotion(f32 dtTime, s32 first, s32 last)
+{
+    for (i32f i = first; i < last; ++i)
+    {
+        if (!(m_aPasses[i] & ENTITY_PASS_MOTION))
+        {
+            continue;
+        }
+
+        Vector2& vVelocity = m_aVelocity[i];
+        const Vector2& vAcceleration = m_aAcceleration[i];
+        const Vector2& vMaxSpeed = m_aMaxSpeed[i];
+
+        // Velocity
+        vVelocity += vAcceleration * dtTime;
+
+        // X
+        if (std::fabsf(vVelocity.x) > std::fabsf(vMaxSpeed.x))
+        {
+            vVelocity.x = vAcceleration.x < 0 ? -vMaxSpeed.x : vMaxSpeed.x;
+        }
+
+        // Y
+        if (std::fabsf(vVelocity.y) > std::fabsf(vMaxSpeed.y))
+        {
+            vVelocity.y = vAcceleration.y < 0 ? -vMaxSpeed.y : vMaxSpeed.y;
+        }
+    }
+}
+
+void EntityStore::PassIntegrate(f32 dtTime, s32 first, s32 last)
+{
+    Kernels::Integrate(&m_aPosition[first], &m_aVelocity[first], &m_aPasses[first], ENTITY_PASS_INTEGRATE, dtTime, last - first);
+    ReportMoved(first, last);
+}
+
+void EntityStore::PassAnimate(f32 dtTime, s32 first, s32 last)
+{
+    AnimationBatch batch = {
+        m_apAnim, m_aAnimFrame, m_aAnimElapsed, m_aAnimMode,
+        m_aPasses, ENTITY_PASS_ANIMATE,
+        m_aAnimEnded, &m_animEndedCount
+    };
+    g_animModule.Tick(dtTime, batch, first, last);
+}
+
+void EntityStore::DispatchAnimationEnds()
+{
+    s32 count = SDL_AtomicGet(&m_animEndedCount);
+    if (!count)
+    {
+        return;
+    }
+    std::qsort(m_aAnimEnded, count, sizeof(s32), CompareIndex);
+
+    // Owners may spawn entities and grow the list, so index it every time
+    for (i32f i = 0; i < count; ++i)
+    {
+        m_apOwner[m_aAnimEnded[i]]->OnAnimationEnd();
+    }
+
+    SDL_AtomicSet(&m_animEndedCount, 0);
+}
+
+void EntityStore::PassWalk(const SRect& ground, s32 first, s32 last)
+{
+    Kernels::Walk(&m_aPosition[first], &m_aVelocity[first], &m_aHitBox[first], &m_abCollidable[first],
+                  &m_aPasses[first], ENTITY_PASS_WALK, ground, last - first);
+    ReportMoved(first, last);
+}
+
+void EntityStore::ReportMoved(s32 first, s32 last)
+{
+    for (i32f i = first; i < last; ++i)
+    {
+        if (m_aWatcher[i] >= 0 && (m_aVelocity[i].x != 0.0f || m_aVelocity[i].y != 0.0f))
+        {
+            MarkMoved(i);
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Math/Math.h"
+#include "Math/Kernels.h"
+#include "Animation/AnimationModule.h"
+#include "Engine/JobSystem.h"
+#include "Containers/PointerTable.h"
+
+class Entity;
+
+/** Batched passes entity takes part in */
+enum eEntityPass
+{
+    ENTITY_PASS_NONE      = 0,
+    ENTITY_PASS_LOGIC     = 1 << 0, /** Virtual Update() */
+    ENTITY_PASS_MOTION    = 1 << 1, /** Velocity += acceleration, clamped by max speed */
+    ENTITY_PASS_INTEGRATE = 1 << 2, /** Position += velocity * dt */
+    ENTITY_PASS_ANIMATE   = 1 << 3, /** Animation advanced by AnimationModule::Tick() */
+    ENTITY_PASS_WALK      = 1 << 4, /** Position += velocity, kept on the ground */
+    ENTITY_PASS_THINK     = 1 << 5, /** Virtual Think() */
+};
+
+/**
+ * Structure of arrays with hot entity data, entity itself
+ * only keeps index here. Arrays are dense, removing swaps
+ * last slot into the freed one, so references into the store
+ * are invalidated when entities are added or removed
+ */
+class EntityStore
+{
+private:
+    static constexpr i32f INITIAL_CAPACITY = 1024;
+
+    /** Entities per job in parallel passes */
+    static constexpr i32f JOB_GRAIN = 2048;
+    static constexpr i32f THINK_GRAIN = 64;
+
+    struct PassData
+    {
+        EntityStore* pStore;
+        f32 dtTime;
+        SRect ground;
+    };
+
+private:
+    Entity** m_apOwner;
+
+    /** Slot of every owner, jobs check entities they keep without scanning the store */
+    TPointerTable<s32> m_tabOwners;
+
+    Vector2* m_aPosition;
+    Vector2* m_aVelocity;
+    Vector2* m_aAcceleration;
+    Vector2* m_aMaxSpeed;
+
+    /** Relative to entity position */
+    FRect* m_aHitBox;
+    FRect* m_aDrawBox;
+
+    s32* m_aAnimFrame;
+    f32* m_aAnimElapsed;
+    const Animation** m_apAnim;
+    u8* m_aAnimMode;
+
+    /** Filled by animation pass, owners are told before logic */
+    s32* m_aAnimEnded;
+    SDL_atomic_t m_animEndedCount;
+
+    b32* m_abCollidable;
+    u32* m_aPasses;
+
+    /** Watcher in TriggerSystem or -1, moves of watched entities are reported */
+    s32* m_aWatcher;
+    b32* m_abMoved;
+    Entity** m_apMoved;
+    SDL_atomic_t m_movedCount;
+
+    /** Grows with every allocation, keeps world list order for drawing */
+    u32* m_aSpawnOrder;
+    u32 m_spawnCounter;
+
+    /** Indices found by last Query() of every worker, so jobs may query at once */
+    s32** m_apQuery;
+    s32 m_queryCount;
+    u64* m_aDrawOrder;
+
+    s32 m_count;
+    s32 m_capacity;
+
+    friend class Entity;
+
+public:
+    void StartUp();
+    void ShutDown();
+
+    s32 Allocate(Entity* pEntity);
+    void Free(s32 index);
+    forceinline void Clean() { m_count = 0; m_tabOwners.Reset(); SDL_AtomicSet(&m_animEndedCount, 0); SDL_AtomicSet(&m_movedCount, 0); }
+
+    /** Motion, integration and animation, runs on job system */
+    void UpdateMotion(f32 dtTime);
+
+    /**
+     * OnAnimationEnd() on main thread, then virtual Think() on job system.
+     * Nothing moves while entities think, so they see the same frame
+     */
+    void UpdateThink();
+
+    /** Virtual Update() on main thread, here entities may call Lua and change the world */
+    void UpdateLogic(f32 dtTime);
+
+    /** Actor walk, runs on job system */
+    void UpdateWalk(const SRect& ground);
+
+    /** Finds entities which hitbox overlaps rect, result is valid until next query on this thread */
+    s32 Query(const FRect& rect);
+    forceinline Entity* GetQueryEntity(s32 i) const { return m_apOwner[m_apQuery[JobSystem::GetCurrentWorker()][i]]; }
+
+    /** Same for draw box, in world list order, so off-screen entities are never visited. Main thread only */
+    s32 QueryDrawable(const FRect& rect);
+
+    forceinline s32 GetCount() const { return m_count; }
+
+    /** True if entity has a slot, also for entities spawned this frame. Entity may be already deleted */
+    forceinline b32 HasOwner(const Entity* pEntity) const { return m_tabOwners.Find(pEntity) != nullptr; }
+
+    /** TriggerSystem stuff */
+    forceinline s32 GetWatcher(s32 index) const { return m_aWatcher[index]; }
+    forceinline void SetWatcher(s32 index, s32 watcher) { m_aWatcher[index] = watcher; }
+
+    /** Reports move of watched entity, jobs may report only their own slots */
+    void MarkMoved(s32 index);
+
+    /** Entities reported since last call, in store order. Valid until next MarkMoved() */
+    s32 CollectMoved(Entity**& apMoved);
+
+private:
+    void Grow();
+
+    static void MotionJob(void* pUserdata, s32 first, s32 last);
+    static void ThinkJob(void* pUserdata, s32 first, s32 last);
+    static void WalkJob(void* pUserdata, s32 first, s32 last);
+
+    /** Passes over [first, last) range, they touch only entity's own slots */
+    void PassMotion(f32 dtTime, s32 first, s32 last);
+    void PassIntegrate(f32 dtTime, s32 first, s32 last);
+    void PassAnimate(f32 dtTime, s32 first, s32 last);
+
+    /** Kernels don't tell what they moved, so every watched entity with velocity is reported */
+    void ReportMoved(s32 first, s32 last);
+
+    /** In store order, so it doesn't depend on how jobs were scheduled */
+    void DispatchAnimationEnds();
+    void PassWalk(const SRect& ground, s32 first, s32 last);
+};
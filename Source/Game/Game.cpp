@@ -4,12 +4,12 @@
 #include "Game/PauseState.h"
 #include "Game/Game.h"
 
-void Game::StartUp()
+void Game::StartUp(const char* scriptPath, s32 location)
 {
     m_bRunning = true;
 
     m_pCurrentState = nullptr;
-    m_lstState.Push(new PlayState(MAIN_MENU_PATH, 0));
+    m_lstState.Push(scriptPath ? new PlayState(scriptPath, location) : new PlayState(MAIN_MENU_PATH, 0));
 
     AddNote(PR_NOTE, "Module started");
 }
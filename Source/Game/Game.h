@@ -19,7 +19,8 @@ class Game final : public EngineModule
 public:
     Game() : EngineModule("Game", CHANNEL_GAME) {}
 
-    void StartUp();
+    /** Main menu is entered if there's no mission path */
+    void StartUp(const char* scriptPath, s32 location);
     void ShutDown();
 
     void Update(f32 dtTime);
@@ -12,6 +12,7 @@ b32 PauseState::OnEnter()
 void PauseState::OnExit()
 {
     g_scriptModule.ExitMission(m_pScript);
+    g_graphicsModule.SetPartialRedraw(false);
 }
 
 void PauseState::Render()
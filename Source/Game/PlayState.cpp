@@ -1,3 +1,4 @@
+#include "Graphics/Tilemap.h"
 #include "Sound/SoundModule.h"
 #include "Script/ScriptModule.h"
 #include "Engine/Console.h"
@@ -10,21 +11,29 @@ b32 PlayState::OnEnter()
     m_world.StartUp();
     m_pScript = g_scriptModule.EnterMission(m_scriptPath, m_loadLocation);
 
+    // Sounds of previous mission which this one didn't define
+    g_soundModule.PurgeResources();
+
     return m_pScript != nullptr;
 }
 
 void PlayState::OnExit()
 {
-    // Unload all resourses
+    // Unload all resourses, tilemap holds textures
+    g_tilemap.Unload();
+    g_tilemap.UndefineTilesets();
     g_graphicsModule.UndefineTextures();
     g_animModule.UndefineAnimations();
-    g_soundModule.UndefineResources();
+    g_soundModule.ReleaseResources();
 
     // Unload mission
     g_scriptModule.ExitMission(m_pScript);
 
     // Shut down world
     m_world.ShutDown();
+
+    // Next state decides by itself
+    g_graphicsModule.SetPartialRedraw(false);
 }
 
 void PlayState::Update(f32 dtTime)
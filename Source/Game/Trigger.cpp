@@ -1,6 +1,3 @@
-#include "Engine/CollisionManager.h"
-#include "Script/ScriptModule.h"
-#include "Containers/List.h"
 #include "Game/Game.h"
 #include "Game/Trigger.h"
 
@@ -8,34 +5,40 @@ void Trigger::Init(const Vector2& vPosition, s32 width, s32 height, const Textur
 {
     Entity::Init(vPosition, width, height, pTexture);
     m_type = ENTITY_TYPE_TRIGGER;
-    m_bCollidable = false;
+    Collidable() = false;
 
     std::memset(m_functionName, 0, TRIGGER_STRSIZE);
-    m_pAttached = nullptr;
+    std::memset(m_exitFunctionName, 0, TRIGGER_STRSIZE);
+
+    m_watchedCount = 0;
+    m_bRepeatable = false;
+    m_bFired = false;
+
+    m_rect = ComputeRect();
+    m_visitStamp = 0;
+    m_overlapStamp = 0;
+
+    g_game.GetWorld().GetTriggerSystem().Register(this);
 }
 
-void Trigger::Update(f32 dtTime)
+void Trigger::OnMove()
 {
-    if (!m_pAttached)
-    {
-        return;
-    }
+    // Overlaps are handled by TriggerSystem, here we only tell it where we are
+    g_game.GetWorld().GetTriggerSystem().Move(this, ComputeRect());
+}
 
-    // Get collided with trigger entities
-    TList<Entity*> lstEntity;
-    g_collisionMgr.CheckCollision(
-        m_vPosition,
-        m_hitBox,
-        [] (auto pEntity, auto pAttached) -> b32 { return pEntity == pAttached; },
-        m_pAttached,
-        lstEntity,
-        this
-    );
-
-    if (!lstEntity.IsEmpty())
+void Trigger::Attach(Entity* pEntity)
+{
+    if (pEntity)
     {
-        // Call trigger's function and remove
-        g_scriptModule.CallTrigger(g_game.GetScript(), m_functionName, this, m_pAttached);
-        g_game.GetWorld().RemoveEntity(this);
+        g_game.GetWorld().GetTriggerSystem().Watch(this, pEntity);
     }
 }
+
+FRect Trigger::ComputeRect() const
+{
+    return {
+        Position().x + HitBox().x1, Position().y + HitBox().y1,
+        Position().x + HitBox().x2, Position().y + HitBox().y2
+    };
+}
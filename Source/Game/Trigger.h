@@ -7,19 +7,41 @@ class Trigger final : public Entity
 {
 private:
     static constexpr i32f TRIGGER_STRSIZE = 32;
+    static constexpr i32f TRIGGER_MAX_WATCHED = 8;
 
 private:
     char m_functionName[TRIGGER_STRSIZE];
+    char m_exitFunctionName[TRIGGER_STRSIZE];
 
-public:
-    Entity* m_pAttached;
+    /** Entities that fire this trigger and whether they're inside */
+    Entity* m_apWatched[TRIGGER_MAX_WATCHED];
+    b8 m_abInside[TRIGGER_MAX_WATCHED];
+    s32 m_watchedCount;
+
+    b32 m_bRepeatable;
+    b32 m_bFired;
+
+    /** TriggerSystem stuff */
+    FRect m_rect;
+    SRect m_cells;
+    u32 m_visitStamp;
+    u32 m_overlapStamp;
+
+    friend class TriggerSystem;
 
 public:
     virtual void Init(const Vector2& vPosition, s32 width, s32 height, const Texture* pTexture) override;
-    virtual void Update(f32 dtTime) override;
+    virtual void OnMove() override;
     virtual void Draw() override {} /** No drawing */
 
     forceinline void SetFunctionName(const char* functionName) { std::strncpy(m_functionName, functionName, TRIGGER_STRSIZE); }
-    forceinline void Attach(Entity* pEntity) { m_pAttached = pEntity; }
-};
+    forceinline void SetExitFunctionName(const char* functionName) { std::strncpy(m_exitFunctionName, functionName, TRIGGER_STRSIZE); }
+    forceinline void SetRepeatable(b32 bRepeatable) { m_bRepeatable = bRepeatable; }
+
+    /** Attached entity is the first watched one */
+    void Attach(Entity* pEntity);
+    forceinline Entity* GetAttached() const { return m_watchedCount > 0 ? m_apWatched[0] : nullptr; }
 
+private:
+    FRect ComputeRect() const;
+};
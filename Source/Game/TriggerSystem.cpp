@@ -0,0 +1,348 @@
+#include "Script/ScriptModule.h"
+#include "Game/Game.h"
+#include "Game/Trigger.h"
+#include "Game/TriggerSystem.h"
+
+void TriggerSystem::StartUp(EntityStore* pStore)
+{
+    m_pStore = pStore;
+    m_stamp = 0;
+
+    m_apWatcher = new Watcher*[INITIAL_WATCHERS];
+    m_watcherCount = 0;
+    m_watcherCapacity = INITIAL_WATCHERS;
+}
+
+void TriggerSystem::ShutDown()
+{
+    Clean();
+
+    delete[] m_apWatcher;
+    m_watcherCapacity = 0;
+}
+
+void TriggerSystem::Update()
+{
+    // Check only watchers that moved or were touched
+    Entity** apMoved;
+    s32 count = m_pStore->CollectMoved(apMoved);
+    for (i32f i = 0; i < count; ++i)
+    {
+        Watcher* pWatcher = FindWatcher(apMoved[i]);
+        if (pWatcher)
+        {
+            HandleWatcher(pWatcher);
+        }
+    }
+
+    DispatchEvents();
+}
+
+void TriggerSystem::Register(Trigger* pTrigger)
+{
+    m_lstTrigger.Push(pTrigger);
+    InsertCells(pTrigger);
+}
+
+void TriggerSystem::Unregister(Trigger* pTrigger)
+{
+    RemoveCells(pTrigger);
+    m_lstTrigger.Remove(pTrigger);
+
+    // Forget about watched entities
+    for (i32f i = 0; i < pTrigger->m_watchedCount; ++i)
+    {
+        Watcher* pWatcher = FindWatcher(pTrigger->m_apWatched[i]);
+        if (pWatcher)
+        {
+            pWatcher->lstInside.Remove(pTrigger);
+            pWatcher->lstTrigger.Remove(pTrigger);
+            if (pWatcher->lstTrigger.IsEmpty())
+            {
+                RemoveWatcher(pWatcher);
+            }
+        }
+    }
+    pTrigger->m_watchedCount = 0;
+}
+
+void TriggerSystem::Move(Trigger* pTrigger, const FRect& rect)
+{
+    RemoveCells(pTrigger);
+    pTrigger->m_rect = rect;
+    InsertCells(pTrigger);
+
+    // Watchers have to be checked again
+    for (i32f i = 0; i < pTrigger->m_watchedCount; ++i)
+    {
+        m_pStore->MarkMoved(pTrigger->m_apWatched[i]->GetStoreIndex());
+    }
+}
+
+void TriggerSystem::Watch(Trigger* pTrigger, Entity* pEntity)
+{
+    // Check if we already watch it or there's no room
+    for (i32f i = 0; i < pTrigger->m_watchedCount; ++i)
+    {
+        if (pTrigger->m_apWatched[i] == pEntity)
+        {
+            return;
+        }
+    }
+
+    if (pTrigger->m_watchedCount >= Trigger::TRIGGER_MAX_WATCHED)
+    {
+        LogNote(CHANNEL_GAME, PR_WARNING, "TriggerSystem", "Trigger can't watch more than %d entities", Trigger::TRIGGER_MAX_WATCHED);
+        return;
+    }
+
+    pTrigger->m_apWatched[pTrigger->m_watchedCount] = pEntity;
+    pTrigger->m_abInside[pTrigger->m_watchedCount] = false;
+    ++pTrigger->m_watchedCount;
+
+    // Get watcher
+    Watcher* pWatcher = FindWatcher(pEntity);
+    if (!pWatcher)
+    {
+        pWatcher = AddWatcher(pEntity);
+    }
+
+    pWatcher->lstTrigger.Push(pTrigger);
+    m_pStore->MarkMoved(pEntity->GetStoreIndex());
+}
+
+void TriggerSystem::Unwatch(Entity* pEntity)
+{
+    Watcher* pWatcher = FindWatcher(pEntity);
+    if (!pWatcher)
+    {
+        return;
+    }
+
+    // Remove entity from every trigger that watches it
+    for (auto it = pWatcher->lstTrigger.Begin(); it; ++it)
+    {
+        Trigger* pTrigger = it->data;
+        for (i32f i = 0; i < pTrigger->m_watchedCount; ++i)
+        {
+            if (pTrigger->m_apWatched[i] == pEntity)
+            {
+                --pTrigger->m_watchedCount;
+                pTrigger->m_apWatched[i] = pTrigger->m_apWatched[pTrigger->m_watchedCount];
+                pTrigger->m_abInside[i] = pTrigger->m_abInside[pTrigger->m_watchedCount];
+                break;
+            }
+        }
+    }
+
+    RemoveWatcher(pWatcher);
+}
+
+void TriggerSystem::Clean()
+{
+    for (i32f i = 0; i < GRID_BUCKETS; ++i)
+    {
+        m_aGrid[i].Clean();
+    }
+    m_lstTrigger.Clean();
+
+    // Entities are gone already, store doesn't need to know
+    for (i32f i = 0; i < m_watcherCount; ++i)
+    {
+        delete m_apWatcher[i];
+    }
+    m_watcherCount = 0;
+
+    m_lstEvent.Clean();
+}
+
+void TriggerSystem::InsertCells(Trigger* pTrigger)
+{
+    const FRect& rect = pTrigger->m_rect;
+    pTrigger->m_cells = { Cell(rect.x1), Cell(rect.y1), Cell(rect.x2), Cell(rect.y2) };
+
+    for (s32 y = pTrigger->m_cells.y1; y <= pTrigger->m_cells.y2; ++y)
+    {
+        for (s32 x = pTrigger->m_cells.x1; x <= pTrigger->m_cells.x2; ++x)
+        {
+            TList<Trigger*>& lstBucket = m_aGrid[Bucket(x, y)];
+            if (!lstBucket.IsMember(pTrigger))
+            {
+                lstBucket.Push(pTrigger);
+            }
+        }
+    }
+}
+
+void TriggerSystem::RemoveCells(Trigger* pTrigger)
+{
+    for (s32 y = pTrigger->m_cells.y1; y <= pTrigger->m_cells.y2; ++y)
+    {
+        for (s32 x = pTrigger->m_cells.x1; x <= pTrigger->m_cells.x2; ++x)
+        {
+            m_aGrid[Bucket(x, y)].Remove(pTrigger);
+        }
+    }
+}
+
+void TriggerSystem::HandleWatcher(Watcher* pWatcher)
+{
+    Entity* pEntity = pWatcher->pEntity;
+
+    ++m_stamp;
+
+    // Non-collidable entities don't fire triggers
+    if (pEntity->Collidable())
+    {
+        FRect rect = {
+            pEntity->Position().x + pEntity->HitBox().x1, pEntity->Position().y + pEntity->HitBox().y1,
+            pEntity->Position().x + pEntity->HitBox().x2, pEntity->Position().y + pEntity->HitBox().y2
+        };
+
+        // Find triggers in cells that entity overlaps
+        s32 cellX2 = Cell(rect.x2), cellY2 = Cell(rect.y2);
+        for (s32 y = Cell(rect.y1); y <= cellY2; ++y)
+        {
+            for (s32 x = Cell(rect.x1); x <= cellX2; ++x)
+            {
+                for (auto it = m_aGrid[Bucket(x, y)].Begin(); it; ++it)
+                {
+                    Trigger* pTrigger = it->data;
+                    if (pTrigger->m_visitStamp == m_stamp)
+                    {
+                        continue;
+                    }
+                    pTrigger->m_visitStamp = m_stamp;
+
+                    // Check collision
+                    const FRect& triggerRect = pTrigger->m_rect;
+                    if (rect.x1 > triggerRect.x2) continue;
+                    if (rect.x2 < triggerRect.x1) continue;
+                    if (rect.y1 > triggerRect.y2) continue;
+                    if (rect.y2 < triggerRect.y1) continue;
+
+                    // Check if trigger watches this entity
+                    for (i32f i = 0; i < pTrigger->m_watchedCount; ++i)
+                    {
+                        if (pTrigger->m_apWatched[i] != pEntity)
+                        {
+                            continue;
+                        }
+
+                        pTrigger->m_overlapStamp = m_stamp;
+                        if (!pTrigger->m_abInside[i])
+                        {
+                            pTrigger->m_abInside[i] = true;
+                            pWatcher->lstInside.Push(pTrigger);
+                            m_lstEvent.PushBack({ pTrigger, pEntity, true });
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Triggers that we've been inside and don't overlap now
+    for (auto it = pWatcher->lstInside.Begin(); it; )
+    {
+        Trigger* pTrigger = it->data;
+        ++it;
+
+        if (pTrigger->m_overlapStamp == m_stamp)
+        {
+            continue;
+        }
+
+        for (i32f i = 0; i < pTrigger->m_watchedCount; ++i)
+        {
+            if (pTrigger->m_apWatched[i] == pEntity)
+            {
+                pTrigger->m_abInside[i] = false;
+                break;
+            }
+        }
+
+        pWatcher->lstInside.Remove(pTrigger);
+        m_lstEvent.PushBack({ pTrigger, pEntity, false });
+    }
+}
+
+void TriggerSystem::DispatchEvents()
+{
+    // Move events out, so scripts may add triggers while we call them
+    while (!m_lstEvent.IsEmpty())
+    {
+        Event event = m_lstEvent.Front();
+        m_lstEvent.Pop();
+
+        Trigger* pTrigger = event.pTrigger;
+        if (pTrigger->m_bFired)
+        {
+            continue;
+        }
+
+        if (event.bEnter)
+        {
+            if (pTrigger->m_functionName[0])
+            {
+                g_scriptModule.CallTrigger(g_game.GetScript(), pTrigger->m_functionName, pTrigger, event.pEntity);
+            }
+
+            // One-shot triggers are removed after first enter
+            if (!pTrigger->m_bRepeatable)
+            {
+                pTrigger->m_bFired = true;
+                g_game.GetWorld().RemoveEntity(pTrigger);
+            }
+        }
+        else if (pTrigger->m_exitFunctionName[0])
+        {
+            g_scriptModule.CallTrigger(g_game.GetScript(), pTrigger->m_exitFunctionName, pTrigger, event.pEntity);
+        }
+    }
+}
+
+TriggerSystem::Watcher* TriggerSystem::FindWatcher(const Entity* pEntity)
+{
+    s32 slot = m_pStore->GetWatcher(pEntity->GetStoreIndex());
+    return slot >= 0 ? m_apWatcher[slot] : nullptr;
+}
+
+TriggerSystem::Watcher* TriggerSystem::AddWatcher(Entity* pEntity)
+{
+    // Grow if we need
+    if (m_watcherCount >= m_watcherCapacity)
+    {
+        Watcher** apWatcher = new Watcher*[m_watcherCapacity * 2];
+        std::memcpy(apWatcher, m_apWatcher, m_watcherCount * sizeof(Watcher*));
+        delete[] m_apWatcher;
+
+        m_apWatcher = apWatcher;
+        m_watcherCapacity *= 2;
+    }
+
+    Watcher* pWatcher = new Watcher();
+    pWatcher->pEntity = pEntity;
+    pWatcher->slot = m_watcherCount++;
+    m_apWatcher[pWatcher->slot] = pWatcher;
+    m_pStore->SetWatcher(pEntity->GetStoreIndex(), pWatcher->slot);
+
+    return pWatcher;
+}
+
+void TriggerSystem::RemoveWatcher(Watcher* pWatcher)
+{
+    m_pStore->SetWatcher(pWatcher->pEntity->GetStoreIndex(), -1);
+
+    // Move last watcher into the freed slot
+    Watcher* pLast = m_apWatcher[--m_watcherCount];
+    if (pLast != pWatcher)
+    {
+        pLast->slot = pWatcher->slot;
+        m_apWatcher[pLast->slot] = pLast;
+        m_pStore->SetWatcher(pLast->pEntity->GetStoreIndex(), pLast->slot);
+    }
+
+    delete pWatcher;
+}
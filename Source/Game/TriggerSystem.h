@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Math/Math.h"
+#include "Containers/List.h"
+
+class Entity;
+class EntityStore;
+class Trigger;
+
+/**
+ * Fires trigger enter/exit events for watched entities.
+ * Trigger volumes are hashed into grid cells, watched entities
+ * are checked only when entity store reports that they or
+ * trigger volumes have moved
+ */
+class TriggerSystem
+{
+    static constexpr i32f GRID_BUCKETS = 256;
+    static constexpr f32 GRID_CELL_SIZE = 64.0f;
+    static constexpr i32f INITIAL_WATCHERS = 16;
+
+    struct Watcher
+    {
+        Entity* pEntity;
+
+        /** In m_apWatcher, entity store keeps it for entity's slot */
+        s32 slot;
+
+        TList<Trigger*> lstTrigger;
+        TList<Trigger*> lstInside;
+    };
+
+    struct Event
+    {
+        Trigger* pTrigger;
+        Entity* pEntity;
+        b32 bEnter;
+    };
+
+    TList<Trigger*> m_aGrid[GRID_BUCKETS];
+    TList<Trigger*> m_lstTrigger;
+    TList<Event> m_lstEvent;
+
+    /** Dense, removing swaps last watcher into the freed slot */
+    Watcher** m_apWatcher;
+    s32 m_watcherCount;
+    s32 m_watcherCapacity;
+
+    EntityStore* m_pStore;
+
+    u32 m_stamp;
+
+public:
+    void StartUp(EntityStore* pStore);
+    void ShutDown();
+
+    /** Dispatch enter/exit events, call after entities moved */
+    void Update();
+
+    void Register(Trigger* pTrigger);
+    void Unregister(Trigger* pTrigger);
+    void Move(Trigger* pTrigger, const FRect& rect);
+
+    void Watch(Trigger* pTrigger, Entity* pEntity);
+    void Unwatch(Entity* pEntity);
+
+    void Clean();
+
+private:
+    void InsertCells(Trigger* pTrigger);
+    void RemoveCells(Trigger* pTrigger);
+    void HandleWatcher(Watcher* pWatcher);
+    void DispatchEvents();
+
+    Watcher* FindWatcher(const Entity* pEntity);
+    Watcher* AddWatcher(Entity* pEntity);
+    void RemoveWatcher(Watcher* pWatcher);
+
+    forceinline static s32 Cell(f32 coord) { return (s32)std::floor(coord / GRID_CELL_SIZE); }
+    forceinline static i32f Bucket(s32 x, s32 y) { return (i32f)(((u32)x * 73856093u) ^ ((u32)y * 19349663u)) & (GRID_BUCKETS - 1); }
+};
@@ -24,3 +24,10 @@ void Weapon::PlaySound(i32f index) const
     }
 }
 
+void Weapon::PlaySoundAt(const Vector2& vPosition) const
+{
+    if (m_soundPack.GetCount() > 0)
+    {
+        m_soundPack.PlayAt(std::rand() % m_soundPack.GetCount(), vPosition);
+    }
+}
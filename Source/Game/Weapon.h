@@ -32,4 +32,7 @@ public:
 
     void PlaySound() const;
     void PlaySound(i32f index) const;
+
+    /** Random sound of pack, attenuated by distance from camera */
+    void PlaySoundAt(const Vector2& vPosition) const;
 };
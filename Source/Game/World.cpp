@@ -1,7 +1,11 @@
 #include "Graphics/GraphicsModule.h"
+#include "Graphics/Tilemap.h"
 #include "Script/ScriptModule.h"
+#include "Script/ScriptScheduler.h"
 #include "Game/Actor.h"
 #include "Game/Weapon.h"
+#include "Game/Trigger.h"
+#include "Game/Car.h"
 #include "Game/Game.h"
 #include "Game/World.h"
 
@@ -18,16 +22,27 @@ static constexpr i32f GROUND_BOUNDS_DEFAULT_Y1 = 0;
 #define GROUND_BOUNDS_DEFAULT_X2 (g_graphicsModule.GetScreenWidth() - 1)
 #define GROUND_BOUNDS_DEFAULT_Y2 (g_graphicsModule.GetScreenHeight() - 1)
 
+/** Pixels around camera where entities are still drawn */
+static constexpr f32 CULL_MARGIN = 64.0f;
+
+/** Milliseconds */
+static constexpr s32 LOCATION_MUSIC_FADE_TIME = 1000;
+
 void World::StartUp()
 {
     m_groundBounds = { GROUND_BOUNDS_DEFAULT_X1, GROUND_BOUNDS_DEFAULT_Y1,
                        GROUND_BOUNDS_DEFAULT_X2, GROUND_BOUNDS_DEFAULT_Y2 };
     m_switchLocation = -1;
+    m_updateTime = 0.0f;
 
     g_graphicsModule.GetCamera().SetBounds({ CAMERA_BOUNDS_DEFAULT_X1, CAMERA_BOUNDS_DEFAULT_Y1,
                                              CAMERA_BOUNDS_DEFAULT_X2, CAMERA_BOUNDS_DEFAULT_Y2 });
     g_graphicsModule.GetCamera().SetPosition(CAMERA_DEFAULT_X, CAMERA_DEFAULT_Y);
 
+    m_entityStore.StartUp();
+    m_commands.StartUp();
+    m_triggerSystem.StartUp(&m_entityStore);
+
     AddNote(PR_NOTE, "World started");
 }
 
@@ -35,6 +50,9 @@ void World::ShutDown()
 {
     CleanEntities();
     CleanWeapons();
+    m_triggerSystem.ShutDown();
+    m_commands.ShutDown();
+    m_entityStore.ShutDown();
 
     AddNote(PR_NOTE, "World shut down");
 }
@@ -43,9 +61,32 @@ void World::Update(f32 dtTime)
 {
     HandleSwitchLocation();
     UpdateEntities(dtTime);
+    m_triggerSystem.Update();
+    ApplyCommands();
     RemoveEntities();
 }
 
+void World::Render()
+{
+    s32 cameraX, cameraY;
+    g_graphicsModule.GetCamera().GetPosition(cameraX, cameraY);
+
+    FRect view = {
+        (f32)cameraX - CULL_MARGIN, (f32)cameraY - CULL_MARGIN,
+        (f32)(cameraX + g_graphicsModule.GetScreenWidth()) + CULL_MARGIN,
+        (f32)(cameraY + g_graphicsModule.GetScreenHeight()) + CULL_MARGIN
+    };
+
+    g_tilemap.Draw();
+
+    s32 count = m_entityStore.QueryDrawable(view);
+    g_graphicsModule.CountCulled(m_entityStore.GetCount() - count);
+    for (i32f i = 0; i < count; ++i)
+    {
+        m_entityStore.GetQueryEntity(i)->Draw();
+    }
+}
+
 void World::HandleSwitchLocation()
 {
     // Check if we don't need to switch location
@@ -54,8 +95,9 @@ void World::HandleSwitchLocation()
         return;
     }
 
-    // Stop sounds and music
-    g_soundModule.StopSoundsAndMusic();
+    // Stop sounds, music of next location crosses with this one
+    g_soundModule.StopSounds();
+    g_soundModule.FadeOutMusic(LOCATION_MUSIC_FADE_TIME);
 
     // Clean current location stuff
     CleanEntities();
@@ -75,9 +117,77 @@ void World::HandleSwitchLocation()
 
 void World::UpdateEntities(f32 dtTime)
 {
-    for (auto it = m_lstEntity.Begin(); it; ++it)
+    u64 start = SDL_GetPerformanceCounter();
+
+    // Move and animate in parallel before logic, so cars carry passengers to their new place
+    m_entityStore.UpdateMotion(dtTime);
+
+    // Actors evaluate AI tasks in parallel against this frame
+    m_entityStore.UpdateThink();
+
+    // Serial phase, entities call scripts and change the world. Actors only set their velocity here
+    m_entityStore.UpdateLogic(dtTime);
+
+    // Walk actors in parallel
+    m_entityStore.UpdateWalk(m_groundBounds);
+
+    m_updateTime = (f32)((SDL_GetPerformanceCounter() - start) * 1000) / (f32)SDL_GetPerformanceFrequency();
+}
+
+void World::ApplyCommands()
+{
+    // Sync point, commands come sorted so order doesn't depend on workers
+    WorldCommand* aCommands;
+    s32 count = m_commands.Collect(aCommands);
+
+    for (i32f i = 0; i < count; ++i)
     {
-        it->data->Update(dtTime);
+        const WorldCommand& command = aCommands[i];
+
+        switch (command.type)
+        {
+            case WORLD_COMMAND_SPAWN:
+            {
+                m_lstEntity.Push(command.pEntity);
+            } break;
+
+            case WORLD_COMMAND_REMOVE:
+            {
+                // Don't delete twice if removed more than once
+                if (!m_lstRemove.IsMember(command.pEntity))
+                {
+                    m_lstRemove.Push(command.pEntity);
+                }
+            } break;
+
+            case WORLD_COMMAND_DAMAGE:
+            {
+                static_cast<Actor*>(command.pEntity)->AddHealth(-command.value);
+            } break;
+
+            case WORLD_COMMAND_STATE:
+            {
+                static_cast<Actor*>(command.pEntity)->SetActorState(command.param);
+            } break;
+
+            case WORLD_COMMAND_REPARENT:
+            {
+                Car* pCar = static_cast<Car*>(command.pEntity);
+                if (command.pTarget)
+                {
+                    pCar->PutActor(static_cast<Actor*>(command.pTarget), command.param);
+                }
+                else
+                {
+                    pCar->EjectActor(command.param);
+                }
+            } break;
+
+            default:
+            {
+                AddNote(PR_WARNING, "Unknown world command %d", command.type);
+            } break;
+        }
     }
 }
 
@@ -88,7 +198,16 @@ void World::RemoveEntities()
         // Remove from entity list
         m_lstEntity.Remove(it->data);
 
-        // Free memory
+        // Wake waiting scripts and forget about triggers
+        g_scriptModule.SignalEvent(it->data, SCRIPT_EVENT_REMOVED);
+        m_triggerSystem.Unwatch(it->data);
+        if (it->data->GetType() == ENTITY_TYPE_TRIGGER)
+        {
+            m_triggerSystem.Unregister(static_cast<Trigger*>(it->data));
+        }
+
+        // Free store slot and memory
+        m_entityStore.Free(it->data->GetStoreIndex());
         it->data->Clean();
         delete it->data;
     }
@@ -99,13 +218,27 @@ void World::RemoveEntities()
 
 void World::CleanEntities()
 {
+    // Entities spawned this frame are only in commands yet, others don't matter anymore
+    WorldCommand* aCommands;
+    s32 count = m_commands.Collect(aCommands);
+    for (i32f i = 0; i < count; ++i)
+    {
+        if (aCommands[i].type == WORLD_COMMAND_SPAWN)
+        {
+            m_lstEntity.Push(aCommands[i].pEntity);
+        }
+    }
+
     m_lstEntity.Foreach([] (auto pEntity)
     {
+        g_scriptModule.SignalEvent(pEntity, SCRIPT_EVENT_REMOVED);
         pEntity->Clean();
         delete pEntity;
     });
     m_lstEntity.Clean();
     m_lstRemove.Clean();
+    m_entityStore.Clean();
+    m_triggerSystem.Clean();
 }
 
 void World::CleanWeapons()
@@ -2,6 +2,9 @@
 
 #include "Engine/EngineModule.h"
 #include "Game/Entity.h"
+#include "Game/EntityStore.h"
+#include "Game/TriggerSystem.h"
+#include "Game/WorldCommands.h"
 #include "Containers/List.h"
 
 class Weapon;
@@ -12,9 +15,16 @@ class World final : EngineModule
     TList<Entity*> m_lstRemove;
     TList<Weapon*> m_lstWeapon;
 
+    EntityStore m_entityStore;
+    WorldCommands m_commands;
+    TriggerSystem m_triggerSystem;
+
     SRect m_groundBounds;
     s32 m_switchLocation;
 
+    /** Milliseconds spent in last UpdateEntities() */
+    f32 m_updateTime;
+
 public:
     World() : EngineModule("World", CHANNEL_GAME) {}
 
@@ -22,7 +32,8 @@ public:
     void ShutDown();
 
     void Update(f32 dtTime);
-    forceinline void Render() { m_lstEntity.Foreach([] (auto pEntity) { pEntity->Draw(); }); }
+    /** Draws only entities around camera */
+    void Render();
 
     forceinline void SwitchLocation(s32 location) { m_switchLocation = location; }
     forceinline void SetGroundBounds(SRect& rect) { m_groundBounds = rect; }
@@ -33,12 +44,17 @@ public:
 
     forceinline const SRect& GetGroundBounds() const { return m_groundBounds; }
     forceinline TList<Entity*>& GetEntityList() { return m_lstEntity; }
+    forceinline EntityStore& GetEntityStore() { return m_entityStore; }
+    forceinline TriggerSystem& GetTriggerSystem() { return m_triggerSystem; }
+    forceinline WorldCommands& GetCommands() { return m_commands; }
+    forceinline f32 GetUpdateTime() const { return m_updateTime; }
 
-    forceinline b32 HasEntity(Entity* pEntity) const { return pEntity ? m_lstEntity.IsMember(pEntity) : false; }
+    forceinline b32 HasEntity(Entity* pEntity) const { return pEntity ? m_entityStore.HasOwner(pEntity) : false; }
 
 private:
     void HandleSwitchLocation();
     void UpdateEntities(f32 dtTime);
+    void ApplyCommands();
     void RemoveEntities();
 
     void CleanEntities();
@@ -49,7 +65,7 @@ forceinline void World::PushEntity(Entity* pEntity)
 {
     if (pEntity)
     {
-        m_lstEntity.Push(pEntity);
+        m_commands.Spawn(pEntity);
     }
 }
 
@@ -57,7 +73,7 @@ forceinline void World::RemoveEntity(Entity* pEntity)
 {
     if (pEntity)
     {
-        m_lstRemove.Push(pEntity);
+        m_commands.Remove(pEntity);
     }
 }
 
@@ -0,0 +1,170 @@
+#include "Math/Math.h"
+#include "Engine/JobSystem.h"
+#include "Game/Actor.h"
+#include "Game/Car.h"
+#include "Game/WorldCommands.h"
+
+internal s32 CompareCommands(const void* pA, const void* pB)
+{
+    const WorldCommand* a = (const WorldCommand*)pA;
+    const WorldCommand* b = (const WorldCommand*)pB;
+
+    if (a->order != b->order)
+    {
+        return a->order < b->order ? -1 : 1;
+    }
+    if (a->buffer != b->buffer)
+    {
+        return a->buffer < b->buffer ? -1 : 1;
+    }
+    if (a->sequence != b->sequence)
+    {
+        return a->sequence < b->sequence ? -1 : 1;
+    }
+    return 0;
+}
+
+void WorldCommands::StartUp()
+{
+    m_bufferCount = Math::Max(g_jobSystem.GetWorkerCount(), 1);
+    m_aBuffers = new Buffer[m_bufferCount];
+
+    for (i32f i = 0; i < m_bufferCount; ++i)
+    {
+        m_aBuffers[i].aCommands = new WorldCommand[INITIAL_CAPACITY];
+        m_aBuffers[i].count = 0;
+        m_aBuffers[i].capacity = INITIAL_CAPACITY;
+        m_aBuffers[i].sequence = 0;
+    }
+
+    m_aSorted = new WorldCommand[INITIAL_CAPACITY];
+    m_sortedCapacity = INITIAL_CAPACITY;
+}
+
+void WorldCommands::ShutDown()
+{
+    for (i32f i = 0; i < m_bufferCount; ++i)
+    {
+        delete[] m_aBuffers[i].aCommands;
+    }
+    delete[] m_aBuffers;
+    m_bufferCount = 0;
+
+    delete[] m_aSorted;
+    m_sortedCapacity = 0;
+}
+
+void WorldCommands::Spawn(Entity* pEntity)
+{
+    Push(nullptr, WORLD_COMMAND_SPAWN, pEntity, nullptr, 0.0f, 0);
+}
+
+void WorldCommands::Remove(Entity* pEntity)
+{
+    Push(nullptr, WORLD_COMMAND_REMOVE, pEntity, nullptr, 0.0f, 0);
+}
+
+void WorldCommands::Damage(const Entity* pIssuer, Actor* pActor, f32 damage)
+{
+    Push(pIssuer, WORLD_COMMAND_DAMAGE, pActor, nullptr, damage, 0);
+}
+
+void WorldCommands::SetState(const Entity* pIssuer, Actor* pActor, s32 state)
+{
+    if (!JobSystem::IsInJob())
+    {
+        pActor->SetActorState(state);
+        return;
+    }
+
+    Push(pIssuer, WORLD_COMMAND_STATE, pActor, nullptr, 0.0f, state);
+}
+
+void WorldCommands::Reparent(const Entity* pIssuer, Actor* pActor, Car* pCar, s32 place)
+{
+    if (!JobSystem::IsInJob())
+    {
+        if (pActor)
+        {
+            pCar->PutActor(pActor, place);
+        }
+        else
+        {
+            pCar->EjectActor(place);
+        }
+        return;
+    }
+
+    Push(pIssuer, WORLD_COMMAND_REPARENT, pCar, pActor, 0.0f, place);
+}
+
+s32 WorldCommands::Collect(WorldCommand*& aCommands)
+{
+    // Count commands and get enough room
+    s32 count = 0;
+    for (i32f i = 0; i < m_bufferCount; ++i)
+    {
+        count += m_aBuffers[i].count;
+    }
+
+    if (count > m_sortedCapacity)
+    {
+        while (count > m_sortedCapacity)
+        {
+            m_sortedCapacity *= 2;
+        }
+
+        delete[] m_aSorted;
+        m_aSorted = new WorldCommand[m_sortedCapacity];
+    }
+
+    // Merge and sort
+    s32 sorted = 0;
+    for (i32f i = 0; i < m_bufferCount; ++i)
+    {
+        std::memcpy(&m_aSorted[sorted], m_aBuffers[i].aCommands, m_aBuffers[i].count * sizeof(WorldCommand));
+        sorted += m_aBuffers[i].count;
+    }
+    std::qsort(m_aSorted, count, sizeof(WorldCommand), CompareCommands);
+
+    Clean();
+
+    aCommands = m_aSorted;
+    return count;
+}
+
+void WorldCommands::Clean()
+{
+    for (i32f i = 0; i < m_bufferCount; ++i)
+    {
+        m_aBuffers[i].count = 0;
+        m_aBuffers[i].sequence = 0;
+    }
+}
+
+void WorldCommands::Push(const Entity* pIssuer, s32 type, Entity* pEntity, Entity* pTarget, f32 value, s32 param)
+{
+    s32 bufferIndex = JobSystem::GetCurrentWorker() % m_bufferCount;
+    Buffer& buffer = m_aBuffers[bufferIndex];
+
+    // Grow if we need
+    if (buffer.count >= buffer.capacity)
+    {
+        WorldCommand* aCommands = new WorldCommand[buffer.capacity * 2];
+        std::memcpy(aCommands, buffer.aCommands, buffer.count * sizeof(WorldCommand));
+        delete[] buffer.aCommands;
+
+        buffer.aCommands = aCommands;
+        buffer.capacity *= 2;
+    }
+
+    WorldCommand& command = buffer.aCommands[buffer.count++];
+    command.type = type;
+    command.order = pIssuer ? pIssuer->GetStoreIndex() + 1 : 0;
+    command.buffer = bufferIndex;
+    command.sequence = buffer.sequence++;
+    command.pEntity = pEntity;
+    command.pTarget = pTarget;
+    command.value = value;
+    command.param = param;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+class Entity;
+class Actor;
+class Car;
+
+enum eWorldCommand
+{
+    WORLD_COMMAND_SPAWN = 0,
+    WORLD_COMMAND_REMOVE,
+    WORLD_COMMAND_DAMAGE,
+    WORLD_COMMAND_STATE,
+    WORLD_COMMAND_REPARENT,
+};
+
+struct WorldCommand
+{
+    s32 type;
+
+    /** Sort keys: issuer's store index + 1 or 0 without issuer, then buffer and issue order in it */
+    s32 order;
+    s32 buffer;
+    s32 sequence;
+
+    Entity* pEntity;
+    Entity* pTarget;
+    f32 value;
+    s32 param;
+};
+
+/**
+ * Deferred world mutations. Every worker writes into its own
+ * buffer, world applies commands at sync point sorted by issuer and
+ * issue order, so result doesn't depend on threads timing. Jobs
+ * should always pass issuer, commands without it go first
+ */
+class WorldCommands
+{
+private:
+    static constexpr i32f INITIAL_CAPACITY = 256;
+
+    struct Buffer
+    {
+        WorldCommand* aCommands;
+        s32 count;
+        s32 capacity;
+        s32 sequence;
+    };
+
+private:
+    Buffer* m_aBuffers;
+    s32 m_bufferCount;
+
+    /** Merged commands of all buffers */
+    WorldCommand* m_aSorted;
+    s32 m_sortedCapacity;
+
+public:
+    void StartUp();
+    void ShutDown();
+
+    void Spawn(Entity* pEntity);
+    void Remove(Entity* pEntity);
+    void Damage(const Entity* pIssuer, Actor* pActor, f32 damage);
+
+    /** Same as Actor::SetActorState(), which may signal scripts, so jobs defer it */
+    void SetState(const Entity* pIssuer, Actor* pActor, s32 state);
+
+    /**
+     * Puts actor in car's place, null actor ejects the one sitting there.
+     * Outside of jobs it's done right away, so scripts see the result
+     */
+    void Reparent(const Entity* pIssuer, Actor* pActor, Car* pCar, s32 place);
+
+    /** Merges and sorts buffers, then cleans them. Result is valid until next Collect() */
+    s32 Collect(WorldCommand*& aCommands);
+    void Clean();
+
+private:
+    void Push(const Entity* pIssuer, s32 type, Entity* pEntity, Entity* pTarget, f32 value, s32 param);
+};
@@ -22,7 +22,7 @@ void Camera::GetPosition(s32& x, s32& y)
 
     if (m_pAttached)
     {
-        const Vector2& vPosition = m_pAttached->m_vPosition;
+        const Vector2& vPosition = m_pAttached->Position();
 
         x = (s32)(vPosition.x + 0.5f) - g_graphicsModule.GetScreenWidth() / 2;
         if (x < m_bounds.x1)
@@ -4,10 +4,39 @@
 #include "Graphics/RenderElement.h"
 #include "Graphics/Texture.h"
 #include "Graphics/GraphicsModule.h"
+#include "Engine/MemoryTracker.h"
+#include "Engine/Assert.h"
 
 static constexpr i32f MAX_TEXTURES = 256;
 
-void GraphicsModule::StartUp(SDL_Window* pWindow, SDL_Renderer* pRenderer, s32 width, s32 height)
+struct TextureData
+{
+    SDL_Surface* pSurface;
+    SDL_Texture* pTexture;
+};
+
+/** Index is how many elements cover cell */
+static constexpr SDL_Color OVERDRAW_COLORS[] = {
+    { 0x00, 0x00, 0x00, 0x00 },
+    { 0x00, 0x40, 0xFF, 0x40 },
+    { 0x00, 0xFF, 0x40, 0x50 },
+    { 0xFF, 0xFF, 0x00, 0x60 },
+    { 0xFF, 0x80, 0x00, 0x70 },
+    { 0xFF, 0x00, 0x00, 0x80 }
+};
+
+internal f32 TicksToMilliseconds(u64 ticks)
+{
+    return (f32)(ticks * 1000) / (f32)SDL_GetPerformanceFrequency();
+}
+
+/** Rounds towards negative infinity unlike operator / */
+internal s32 FloorDiv(s32 value, s32 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+void GraphicsModule::StartUp(SDL_Window* pWindow, s32 width, s32 height)
 {
     // Defaults
     m_screenWidth = width;
@@ -22,9 +51,65 @@ void GraphicsModule::StartUp(SDL_Window* pWindow, SDL_Renderer* pRenderer, s32 w
     m_pixelsPerUnitY = m_screenHeight / (f32)UNIT_SCREEN_HEIGHT;
     m_invPixelsPerUnitY = 1.0f / m_pixelsPerUnitY;
 
+    // Run render thread, first frame is being recorded right away
+    m_recordFrame = 0;
+    m_taskHead = 0;
+    m_taskTail = 0;
+    m_taskLock = 0;
+    m_pTaskReady = SDL_CreateSemaphore(0);
+    m_pFreeFrames = SDL_CreateSemaphore(FRAME_COUNT - 1);
+    m_pInvokeDone = SDL_CreateSemaphore(0);
+
+    SDL_AtomicSet(&m_submitTime, 0);
+    m_bBackgroundCached = false;
+    m_bForegroundCached = false;
+    m_bPartialRedraw = false;
+    SDL_AtomicSet(&m_bLayersLost, 0);
+
+    m_bOverdrawShown = false;
+    m_overdrawCellsX = (m_screenWidth + OVERDRAW_CELL_SIZE - 1) / OVERDRAW_CELL_SIZE;
+    m_overdrawCellsY = (m_screenHeight + OVERDRAW_CELL_SIZE - 1) / OVERDRAW_CELL_SIZE;
+    m_aOverdraw = new u8[m_overdrawCellsX * m_overdrawCellsY];
+
+    std::memset(&m_lastStats, 0, sizeof(m_lastStats));
+    m_statsLock = 0;
+    m_pSubmitStats = nullptr;
+    m_pLastTexture = nullptr;
+    m_lastBlend = SDL_BLENDMODE_BLEND;
+
+    m_backgroundCache.chunkCount = 0;
+    m_backgroundCache.bFailed = false;
+    m_foregroundCache.chunkCount = 0;
+    m_foregroundCache.bFailed = false;
+    m_submitCount = 0;
+    m_pScreenTarget = nullptr;
+    m_bScreenValid = false;
+    m_drawnCameraX = m_drawnCameraY = 0;
+    m_aDrawn = nullptr;
+    m_aPrevDrawn = nullptr;
+    m_drawnCount = 0;
+    m_prevDrawnCount = 0;
+    m_drawnCapacity = 0;
+    m_dirtyCount = 0;
+    m_recordStart = 0;
+    m_recordTime = 0.0f;
+    m_waitTime = 0.0f;
+
+    m_pRenderThread = SDL_CreateThread(RenderMain, "GT2D Render", this);
+    if (!m_pRenderThread)
+    {
+        AddNote(PR_WARNING, "Can't create render thread, render on main: %s", SDL_GetError());
+    }
+
     // SDL
     m_pWindow = pWindow;
-    m_pRenderer = pRenderer;
+    m_pRenderer = nullptr;
+    Invoke(CreateRenderer, this);
+    if (!m_pRenderer)
+    {
+        AddNote(PR_ERROR, "Error on creating renderer: %s", SDL_GetError());
+        AssertNoEntry();
+    }
 
     // Color
     m_drawColor = { 0x00, 0x00, 0x00, 0xFF };
@@ -43,7 +128,28 @@ void GraphicsModule::StartUp(SDL_Window* pWindow, SDL_Renderer* pRenderer, s32 w
 
 void GraphicsModule::ShutDown()
 {
-    // Close font
+    // Free textures after frames in flight
+    Invoke(DestroyTextures, this);
+    delete[] m_aTextures;
+
+    // Stop render thread, renderer goes with it
+    if (m_pRenderThread)
+    {
+        PushTask({ RENDER_TASK_QUIT, 0, nullptr, nullptr });
+        SDL_WaitThread(m_pRenderThread, nullptr);
+        m_pRenderThread = nullptr;
+    }
+    else
+    {
+        SDL_DestroyRenderer(m_pRenderer);
+    }
+    m_pRenderer = nullptr;
+
+    SDL_DestroySemaphore(m_pTaskReady);
+    SDL_DestroySemaphore(m_pFreeFrames);
+    SDL_DestroySemaphore(m_pInvokeDone);
+
+    // Close fonts, frames in flight don't use it anymore
     if (m_pConsoleFont)
     {
         TTF_CloseFont(m_pConsoleFont);
@@ -54,47 +160,93 @@ void GraphicsModule::ShutDown()
         TTF_CloseFont(m_pGameFont);
         m_pGameFont = nullptr;
     }
-
-    // Free textures
-    for (i32f i = 0; i < MAX_TEXTURES; ++i)
+    if (m_pMenuFont)
     {
-        SDL_DestroyTexture(m_aTextures[i].pTexture);
+        TTF_CloseFont(m_pMenuFont);
+        m_pMenuFont = nullptr;
     }
-    delete[] m_aTextures;
 
     // Free render queues
-    CleanQueues();
+    for (i32f i = 0; i < FRAME_COUNT; ++i)
+    {
+        CleanFrame(m_aFrames[i]);
+    }
+
+    delete[] m_aOverdraw;
+    m_aOverdraw = nullptr;
+
+    delete[] m_aDrawn;
+    delete[] m_aPrevDrawn;
+    m_aDrawn = m_aPrevDrawn = nullptr;
+    m_drawnCapacity = 0;
 
     AddNote(PR_NOTE, "Module shut down");
 }
 
 void GraphicsModule::PrepareToRender()
 {
-    // Clear screen
-    SDL_SetRenderDrawColor(m_pRenderer, 0x00, 0x00, 0x00, 0xFF);
-    SDL_RenderClear(m_pRenderer);
+    m_recordStart = SDL_GetPerformanceCounter();
 
     // Get camera position
     m_camera.GetPosition(m_cameraX, m_cameraY);
+
+    RenderFrame& frame = m_aFrames[m_recordFrame];
+    frame.cameraX = m_cameraX;
+    frame.cameraY = m_cameraY;
+    frame.bBackgroundCached = m_bBackgroundCached;
+    frame.bForegroundCached = m_bForegroundCached;
+    frame.bPartialRedraw = m_bPartialRedraw;
+
+    std::memset(&frame.stats, 0, sizeof(frame.stats));
+    frame.sortTicks = 0;
 }
 
 void GraphicsModule::Render()
 {
-    // Render
-    RenderQueue(m_queueBackground);
-    RenderQueue(m_queueDynamic);
-    RenderQueue(m_queueForeground);
-    RenderQueue(m_queueDebug);
+    RenderFrame& frame = m_aFrames[m_recordFrame];
+    if (m_bOverdrawShown)
+    {
+        QueueOverdraw(frame);
+    }
+    frame.stats.sortTime = TicksToMilliseconds(frame.sortTicks);
 
-    // Present
-    SDL_RenderPresent(m_pRenderer);
+    u64 start = SDL_GetPerformanceCounter();
+    m_recordTime = TicksToMilliseconds(start - m_recordStart);
 
-    // Clean
-    CleanQueues();
+    if (!m_pRenderThread)
+    {
+        u64 submitStart = SDL_GetPerformanceCounter();
+        SubmitFrame(frame);
+        SDL_AtomicSet(&m_submitTime, (s32)(TicksToMilliseconds(SDL_GetPerformanceCounter() - submitStart) * 1000.0f));
+
+        m_waitTime = 0.0f;
+        return;
+    }
+
+    // Hand frame over and take next one when it's free
+    PushTask({ RENDER_TASK_FRAME, m_recordFrame, nullptr, nullptr });
+    m_recordFrame = (m_recordFrame + 1) % FRAME_COUNT;
+    SDL_SemWait(m_pFreeFrames);
+
+    m_waitTime = TicksToMilliseconds(SDL_GetPerformanceCounter() - start);
+}
+
+void GraphicsModule::Invoke(RenderFunction pFunction, void* pUserdata)
+{
+    if (!m_pRenderThread)
+    {
+        pFunction(pUserdata);
+        return;
+    }
+
+    PushTask({ RENDER_TASK_INVOKE, 0, pFunction, pUserdata });
+    SDL_SemWait(m_pInvokeDone);
 }
 
 const Texture* GraphicsModule::DefineTexture(const char* fileName, s32 spriteWidth, s32 spriteHeight)
 {
+    MemoryScope scope(MEMORY_GRAPHICS);
+
     // Try to find free slot
     Texture* pFree = nullptr;
     for (i32f i = 0; i < MAX_TEXTURES; ++i)
@@ -128,8 +280,11 @@ const Texture* GraphicsModule::DefineTexture(const char* fileName, s32 spriteWid
     pFree->spriteHeight = spriteHeight;
 
     // Create texture
-    pFree->pTexture = SDL_CreateTextureFromSurface(m_pRenderer, pSurface);
+    TextureData data = { pSurface, nullptr };
+    Invoke(CreateTexture, &data);
     SDL_FreeSurface(pSurface);
+
+    pFree->pTexture = data.pTexture;
     if (!pFree->pTexture)
     {
         AddNote(PR_WARNING, "Can't create texture from surface: %s", fileName);
@@ -141,10 +296,40 @@ const Texture* GraphicsModule::DefineTexture(const char* fileName, s32 spriteWid
 
 void GraphicsModule::UndefineTextures()
 {
-    for (i32f i = 0; i < MAX_TEXTURES; ++i)
+    Invoke(DestroyTextures, this);
+}
+
+void GraphicsModule::GetRenderStats(RenderStats& stats)
+{
+    SDL_AtomicLock(&m_statsLock);
+    stats = m_lastStats;
+    SDL_AtomicUnlock(&m_statsLock);
+}
+
+void GraphicsModule::CountDrawCall(const SDL_Texture* pTexture, SDL_BlendMode blend)
+{
+    ++m_pSubmitStats->drawCalls;
+
+    if (pTexture && pTexture != m_pLastTexture)
+    {
+        ++m_pSubmitStats->textureBinds;
+        m_pLastTexture = pTexture;
+    }
+
+    if (blend != m_lastBlend)
     {
-        SDL_DestroyTexture(m_aTextures[i].pTexture);
-        m_aTextures[i].pTexture = nullptr;
+        ++m_pSubmitStats->blendChanges;
+        m_lastBlend = blend;
+    }
+}
+
+void GraphicsModule::SetLayerCached(s32 renderMode, b32 bCached)
+{
+    switch (renderMode)
+    {
+    case RENDER_MODE_BACKGROUND: m_bBackgroundCached = bCached; break;
+    case RENDER_MODE_FOREGROUND: m_bForegroundCached = bCached; break;
+    default: AddNote(PR_WARNING, "SetLayerCached(): Only background and foreground layers can be cached, got %d", renderMode); break;
     }
 }
 
@@ -164,7 +349,7 @@ void GraphicsModule::DrawFrame(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_R
     }
 
     // Push element
-    PushRenderElement(renderMode, new RenderElementFrame(zIndex, dest, pTexture, row, col, angle, flip));
+    PushRenderElement(renderMode, bHUD, new RenderElementFrame(zIndex, dest, pTexture, row, col, angle, flip));
 }
 
 void GraphicsModule::DrawText(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Rect& dstRect, const char* text, eFontID font)
@@ -187,7 +372,7 @@ void GraphicsModule::DrawText(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Re
     }
 
     // Push element
-    PushRenderElement(renderMode, new RenderElementText(zIndex, dest, text, pFont));
+    PushRenderElement(renderMode, bHUD, new RenderElementText(zIndex, dest, text, pFont));
 }
 
 void GraphicsModule::FillRect(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Rect& dstRect)
@@ -200,7 +385,7 @@ void GraphicsModule::FillRect(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Re
     }
 
     // Push element
-    PushRenderElement(renderMode, new RenderElementRect(zIndex, dest, RenderElementRect::ACTION_FILL));
+    PushRenderElement(renderMode, bHUD, new RenderElementRect(zIndex, dest, RenderElementRect::ACTION_FILL));
 }
 
 void GraphicsModule::DrawRect(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Rect& dstRect)
@@ -213,7 +398,189 @@ void GraphicsModule::DrawRect(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Re
     }
 
     // Push element
-    PushRenderElement(renderMode, new RenderElementRect(zIndex, dest, RenderElementRect::ACTION_DRAW));
+    PushRenderElement(renderMode, bHUD, new RenderElementRect(zIndex, dest, RenderElementRect::ACTION_DRAW));
+}
+
+void GraphicsModule::DrawTiles(s32 renderMode, s32 zIndex, const SDL_Rect& dstRect, TileMesh* pMesh)
+{
+    if (!pMesh)
+    {
+        AddNote(PR_WARNING, "DrawTiles() called with null mesh");
+        return;
+    }
+
+    // Check and correct destination rectangle
+    SDL_Rect dest = dstRect;
+    if (!CheckAndCorrectDest(dest, false))
+    {
+        return;
+    }
+
+    // Push element
+    PushRenderElement(renderMode, false, new RenderElementTiles(zIndex, dest, pMesh));
+}
+
+s32 SDLCALL GraphicsModule::RenderMain(void* pData)
+{
+    GraphicsModule* pGraphics = (GraphicsModule*)pData;
+    MemoryScope scope(MEMORY_GRAPHICS);
+
+    for ( ;; )
+    {
+        SDL_SemWait(pGraphics->m_pTaskReady);
+
+        RenderTask task;
+        if (!pGraphics->PopTask(task))
+        {
+            continue;
+        }
+
+        switch (task.type)
+        {
+        case RENDER_TASK_FRAME:
+        {
+            u64 start = SDL_GetPerformanceCounter();
+            pGraphics->SubmitFrame(pGraphics->m_aFrames[task.frame]);
+            SDL_AtomicSet(&pGraphics->m_submitTime, (s32)(TicksToMilliseconds(SDL_GetPerformanceCounter() - start) * 1000.0f));
+
+            SDL_SemPost(pGraphics->m_pFreeFrames);
+        } break;
+
+        case RENDER_TASK_INVOKE:
+        {
+            task.pFunction(task.pUserdata);
+            SDL_SemPost(pGraphics->m_pInvokeDone);
+        } break;
+
+        case RENDER_TASK_QUIT:
+        {
+            SDL_DestroyRenderer(pGraphics->m_pRenderer);
+            return 0;
+        } break;
+        }
+    }
+}
+
+void GraphicsModule::CreateRenderer(void* pUserdata)
+{
+    GraphicsModule* pGraphics = (GraphicsModule*)pUserdata;
+
+    pGraphics->m_pRenderer = SDL_CreateRenderer(pGraphics->m_pWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (pGraphics->m_pRenderer)
+    {
+        SDL_SetRenderDrawBlendMode(pGraphics->m_pRenderer, SDL_BLENDMODE_BLEND);
+
+        // Chunks are drawn with usual blending on transparent texture, so their color is premultiplied by alpha
+        pGraphics->m_bTargetSupported = SDL_RenderTargetSupported(pGraphics->m_pRenderer);
+        pGraphics->m_premultipliedBlend = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD
+        );
+    }
+}
+
+void GraphicsModule::CreateTexture(void* pUserdata)
+{
+    TextureData* pData = (TextureData*)pUserdata;
+    pData->pTexture = SDL_CreateTextureFromSurface(g_graphicsModule.m_pRenderer, pData->pSurface);
+}
+
+void GraphicsModule::DestroyTextures(void* pUserdata)
+{
+    GraphicsModule* pGraphics = (GraphicsModule*)pUserdata;
+
+    for (i32f i = 0; i < MAX_TEXTURES; ++i)
+    {
+        SDL_DestroyTexture(pGraphics->m_aTextures[i].pTexture);
+        pGraphics->m_aTextures[i].pTexture = nullptr;
+    }
+
+    // Texture slots may be reused by other images, cached layers are stale
+    pGraphics->ReleaseCache(pGraphics->m_backgroundCache);
+    pGraphics->ReleaseCache(pGraphics->m_foregroundCache);
+    pGraphics->m_bScreenValid = false;
+}
+
+void GraphicsModule::PushTask(const RenderTask& task)
+{
+    // Main thread has at most FRAME_COUNT frames and one invoke in flight, so it never overflows
+    SDL_AtomicLock(&m_taskLock);
+    m_aTasks[m_taskTail % TASK_COUNT] = task;
+    ++m_taskTail;
+    SDL_AtomicUnlock(&m_taskLock);
+
+    SDL_SemPost(m_pTaskReady);
+}
+
+b32 GraphicsModule::PopTask(RenderTask& task)
+{
+    b32 bPopped = false;
+
+    SDL_AtomicLock(&m_taskLock);
+    if (m_taskTail > m_taskHead)
+    {
+        task = m_aTasks[m_taskHead % TASK_COUNT];
+        ++m_taskHead;
+        bPopped = true;
+    }
+    SDL_AtomicUnlock(&m_taskLock);
+
+    return bPopped;
+}
+
+void GraphicsModule::SubmitFrame(RenderFrame& frame)
+{
+    m_pSubmitStats = &frame.stats;
+    m_pLastTexture = nullptr;
+    m_lastBlend = SDL_BLENDMODE_BLEND;
+
+    ++m_submitCount;
+    if (SDL_AtomicSet(&m_bLayersLost, 0))
+    {
+        InvalidateCache(m_backgroundCache);
+        InvalidateCache(m_foregroundCache);
+        m_bScreenValid = false;
+    }
+
+    // Render
+    if (!frame.bPartialRedraw || !RenderPartial(frame))
+    {
+        ReleaseScreenTarget();
+
+        SDL_SetRenderDrawColor(m_pRenderer, 0x00, 0x00, 0x00, 0xFF);
+        SDL_RenderClear(m_pRenderer);
+        RenderLayers(frame);
+    }
+
+    // Present
+    SDL_RenderPresent(m_pRenderer);
+
+    SDL_AtomicLock(&m_statsLock);
+    m_lastStats = frame.stats;
+    SDL_AtomicUnlock(&m_statsLock);
+    m_pSubmitStats = nullptr;
+
+    // Clean
+    CleanFrame(frame);
+}
+
+void GraphicsModule::RenderLayers(const RenderFrame& frame)
+{
+    if (!frame.bBackgroundCached || m_backgroundCache.bFailed || !RenderCachedQueue(frame.queueBackground, m_backgroundCache, frame))
+    {
+        ReleaseCache(m_backgroundCache);
+        RenderQueue(frame.queueBackground);
+    }
+
+    RenderQueue(frame.queueDynamic);
+
+    if (!frame.bForegroundCached || m_foregroundCache.bFailed || !RenderCachedQueue(frame.queueForeground, m_foregroundCache, frame))
+    {
+        ReleaseCache(m_foregroundCache);
+        RenderQueue(frame.queueForeground);
+    }
+
+    RenderQueue(frame.queueDebug);
 }
 
 void GraphicsModule::RenderQueue(const TList<RenderElement*>& queue) const
@@ -225,12 +592,394 @@ void GraphicsModule::RenderQueue(const TList<RenderElement*>& queue) const
     }
 }
 
-void GraphicsModule::CleanQueues()
+b32 GraphicsModule::RenderCachedQueue(const TList<RenderElement*>& queue, LayerCache& cache, const RenderFrame& frame)
+{
+    if (!m_bTargetSupported)
+    {
+        return false;
+    }
+
+    // Find chunks around camera
+    s32 firstX = FloorDiv(frame.cameraX, LAYER_CHUNK_SIZE);
+    s32 firstY = FloorDiv(frame.cameraY, LAYER_CHUNK_SIZE);
+    s32 countX = FloorDiv(frame.cameraX + m_screenWidth - 1, LAYER_CHUNK_SIZE) - firstX + 1;
+    s32 countY = FloorDiv(frame.cameraY + m_screenHeight - 1, LAYER_CHUNK_SIZE) - firstY + 1;
+    if (countX * countY > MAX_LAYER_CHUNKS)
+    {
+        return false;
+    }
+
+    // Hash elements of every chunk, any change in look, place or order gives another hash
+    u64 aHashes[MAX_LAYER_CHUNKS];
+    for (i32f i = 0; i < countX * countY; ++i)
+    {
+        aHashes[i] = 0xCBF29CE484222325ull;
+    }
+
+    auto end = queue.CEnd();
+    for (auto it = queue.CBegin(); it != end; ++it)
+    {
+        const RenderElement* pElement = it->data;
+        if (pElement->bHUD)
+        {
+            continue;
+        }
+
+        // Back to world coordinates
+        SDL_Rect rect = { pElement->dest.x + frame.cameraX, pElement->dest.y + frame.cameraY, pElement->dest.w, pElement->dest.h };
+        u64 hash = HashCombine(pElement->Hash(), ((u64)(u32)rect.x << 32) | (u32)rect.y);
+        hash = HashCombine(hash, ((u64)(u32)rect.w << 32) | (u32)rect.h);
+
+        // Rotated elements may go out of their rect, so widen it by half diagonal
+        s32 extent = (rect.w + rect.h) / 2;
+        s32 x1 = Math::Max(FloorDiv(rect.x - extent, LAYER_CHUNK_SIZE) - firstX, 0);
+        s32 y1 = Math::Max(FloorDiv(rect.y - extent, LAYER_CHUNK_SIZE) - firstY, 0);
+        s32 x2 = Math::Min(FloorDiv(rect.x + rect.w + extent, LAYER_CHUNK_SIZE) - firstX, countX - 1);
+        s32 y2 = Math::Min(FloorDiv(rect.y + rect.h + extent, LAYER_CHUNK_SIZE) - firstY, countY - 1);
+
+        for (i32f y = y1; y <= y2; ++y)
+        {
+            for (i32f x = x1; x <= x2; ++x)
+            {
+                aHashes[y * countX + x] = HashCombine(aHashes[y * countX + x], hash);
+            }
+        }
+    }
+
+    // Get all chunks before anything is drawn, so failed layer is drawn only once as usual
+    LayerChunk* apChunks[MAX_LAYER_CHUNKS];
+    for (i32f i = 0; i < countX * countY; ++i)
+    {
+        apChunks[i] = FindChunk(cache, firstX + (s32)(i % countX), firstY + (s32)(i / countX));
+        if (!apChunks[i])
+        {
+            AddNote(PR_WARNING, "Layer caching is off until device reset");
+            cache.bFailed = true;
+            return false;
+        }
+        apChunks[i]->lastSubmit = m_submitCount;
+    }
+
+    // Redraw changed chunks and put them on screen
+    for (i32f y = 0; y < countY; ++y)
+    {
+        for (i32f x = 0; x < countX; ++x)
+        {
+            LayerChunk* pChunk = apChunks[y * countX + x];
+            if (pChunk->hash != aHashes[y * countX + x])
+            {
+                RenderChunk(queue, *pChunk, frame);
+                pChunk->hash = aHashes[y * countX + x];
+            }
+
+            SDL_Rect dest = {
+                (s32)(pChunk->x * LAYER_CHUNK_SIZE) - frame.cameraX, (s32)(pChunk->y * LAYER_CHUNK_SIZE) - frame.cameraY,
+                LAYER_CHUNK_SIZE, LAYER_CHUNK_SIZE
+            };
+            SDL_RenderCopy(m_pRenderer, pChunk->pTexture, nullptr, &dest);
+            CountDrawCall(pChunk->pTexture, m_premultipliedBlend);
+        }
+    }
+
+    // HUD elements aren't cached, they go over the layer
+    for (auto it = queue.CBegin(); it != end; ++it)
+    {
+        if (it->data->bHUD)
+        {
+            it->data->Render();
+        }
+    }
+
+    return true;
+}
+
+void GraphicsModule::RenderChunk(const TList<RenderElement*>& queue, const LayerChunk& chunk, const RenderFrame& frame)
 {
-    CleanQueue(m_queueBackground);
-    CleanQueue(m_queueDynamic);
-    CleanQueue(m_queueForeground);
-    CleanQueue(m_queueDebug);
+    SDL_SetRenderTarget(m_pRenderer, chunk.pTexture);
+    SDL_SetRenderDrawColor(m_pRenderer, 0x00, 0x00, 0x00, 0x00);
+    SDL_RenderClear(m_pRenderer);
+
+    // Move elements from screen into chunk, target clips them
+    s32 offsetX = frame.cameraX - chunk.x * LAYER_CHUNK_SIZE;
+    s32 offsetY = frame.cameraY - chunk.y * LAYER_CHUNK_SIZE;
+
+    auto end = queue.CEnd();
+    for (auto it = queue.CBegin(); it != end; ++it)
+    {
+        RenderElement* pElement = it->data;
+        if (pElement->bHUD)
+        {
+            continue;
+        }
+
+        // Skip elements of other chunks, with the same margin as in hashing
+        s32 extent = (pElement->dest.w + pElement->dest.h) / 2;
+        s32 x = pElement->dest.x + offsetX;
+        s32 y = pElement->dest.y + offsetY;
+        if (x + pElement->dest.w + extent < 0 || y + pElement->dest.h + extent < 0 ||
+            x - extent >= LAYER_CHUNK_SIZE || y - extent >= LAYER_CHUNK_SIZE)
+        {
+            continue;
+        }
+
+        SDL_Rect dest = pElement->dest;
+        pElement->dest.x += offsetX;
+        pElement->dest.y += offsetY;
+        pElement->Render();
+        pElement->dest = dest;
+    }
+
+    SDL_SetRenderTarget(m_pRenderer, nullptr);
+}
+
+b32 GraphicsModule::RenderPartial(const RenderFrame& frame)
+{
+    if (!m_bTargetSupported)
+    {
+        return false;
+    }
+
+    // Back buffer is undefined after present, so last frame lives in texture
+    if (!m_pScreenTarget)
+    {
+        m_pScreenTarget = SDL_CreateTexture(m_pRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, m_screenWidth, m_screenHeight);
+        if (!m_pScreenTarget)
+        {
+            AddNote(PR_WARNING, "Can't create screen texture: %s", SDL_GetError());
+            return false;
+        }
+
+        SDL_SetTextureBlendMode(m_pScreenTarget, SDL_BLENDMODE_NONE);
+        m_bScreenValid = false;
+    }
+
+    // Elements in draw order
+    m_drawnCount = 0;
+    RecordDrawn(frame.queueBackground);
+    RecordDrawn(frame.queueDynamic);
+    RecordDrawn(frame.queueForeground);
+    RecordDrawn(frame.queueDebug);
+
+    // Compare with previous frame, changed element dirties both its old and new place
+    m_dirtyCount = 0;
+    if (!m_bScreenValid || frame.cameraX != m_drawnCameraX || frame.cameraY != m_drawnCameraY)
+    {
+        AddDirtyRect({ 0, 0, m_screenWidth, m_screenHeight });
+    }
+    else
+    {
+        s32 count = Math::Max(m_drawnCount, m_prevDrawnCount);
+        for (i32f i = 0; i < count; ++i)
+        {
+            b32 bDrawn = i < m_drawnCount;
+            b32 bPrevDrawn = i < m_prevDrawnCount;
+            if (bDrawn && bPrevDrawn && m_aDrawn[i].hash == m_aPrevDrawn[i].hash)
+            {
+                continue;
+            }
+
+            if (bDrawn)
+            {
+                AddDirtyRect(m_aDrawn[i].bounds);
+            }
+            if (bPrevDrawn)
+            {
+                AddDirtyRect(m_aPrevDrawn[i].bounds);
+            }
+        }
+    }
+
+    // Redraw everything that touches dirty rects
+    SDL_SetRenderTarget(m_pRenderer, m_pScreenTarget);
+    for (i32f i = 0; i < m_dirtyCount; ++i)
+    {
+        const SDL_Rect& rect = m_aDirtyRects[i];
+        SDL_RenderSetClipRect(m_pRenderer, &rect);
+
+        SDL_SetRenderDrawColor(m_pRenderer, 0x00, 0x00, 0x00, 0xFF);
+        SDL_RenderFillRect(m_pRenderer, &rect);
+        CountDrawCall(nullptr);
+
+        for (i32f j = 0; j < m_drawnCount; ++j)
+        {
+            if (SDL_HasIntersection(&m_aDrawn[j].bounds, &rect))
+            {
+                m_aDrawn[j].pElement->Render();
+            }
+        }
+    }
+    SDL_RenderSetClipRect(m_pRenderer, nullptr);
+    SDL_SetRenderTarget(m_pRenderer, nullptr);
+
+    SDL_RenderCopy(m_pRenderer, m_pScreenTarget, nullptr, nullptr);
+    CountDrawCall(m_pScreenTarget, SDL_BLENDMODE_NONE);
+
+    // Elements are freed with frame, only bounds and hashes are compared later
+    DrawnElement* aTemp = m_aPrevDrawn;
+    m_aPrevDrawn = m_aDrawn;
+    m_aDrawn = aTemp;
+    m_prevDrawnCount = m_drawnCount;
+    m_drawnCount = 0;
+
+    m_drawnCameraX = frame.cameraX;
+    m_drawnCameraY = frame.cameraY;
+    m_bScreenValid = true;
+
+    return true;
+}
+
+void GraphicsModule::RecordDrawn(const TList<RenderElement*>& queue)
+{
+    auto end = queue.CEnd();
+    for (auto it = queue.CBegin(); it != end; ++it)
+    {
+        // Grow both buffers, they're swapped every frame
+        if (m_drawnCount == m_drawnCapacity)
+        {
+            s32 capacity = Math::Max(m_drawnCapacity * 2, 256);
+
+            DrawnElement* aDrawn = new DrawnElement[capacity];
+            std::memcpy(aDrawn, m_aDrawn, sizeof(DrawnElement) * m_drawnCount);
+            delete[] m_aDrawn;
+            m_aDrawn = aDrawn;
+
+            DrawnElement* aPrevDrawn = new DrawnElement[capacity];
+            std::memcpy(aPrevDrawn, m_aPrevDrawn, sizeof(DrawnElement) * m_prevDrawnCount);
+            delete[] m_aPrevDrawn;
+            m_aPrevDrawn = aPrevDrawn;
+
+            m_drawnCapacity = capacity;
+        }
+
+        // Destinations are in screen space already
+        RenderElement* pElement = it->data;
+        u64 hash = HashCombine(pElement->Hash(), ((u64)(u32)pElement->dest.x << 32) | (u32)pElement->dest.y);
+
+        DrawnElement& drawn = m_aDrawn[m_drawnCount++];
+        drawn.bounds = pElement->GetBounds();
+        drawn.hash = HashCombine(hash, ((u64)(u32)pElement->dest.w << 32) | (u32)pElement->dest.h);
+        drawn.pElement = pElement;
+    }
+}
+
+void GraphicsModule::AddDirtyRect(const SDL_Rect& rect)
+{
+    SDL_Rect screen = { 0, 0, m_screenWidth, m_screenHeight };
+    SDL_Rect dirty;
+    if (!SDL_IntersectRect(&rect, &screen, &dirty))
+    {
+        return;
+    }
+
+    // Merge overlapping, grown rect may overlap ones we've passed
+    for (i32f i = 0; i < m_dirtyCount; )
+    {
+        if (SDL_HasIntersection(&dirty, &m_aDirtyRects[i]))
+        {
+            SDL_UnionRect(&dirty, &m_aDirtyRects[i], &dirty);
+            m_aDirtyRects[i] = m_aDirtyRects[--m_dirtyCount];
+            i = 0;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    if (m_dirtyCount == MAX_DIRTY_RECTS)
+    {
+        for (i32f i = 0; i < m_dirtyCount; ++i)
+        {
+            SDL_UnionRect(&dirty, &m_aDirtyRects[i], &dirty);
+        }
+        m_dirtyCount = 0;
+    }
+
+    m_aDirtyRects[m_dirtyCount++] = dirty;
+}
+
+void GraphicsModule::ReleaseScreenTarget()
+{
+    if (m_pScreenTarget)
+    {
+        SDL_DestroyTexture(m_pScreenTarget);
+        m_pScreenTarget = nullptr;
+    }
+
+    m_prevDrawnCount = 0;
+    m_bScreenValid = false;
+}
+
+GraphicsModule::LayerChunk* GraphicsModule::FindChunk(LayerCache& cache, s32 x, s32 y)
+{
+    // Look for chunk we already have
+    for (i32f i = 0; i < cache.chunkCount; ++i)
+    {
+        if (cache.aChunks[i].x == x && cache.aChunks[i].y == y)
+        {
+            return &cache.aChunks[i];
+        }
+    }
+
+    // Take new one or reuse the longest unseen
+    LayerChunk* pChunk;
+    if (cache.chunkCount < MAX_LAYER_CHUNKS)
+    {
+        pChunk = &cache.aChunks[cache.chunkCount];
+        pChunk->pTexture = SDL_CreateTexture(m_pRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, LAYER_CHUNK_SIZE, LAYER_CHUNK_SIZE);
+        if (!pChunk->pTexture)
+        {
+            AddNote(PR_WARNING, "Can't create layer chunk texture: %s", SDL_GetError());
+            return nullptr;
+        }
+
+        SDL_SetTextureBlendMode(pChunk->pTexture, m_premultipliedBlend);
+        ++cache.chunkCount;
+    }
+    else
+    {
+        pChunk = &cache.aChunks[0];
+        for (i32f i = 1; i < cache.chunkCount; ++i)
+        {
+            if (cache.aChunks[i].lastSubmit < pChunk->lastSubmit)
+            {
+                pChunk = &cache.aChunks[i];
+            }
+        }
+    }
+
+    pChunk->x = x;
+    pChunk->y = y;
+    pChunk->hash = 0;
+    pChunk->lastSubmit = 0;
+
+    return pChunk;
+}
+
+void GraphicsModule::InvalidateCache(LayerCache& cache)
+{
+    cache.bFailed = false;
+    for (i32f i = 0; i < cache.chunkCount; ++i)
+    {
+        cache.aChunks[i].hash = 0;
+    }
+}
+
+void GraphicsModule::ReleaseCache(LayerCache& cache)
+{
+    for (i32f i = 0; i < cache.chunkCount; ++i)
+    {
+        SDL_DestroyTexture(cache.aChunks[i].pTexture);
+    }
+    cache.chunkCount = 0;
+}
+
+void GraphicsModule::CleanFrame(RenderFrame& frame)
+{
+    CleanQueue(frame.queueBackground);
+    CleanQueue(frame.queueDynamic);
+    CleanQueue(frame.queueForeground);
+    CleanQueue(frame.queueDebug);
 }
 
 void GraphicsModule::CleanQueue(TList<RenderElement*>& queue)
@@ -242,6 +991,78 @@ void GraphicsModule::CleanQueue(TList<RenderElement*>& queue)
     queue.Clean();
 }
 
+void GraphicsModule::QueueOverdraw(RenderFrame& frame)
+{
+    std::memset(m_aOverdraw, 0, m_overdrawCellsX * m_overdrawCellsY);
+    AddOverdraw(frame.queueBackground);
+    AddOverdraw(frame.queueDynamic);
+    AddOverdraw(frame.queueForeground);
+
+    // Cells of the same level in row go as one rect, they skip stats since they're not part of scene
+    SDL_Color drawColor = m_drawColor;
+
+    for (i32f y = 0; y < m_overdrawCellsY; ++y)
+    {
+        const u8* aRow = &m_aOverdraw[y * m_overdrawCellsX];
+        for (i32f x = 0; x < m_overdrawCellsX; )
+        {
+            s32 level = Math::Min((s32)aRow[x], (s32)OVERDRAW_LEVELS - 1);
+            i32f end = x + 1;
+            while (end < m_overdrawCellsX && Math::Min((s32)aRow[end], (s32)OVERDRAW_LEVELS - 1) == level)
+            {
+                ++end;
+            }
+
+            if (level > 0)
+            {
+                SDL_Rect dest = {
+                    (s32)(x * OVERDRAW_CELL_SIZE), (s32)(y * OVERDRAW_CELL_SIZE),
+                    (s32)((end - x) * OVERDRAW_CELL_SIZE), (s32)OVERDRAW_CELL_SIZE
+                };
+
+                m_drawColor = OVERDRAW_COLORS[level];
+                RenderElement* pElement = new RenderElementRect(OVERDRAW_Z_INDEX, dest, RenderElementRect::ACTION_FILL);
+                pElement->bHUD = true;
+                QueueElement(frame.queueDebug, pElement);
+            }
+
+            x = end;
+        }
+    }
+
+    m_drawColor = drawColor;
+}
+
+void GraphicsModule::AddOverdraw(const TList<RenderElement*>& queue)
+{
+    auto end = queue.CEnd();
+    for (auto it = queue.CBegin(); it != end; ++it)
+    {
+        SDL_Rect bounds = it->data->GetBounds();
+        if (bounds.w <= 0 || bounds.h <= 0)
+        {
+            continue;
+        }
+
+        s32 x1 = Math::Max(bounds.x / (s32)OVERDRAW_CELL_SIZE, 0);
+        s32 y1 = Math::Max(bounds.y / (s32)OVERDRAW_CELL_SIZE, 0);
+        s32 x2 = Math::Min((bounds.x + bounds.w - 1) / (s32)OVERDRAW_CELL_SIZE, m_overdrawCellsX - 1);
+        s32 y2 = Math::Min((bounds.y + bounds.h - 1) / (s32)OVERDRAW_CELL_SIZE, m_overdrawCellsY - 1);
+
+        for (s32 y = y1; y <= y2; ++y)
+        {
+            for (s32 x = x1; x <= x2; ++x)
+            {
+                u8& cell = m_aOverdraw[y * m_overdrawCellsX + x];
+                if (cell < 0xFF)
+                {
+                    ++cell;
+                }
+            }
+        }
+    }
+}
+
 b32 GraphicsModule::CheckAndCorrectDest(SDL_Rect& dest, b32 bHUD)
 {
     // Make screen coords from world coords
@@ -252,24 +1073,36 @@ b32 GraphicsModule::CheckAndCorrectDest(SDL_Rect& dest, b32 bHUD)
     }
 
     // Clip if we can't see it on screen
-    return !(
-        dest.x + dest.w <= 0 || dest.y + dest.h <= 0 ||
-        dest.x > m_screenWidth || dest.y > m_screenHeight
-    );
+    if (dest.x + dest.w <= 0 || dest.y + dest.h <= 0 || dest.x > m_screenWidth || dest.y > m_screenHeight)
+    {
+        ++m_aFrames[m_recordFrame].stats.culledElements;
+        return false;
+    }
+
+    return true;
 }
 
-void GraphicsModule::PushRenderElement(s32 renderMode, RenderElement* pElement)
+void GraphicsModule::PushRenderElement(s32 renderMode, b32 bHUD, RenderElement* pElement)
 {
+    pElement->bHUD = bHUD;
+    RenderFrame& frame = m_aFrames[m_recordFrame];
+
+    if (renderMode >= 0 && renderMode < RENDER_MODE_COUNT)
+    {
+        ++frame.stats.aElements[renderMode];
+    }
+    u64 start = SDL_GetPerformanceCounter();
+
     switch (renderMode)
     {
-    case RENDER_MODE_BACKGROUND: QueueElement(m_queueBackground, pElement); break;
-    case RENDER_MODE_FOREGROUND: QueueElement(m_queueForeground, pElement); break;
-    case RENDER_MODE_DEBUG:      QueueElement(m_queueDebug, pElement); break;
+    case RENDER_MODE_BACKGROUND: QueueElement(frame.queueBackground, pElement); break;
+    case RENDER_MODE_FOREGROUND: QueueElement(frame.queueForeground, pElement); break;
+    case RENDER_MODE_DEBUG:      QueueElement(frame.queueDebug, pElement); break;
 
     case RENDER_MODE_DYNAMIC:
     {
         pElement->zIndex += pElement->dest.y;
-        QueueElement(m_queueDynamic, pElement);
+        QueueElement(frame.queueDynamic, pElement);
     } break;
 
     default:
@@ -281,6 +1114,8 @@ void GraphicsModule::PushRenderElement(s32 renderMode, RenderElement* pElement)
         AddNote(PR_WARNING, "PushRenderElement: Unknown render mode %d", renderMode);
     } break;
     }
+
+    frame.sortTicks += SDL_GetPerformanceCounter() - start;
 }
 
 void GraphicsModule::QueueElement(TList<RenderElement*>& queue, RenderElement* pElement)
@@ -16,7 +16,9 @@ enum eRenderMode
     RENDER_MODE_BACKGROUND = 0,
     RENDER_MODE_DYNAMIC,
     RENDER_MODE_FOREGROUND,
-    RENDER_MODE_DEBUG
+    RENDER_MODE_DEBUG,
+
+    RENDER_MODE_COUNT
 };
 
 enum eFontID
@@ -28,9 +30,103 @@ enum eFontID
 
 struct RenderElement;
 struct Texture;
+struct TileMesh;
+
+/** Runs on render thread */
+using RenderFunction = void (*)(void* pUserdata);
+
+/** Cost of one frame, main thread fills what it records and render thread what it submits */
+struct RenderStats
+{
+    s32 aElements[RENDER_MODE_COUNT];
+    s32 culledElements;
+    f32 sortTime;
+
+    s32 drawCalls;
+    s32 textureBinds;
+    s32 blendChanges;
+    s32 textRasterizations;
+};
 
+/** Sorted elements of one frame, immutable once handed to render thread */
+struct RenderFrame
+{
+    TList<RenderElement*> queueBackground;
+    TList<RenderElement*> queueDynamic;
+    TList<RenderElement*> queueForeground;
+    TList<RenderElement*> queueDebug;
+
+    s32 cameraX, cameraY;
+    b32 bBackgroundCached;
+    b32 bForegroundCached;
+    b32 bPartialRedraw;
+
+    RenderStats stats;
+    u64 sortTicks;
+};
+
+/**
+ * Main thread records frame N+1 while render thread submits frame N.
+ * Render thread owns SDL renderer, everything that touches it goes
+ * through Invoke(). Without render thread it all runs inline
+ */
 class GraphicsModule final : public EngineModule
 {
+    static constexpr i32f FRAME_COUNT = 3;
+    static constexpr i32f TASK_COUNT = FRAME_COUNT + 2;
+
+    enum eRenderTask
+    {
+        RENDER_TASK_FRAME = 0,
+        RENDER_TASK_INVOKE,
+        RENDER_TASK_QUIT
+    };
+
+    struct RenderTask
+    {
+        s32 type;
+        s32 frame;
+        RenderFunction pFunction;
+        void* pUserdata;
+    };
+
+    /** Cached layers are kept in world aligned chunks around camera */
+    static constexpr i32f LAYER_CHUNK_SIZE = 512;
+    static constexpr i32f MAX_LAYER_CHUNKS = 48;
+
+    struct LayerChunk
+    {
+        s32 x, y;
+        u64 hash;
+        u32 lastSubmit;
+        SDL_Texture* pTexture;
+    };
+
+    struct LayerCache
+    {
+        LayerChunk aChunks[MAX_LAYER_CHUNKS];
+        s32 chunkCount;
+
+        /** Chunk texture couldn't be created, layer is drawn as usual until device reset */
+        b32 bFailed;
+    };
+
+    /** Overdraw heatmap counts elements in cells of this size and goes under console */
+    static constexpr i32f OVERDRAW_CELL_SIZE = 16;
+    static constexpr i32f OVERDRAW_LEVELS = 6;
+    static constexpr i32f OVERDRAW_Z_INDEX = 990;
+
+    /** Overlapping dirty rects are merged, when there're too many of them all go into one */
+    static constexpr i32f MAX_DIRTY_RECTS = 16;
+
+    /** What was drawn where, consecutive frames are compared by these */
+    struct DrawnElement
+    {
+        SDL_Rect bounds;
+        u64 hash;
+        RenderElement* pElement;
+    };
+
     s32 m_screenWidth;
     s32 m_screenHeight;
 
@@ -52,29 +148,114 @@ class GraphicsModule final : public EngineModule
     SDL_Color m_drawColor;
     Texture* m_aTextures;
 
-    TList<RenderElement*> m_queueBackground;
-    TList<RenderElement*> m_queueDynamic;
-    TList<RenderElement*> m_queueForeground;
-    TList<RenderElement*> m_queueDebug;
+    RenderFrame m_aFrames[FRAME_COUNT];
+    s32 m_recordFrame;
+
+    SDL_Thread* m_pRenderThread;
+    RenderTask m_aTasks[TASK_COUNT];
+    s32 m_taskHead;
+    s32 m_taskTail;
+    SDL_SpinLock m_taskLock;
+    SDL_sem* m_pTaskReady;
+    SDL_sem* m_pFreeFrames;
+    SDL_sem* m_pInvokeDone;
+
+    /** Microseconds, written by render thread */
+    SDL_atomic_t m_submitTime;
+
+    b32 m_bBackgroundCached;
+    b32 m_bForegroundCached;
+    b32 m_bPartialRedraw;
+    SDL_atomic_t m_bLayersLost;
+
+    b32 m_bOverdrawShown;
+    u8* m_aOverdraw;
+    s32 m_overdrawCellsX, m_overdrawCellsY;
+
+    /** Stats of last submitted frame */
+    RenderStats m_lastStats;
+    SDL_SpinLock m_statsLock;
+
+    /** Render thread only */
+    LayerCache m_backgroundCache;
+    LayerCache m_foregroundCache;
+    u32 m_submitCount;
+    b32 m_bTargetSupported;
+    SDL_BlendMode m_premultipliedBlend;
+
+    /** Render thread only, previous frame for partial redraw */
+    SDL_Texture* m_pScreenTarget;
+    b32 m_bScreenValid;
+    s32 m_drawnCameraX, m_drawnCameraY;
+    DrawnElement* m_aDrawn;
+    DrawnElement* m_aPrevDrawn;
+    s32 m_drawnCount;
+    s32 m_prevDrawnCount;
+    s32 m_drawnCapacity;
+    SDL_Rect m_aDirtyRects[MAX_DIRTY_RECTS];
+    s32 m_dirtyCount;
+
+    /** Render thread only, frame being submitted */
+    RenderStats* m_pSubmitStats;
+    const SDL_Texture* m_pLastTexture;
+    SDL_BlendMode m_lastBlend;
+
+    u64 m_recordStart;
+    f32 m_recordTime;
+    f32 m_waitTime;
 
 public:
     GraphicsModule() : EngineModule("GraphicsModule", CHANNEL_GRAPHICS) {}
 
-    void StartUp(SDL_Window* pWindow, SDL_Renderer* pRenderer, s32 width, s32 height);
+    void StartUp(SDL_Window* pWindow, s32 width, s32 height);
     void ShutDown();
 
     void PrepareToRender();
+
+    /** Hands recorded frame to render thread, waits only if it's two frames behind */
     void Render();
 
+    /** Runs function on render thread after frames handed before and waits for it */
+    void Invoke(RenderFunction pFunction, void* pUserdata);
+
     /** Null on error */
     const Texture* DefineTexture(const char* fileName, s32 spriteWidth, s32 spriteHeight);
     void UndefineTextures();
 
+    /** Static background or foreground layer is drawn into chunk textures and redrawn only where it changes */
+    void SetLayerCached(s32 renderMode, b32 bCached);
+
+    /**
+     * Screen is kept in texture and only rects where elements changed are redrawn.
+     * For mostly static screens like menus, any camera move redraws everything
+     */
+    forceinline void SetPartialRedraw(b32 bPartial) { m_bPartialRedraw = bPartial; }
+
+    /** Heatmap of how many elements cover every part of screen, drawn in debug queue */
+    forceinline void SetOverdrawShown(b32 bShown) { m_bOverdrawShown = bShown; }
+    forceinline b32 IsOverdrawShown() const { return m_bOverdrawShown; }
+
+    /** Stats of last frame render thread finished */
+    void GetRenderStats(RenderStats& stats);
+
+    /** Render thread, elements report every SDL draw they do */
+    void CountDrawCall(const SDL_Texture* pTexture, SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+    forceinline void CountTextRasterization() { ++m_pSubmitStats->textRasterizations; }
+
+    /** Things culled before they got here, like entities out of view */
+    forceinline void CountCulled(s32 count) { m_aFrames[m_recordFrame].stats.culledElements += count; }
+
+    /** Redraws cached layers on next frame, render targets lose content on device reset */
+    forceinline void InvalidateLayers() { SDL_AtomicSet(&m_bLayersLost, 1); }
+
     void DrawFrame(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Rect& dstRect, const Texture* pTexture, s32 row, s32 col, f32 angle = 0.0f, SDL_RendererFlip flip = SDL_FLIP_NONE);
     void DrawText(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Rect& dstRect, const char* text, eFontID font = FONT_REGULAR);
     void FillRect(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Rect& dstRect);
     void DrawRect(s32 renderMode, s32 zIndex, b32 bHUD, const SDL_Rect& dstRect);
 
+    /** Chunk of tilemap, dstRect is its corner in world */
+    void DrawTiles(s32 renderMode, s32 zIndex, const SDL_Rect& dstRect, TileMesh* pMesh);
+
     forceinline void UnitsToPixels(f32& x, f32& y) const { x *= m_pixelsPerUnitX; y *= m_pixelsPerUnitY; }
     forceinline f32 UnitsToPixelsX(f32 x) const { return x * m_pixelsPerUnitX; }
     forceinline f32 UnitsToPixelsY(f32 y) const { return y * m_pixelsPerUnitY; }
@@ -97,13 +278,45 @@ public:
     forceinline const SDL_Color& GetDrawColor() const { return m_drawColor; }
     forceinline void SetDrawColor(u8 r, u8 g, u8 b, u8 a) { m_drawColor = { r, g, b, a }; }
 
+    /** Milliseconds spent on recording, submitting on render thread and waiting for free frame */
+    forceinline f32 GetRecordTime() const { return m_recordTime; }
+    forceinline f32 GetSubmitTime() { return (f32)SDL_AtomicGet(&m_submitTime) * 0.001f; }
+    forceinline f32 GetWaitTime() const { return m_waitTime; }
+    forceinline b32 IsThreaded() const { return m_pRenderThread != nullptr; }
+
 private:
+    static s32 SDLCALL RenderMain(void* pData);
+    static void CreateRenderer(void* pUserdata);
+    static void CreateTexture(void* pUserdata);
+    static void DestroyTextures(void* pUserdata);
+
+    void PushTask(const RenderTask& task);
+    b32 PopTask(RenderTask& task);
+
+    void SubmitFrame(RenderFrame& frame);
+    void RenderLayers(const RenderFrame& frame);
     void RenderQueue(const TList<RenderElement*>& queue) const;
-    void CleanQueues();
+
+    /** False if screen target can't be used, then frame has to be rendered as usual */
+    b32 RenderPartial(const RenderFrame& frame);
+    void RecordDrawn(const TList<RenderElement*>& queue);
+    void AddDirtyRect(const SDL_Rect& rect);
+    void ReleaseScreenTarget();
+
+    /** False if layer can't be cached now, then it has to be rendered as usual */
+    b32 RenderCachedQueue(const TList<RenderElement*>& queue, LayerCache& cache, const RenderFrame& frame);
+    void RenderChunk(const TList<RenderElement*>& queue, const LayerChunk& chunk, const RenderFrame& frame);
+    LayerChunk* FindChunk(LayerCache& cache, s32 x, s32 y);
+    void InvalidateCache(LayerCache& cache);
+    void ReleaseCache(LayerCache& cache);
+    void CleanFrame(RenderFrame& frame);
     void CleanQueue(TList<RenderElement*>& queue);
 
+    void QueueOverdraw(RenderFrame& frame);
+    void AddOverdraw(const TList<RenderElement*>& queue);
+
     b32 CheckAndCorrectDest(SDL_Rect& dest, b32 bHUD);
-    void PushRenderElement(s32 renderMode, RenderElement* pElement);
+    void PushRenderElement(s32 renderMode, b32 bHUD, RenderElement* pElement);
     void QueueElement(TList<RenderElement*>& queue, RenderElement* pElement);
 };
 
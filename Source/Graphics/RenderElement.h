@@ -6,16 +6,29 @@
 #include "Engine/Types.h"
 #include "Graphics/GraphicsModule.h"
 #include "Graphics/Texture.h"
+#include "Graphics/Tilemap.h"
+
+forceinline u64 HashCombine(u64 hash, u64 value)
+{
+    return hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+}
 
 struct RenderElement
 {
     s32 zIndex;
     SDL_Rect dest;
+    b32 bHUD;
 
-    RenderElement(s32 _zIndex, const SDL_Rect& _dest) : zIndex(_zIndex), dest(_dest) {}
+    RenderElement(s32 _zIndex, const SDL_Rect& _dest) : zIndex(_zIndex), dest(_dest), bHUD(false) {}
     virtual ~RenderElement() = default;
 
     virtual void Render() = 0;
+
+    /** Screen area element may touch */
+    virtual SDL_Rect GetBounds() const { return dest; }
+
+    /** Everything that affects look except destination, used to find out if cached layer changed */
+    virtual u64 Hash() const = 0;
 };
 
 struct RenderElementFrame final : public RenderElement
@@ -36,6 +49,28 @@ struct RenderElementFrame final : public RenderElement
 
         // Blit
         SDL_RenderCopyEx(g_graphicsModule.GetRenderer(), pTexture->pTexture, &srcRect, &dest, angle, nullptr, flip);
+        g_graphicsModule.CountDrawCall(pTexture->pTexture);
+    }
+
+    virtual SDL_Rect GetBounds() const override
+    {
+        if (angle == 0.0f)
+        {
+            return dest;
+        }
+
+        // Rotated sprite stays inside circle around center
+        s32 extent = (dest.w + dest.h) / 2;
+        return { dest.x + dest.w / 2 - extent, dest.y + dest.h / 2 - extent, extent * 2, extent * 2 };
+    }
+
+    virtual u64 Hash() const override
+    {
+        u32 angleBits;
+        std::memcpy(&angleBits, &angle, sizeof(angleBits));
+
+        u64 hash = HashCombine((u64)(uintptr_t)pTexture, ((u64)(u32)row << 32) | (u32)col);
+        return HashCombine(hash, ((u64)angleBits << 32) | (u32)flip);
     }
 };
 
@@ -65,9 +100,10 @@ public:
     {
         // Create text surface and convert to texture
         SDL_Surface* pSurface = TTF_RenderText_Blended(pFont, text, color);
+        g_graphicsModule.CountTextRasterization();
         if (!pSurface)
         {
-            g_debugLogMgr.AddNote(CHANNEL_GRAPHICS, PR_WARNING, "RenderElementText", "Can't create surface: %s", TTF_GetError());
+            LogNote(CHANNEL_GRAPHICS, PR_WARNING, "RenderElementText", "Can't create surface: %s", TTF_GetError());
             return;
         }
 
@@ -75,17 +111,28 @@ public:
         if (!pTexture)
         {
             SDL_FreeSurface(pSurface);
-            g_debugLogMgr.AddNote(CHANNEL_GRAPHICS, PR_WARNING, "RenderElementText", "Can't create texture from surface: %s", TTF_GetError());
+            LogNote(CHANNEL_GRAPHICS, PR_WARNING, "RenderElementText", "Can't create texture from surface: %s", TTF_GetError());
             return;
         }
 
         // Copy to screen
         SDL_RenderCopy(g_graphicsModule.GetRenderer(), pTexture, nullptr, &dest);
+        g_graphicsModule.CountDrawCall(pTexture);
 
         // Free memory
         SDL_FreeSurface(pSurface);
         SDL_DestroyTexture(pTexture);
     }
+
+    virtual u64 Hash() const override
+    {
+        u64 hash = HashCombine((u64)(uintptr_t)pFont, ((u64)color.r << 24) | ((u64)color.g << 16) | ((u64)color.b << 8) | color.a);
+        for (const char* p = text; *p; ++p)
+        {
+            hash = HashCombine(hash, (u8)*p);
+        }
+        return hash;
+    }
 };
 
 struct RenderElementRect final : public RenderElement
@@ -108,7 +155,65 @@ struct RenderElementRect final : public RenderElement
         {
         case ACTION_FILL: SDL_RenderFillRect(g_graphicsModule.GetRenderer(), &dest); break;
         case ACTION_DRAW: SDL_RenderDrawRect(g_graphicsModule.GetRenderer(), &dest); break;
-        default: g_debugLogMgr.AddNote(CHANNEL_GRAPHICS, PR_WARNING, "RenderElementRect", "Unknown action %d", action); break;
+        default: LogNote(CHANNEL_GRAPHICS, PR_WARNING, "RenderElementRect", "Unknown action %d", action); return;
+        }
+
+        g_graphicsModule.CountDrawCall(nullptr);
+    }
+
+    virtual u64 Hash() const override
+    {
+        return HashCombine((u64)action, ((u64)color.r << 24) | ((u64)color.g << 16) | ((u64)color.b << 8) | color.a);
+    }
+};
+
+struct RenderElementTiles final : public RenderElement
+{
+    TileMesh* pMesh;
+
+    RenderElementTiles(s32 zIndex, const SDL_Rect& dest, TileMesh* _pMesh) :
+        RenderElement(zIndex, dest), pMesh(_pMesh)
+    {
+        pMesh->Retain();
+    }
+
+    ~RenderElementTiles()
+    {
+        pMesh->Release();
+    }
+
+    virtual void Render() override
+    {
+#ifdef TILEMAP_GEOMETRY
+        // Move chunk quads to destination, only render thread uses this buffer
+        static SDL_Vertex s_aVertices[TILE_CHUNK_TILES * 4];
+
+        s32 vertexCount = pMesh->quadCount * 4;
+        for (i32f i = 0; i < vertexCount; ++i)
+        {
+            s_aVertices[i] = pMesh->aVertices[i];
+            s_aVertices[i].position.x += (f32)dest.x;
+            s_aVertices[i].position.y += (f32)dest.y;
         }
+
+        SDL_RenderGeometry(g_graphicsModule.GetRenderer(), pMesh->pAtlas->pTexture, s_aVertices, vertexCount,
+                           g_tilemap.GetQuadIndices(), pMesh->quadCount * 6);
+        g_graphicsModule.CountDrawCall(pMesh->pAtlas->pTexture);
+#else
+        for (i32f i = 0; i < pMesh->quadCount; ++i)
+        {
+            SDL_Rect tileDest = pMesh->aDst[i];
+            tileDest.x += dest.x;
+            tileDest.y += dest.y;
+
+            SDL_RenderCopy(g_graphicsModule.GetRenderer(), pMesh->pAtlas->pTexture, &pMesh->aSrc[i], &tileDest);
+            g_graphicsModule.CountDrawCall(pMesh->pAtlas->pTexture);
+        }
+#endif
+    }
+
+    virtual u64 Hash() const override
+    {
+        return HashCombine((u64)(uintptr_t)pMesh->pAtlas, pMesh->version);
     }
 };
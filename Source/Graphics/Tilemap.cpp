@@ -0,0 +1,706 @@
+#include "Engine/StdHeaders.h"
+#include "Engine/MemoryTracker.h"
+#include "Math/Math.h"
+#include "Graphics/Tilemap.h"
+
+/**
+ * Level file, little-endian:
+ *   TilemapHeader
+ *   TilemapLayerHeader * layerCount
+ *   u32 offset of every chunk from file start, layer by layer, row by row, 0 for empty chunk
+ *   u16 * TILE_CHUNK_TILES for every non-empty chunk
+ */
+static constexpr char TILEMAP_MAGIC[4] = { 'G', 'T', 'T', 'M' };
+static constexpr u32 TILEMAP_VERSION = 1;
+
+struct TilemapHeader
+{
+    char magic[4];
+    u32 version;
+    u32 width, height;
+    f32 tileUnitsX, tileUnitsY;
+    u32 layerCount;
+    u32 chunkSize;
+};
+
+struct TilemapLayerHeader
+{
+    s32 renderMode;
+    s32 zIndex;
+};
+
+internal b32 IsEmptyChunk(const u16* pTiles)
+{
+    for (i32f i = 0; pTiles && i < TILE_CHUNK_TILES; ++i)
+    {
+        if (pTiles[i] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TileMesh::TileMesh(const Texture* _pAtlas, s32 _quadCount, u32 _version)
+{
+    SDL_AtomicSet(&refCount, 1);
+    version = _version;
+    pAtlas = _pAtlas;
+    quadCount = _quadCount;
+
+#ifdef TILEMAP_GEOMETRY
+    aVertices = new SDL_Vertex[quadCount * 4];
+#else
+    aSrc = new SDL_Rect[quadCount];
+    aDst = new SDL_Rect[quadCount];
+#endif
+
+    pNext = nullptr;
+}
+
+TileMesh::~TileMesh()
+{
+#ifdef TILEMAP_GEOMETRY
+    delete[] aVertices;
+#else
+    delete[] aSrc;
+    delete[] aDst;
+#endif
+}
+
+void Tilemap::StartUp()
+{
+    m_tilesetCount = 0;
+    m_layerCount = 0;
+    m_width = m_height = 0;
+    m_chunksX = m_chunksY = 0;
+    m_apBuilt = nullptr;
+    m_builtCount = 0;
+    m_drawCount = 0;
+    m_meshVersion = 0;
+
+    // Two triangles per quad
+    m_aQuadIndices = new s32[TILE_CHUNK_TILES * 6];
+    for (i32f i = 0; i < TILE_CHUNK_TILES; ++i)
+    {
+        m_aQuadIndices[i * 6 + 0] = (s32)(i * 4 + 0);
+        m_aQuadIndices[i * 6 + 1] = (s32)(i * 4 + 1);
+        m_aQuadIndices[i * 6 + 2] = (s32)(i * 4 + 2);
+        m_aQuadIndices[i * 6 + 3] = (s32)(i * 4 + 0);
+        m_aQuadIndices[i * 6 + 4] = (s32)(i * 4 + 2);
+        m_aQuadIndices[i * 6 + 5] = (s32)(i * 4 + 3);
+    }
+
+    AddNote(PR_NOTE, "Module started");
+}
+
+void Tilemap::ShutDown()
+{
+    Unload();
+    UndefineTilesets();
+
+    delete[] m_aQuadIndices;
+    m_aQuadIndices = nullptr;
+
+    AddNote(PR_NOTE, "Module shut down");
+}
+
+b32 Tilemap::Create(s32 width, s32 height, f32 tileUnitsX, f32 tileUnitsY, s32 layerCount)
+{
+    Unload();
+    return Allocate(width, height, tileUnitsX, tileUnitsY, layerCount);
+}
+
+b32 Tilemap::Load(const char* path)
+{
+    Unload();
+
+    if (!m_file.Open(path))
+    {
+        AddNote(PR_WARNING, "Can't map tilemap file: %s", path);
+        return false;
+    }
+
+    const u8* pData = m_file.GetData();
+    u64 size = m_file.GetSize();
+
+    // Check header
+    TilemapHeader header;
+    if (size < sizeof(header))
+    {
+        AddNote(PR_WARNING, "Tilemap file is too small: %s", path);
+        m_file.Close();
+        return false;
+    }
+    std::memcpy(&header, pData, sizeof(header));
+
+    if (std::memcmp(header.magic, TILEMAP_MAGIC, sizeof(TILEMAP_MAGIC)) != 0 || header.version != TILEMAP_VERSION ||
+        header.chunkSize != TILE_CHUNK_SIZE)
+    {
+        AddNote(PR_WARNING, "Unsupported tilemap file: %s", path);
+        m_file.Close();
+        return false;
+    }
+
+    // Check sizes before anything is allocated by them
+    if (header.width == 0 || header.width > MAX_SIDE || header.height == 0 || header.height > MAX_SIDE ||
+        header.layerCount == 0 || header.layerCount > MAX_LAYERS)
+    {
+        AddNote(PR_WARNING, "Tilemap file has bad size %ux%u, %u layers: %s", header.width, header.height, header.layerCount, path);
+        m_file.Close();
+        return false;
+    }
+
+    // Layers and chunk table must be in file, chunks themselves may be empty
+    u64 chunkCount = (u64)((header.width + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE) * (u64)((header.height + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE);
+    u64 tableOffset = sizeof(TilemapHeader) + sizeof(TilemapLayerHeader) * (u64)header.layerCount;
+    if (size < tableOffset + sizeof(u32) * chunkCount * (u64)header.layerCount)
+    {
+        AddNote(PR_WARNING, "Tilemap file is truncated: %s", path);
+        m_file.Close();
+        return false;
+    }
+
+    for (u32 i = 0; i < header.layerCount; ++i)
+    {
+        TilemapLayerHeader layer;
+        std::memcpy(&layer, pData + sizeof(TilemapHeader) + sizeof(TilemapLayerHeader) * i, sizeof(layer));
+        if (!IsValidLayer(layer.renderMode, layer.zIndex))
+        {
+            AddNote(PR_WARNING, "Tilemap file has bad layer %u, render mode %d, z index %d: %s", i, layer.renderMode, layer.zIndex, path);
+            m_file.Close();
+            return false;
+        }
+    }
+
+    if (!Allocate((s32)header.width, (s32)header.height, header.tileUnitsX, header.tileUnitsY, (s32)header.layerCount))
+    {
+        m_file.Close();
+        return false;
+    }
+
+    for (i32f i = 0; i < m_layerCount; ++i)
+    {
+        TilemapLayerHeader layer;
+        std::memcpy(&layer, pData + sizeof(TilemapHeader) + sizeof(TilemapLayerHeader) * i, sizeof(layer));
+        SetLayer((s32)i, layer.renderMode, layer.zIndex);
+    }
+
+    // Point chunks right into file, pages are read when chunk is drawn first
+    for (i32f i = 0; i < m_layerCount; ++i)
+    {
+        for (u64 j = 0; j < chunkCount; ++j)
+        {
+            u32 offset;
+            std::memcpy(&offset, pData + tableOffset + sizeof(u32) * (chunkCount * i + j), sizeof(offset));
+            if (offset == 0)
+            {
+                continue;
+            }
+
+            if (offset % alignof(u16) != 0 || offset < tableOffset || (u64)offset + sizeof(u16) * TILE_CHUNK_TILES > size)
+            {
+                AddNote(PR_WARNING, "Tilemap file has broken chunk offset %u: %s", offset, path);
+                Unload();
+                return false;
+            }
+
+            m_aLayers[i].aChunks[j].pTiles = (const u16*)(pData + offset);
+        }
+    }
+
+    AddNote(PR_NOTE, "Tilemap %s loaded, %dx%d tiles, %d layers", path, m_width, m_height, m_layerCount);
+    return true;
+}
+
+b32 Tilemap::Save(const char* path)
+{
+    if (!IsLoaded())
+    {
+        AddNote(PR_WARNING, "Save(): There's no tilemap");
+        return false;
+    }
+
+    // We may write over mapped file
+    Detach();
+
+    std::FILE* hFile = std::fopen(path, "wb");
+    if (!hFile)
+    {
+        AddNote(PR_WARNING, "Can't open tilemap file for writing: %s", path);
+        return false;
+    }
+
+    TilemapHeader header;
+    std::memcpy(header.magic, TILEMAP_MAGIC, sizeof(TILEMAP_MAGIC));
+    header.version = TILEMAP_VERSION;
+    header.width = (u32)m_width;
+    header.height = (u32)m_height;
+    header.tileUnitsX = m_tileUnitsX;
+    header.tileUnitsY = m_tileUnitsY;
+    header.layerCount = (u32)m_layerCount;
+    header.chunkSize = TILE_CHUNK_SIZE;
+
+    b32 bWritten = std::fwrite(&header, sizeof(header), 1, hFile) == 1;
+
+    for (i32f i = 0; i < m_layerCount && bWritten; ++i)
+    {
+        TilemapLayerHeader layer = { m_aLayers[i].renderMode, m_aLayers[i].zIndex };
+        bWritten = std::fwrite(&layer, sizeof(layer), 1, hFile) == 1;
+    }
+
+    // Chunk table, empty chunks aren't stored
+    s32 chunkCount = m_chunksX * m_chunksY;
+    u32 offset = (u32)(sizeof(TilemapHeader) + sizeof(TilemapLayerHeader) * m_layerCount + sizeof(u32) * chunkCount * m_layerCount);
+
+    for (i32f i = 0; i < m_layerCount && bWritten; ++i)
+    {
+        for (i32f j = 0; j < chunkCount && bWritten; ++j)
+        {
+            const u16* pTiles = m_aLayers[i].aChunks[j].pTiles;
+            b32 bEmpty = IsEmptyChunk(pTiles);
+
+            u32 chunkOffset = bEmpty ? 0 : offset;
+            if (!bEmpty)
+            {
+                offset += sizeof(u16) * TILE_CHUNK_TILES;
+            }
+
+            bWritten = std::fwrite(&chunkOffset, sizeof(chunkOffset), 1, hFile) == 1;
+        }
+    }
+
+    // Chunks in the same order
+    for (i32f i = 0; i < m_layerCount && bWritten; ++i)
+    {
+        for (i32f j = 0; j < chunkCount && bWritten; ++j)
+        {
+            const u16* pTiles = m_aLayers[i].aChunks[j].pTiles;
+            b32 bEmpty = IsEmptyChunk(pTiles);
+
+            if (!bEmpty)
+            {
+                bWritten = std::fwrite(pTiles, sizeof(u16), TILE_CHUNK_TILES, hFile) == TILE_CHUNK_TILES;
+            }
+        }
+    }
+
+    std::fclose(hFile);
+
+    if (!bWritten)
+    {
+        AddNote(PR_WARNING, "Can't write tilemap file: %s", path);
+        return false;
+    }
+
+    AddNote(PR_NOTE, "Tilemap saved to %s", path);
+    return true;
+}
+
+void Tilemap::Unload()
+{
+    for (i32f i = 0; i < m_layerCount; ++i)
+    {
+        s32 chunkCount = m_chunksX * m_chunksY;
+        for (i32f j = 0; j < chunkCount; ++j)
+        {
+            ReleaseMeshes(m_aLayers[i].aChunks[j]);
+            delete[] m_aLayers[i].aChunks[j].aOwned;
+        }
+
+        delete[] m_aLayers[i].aChunks;
+        m_aLayers[i].aChunks = nullptr;
+    }
+
+    delete[] m_apBuilt;
+    m_apBuilt = nullptr;
+    m_builtCount = 0;
+
+    m_file.Close();
+
+    m_layerCount = 0;
+    m_width = m_height = 0;
+    m_chunksX = m_chunksY = 0;
+}
+
+u16 Tilemap::DefineTileset(const Texture* pAtlas)
+{
+    if (!pAtlas || pAtlas->spriteWidth <= 0 || pAtlas->spriteHeight <= 0)
+    {
+        AddNote(PR_WARNING, "DefineTileset(): Bad atlas");
+        return 0;
+    }
+    if (m_tilesetCount >= MAX_TILESETS)
+    {
+        AddNote(PR_WARNING, "DefineTileset(): There're already %d tilesets", MAX_TILESETS);
+        return 0;
+    }
+
+    // Tiles go after previous tileset
+    s32 firstTile = 1;
+    if (m_tilesetCount > 0)
+    {
+        const Tileset& last = m_aTilesets[m_tilesetCount - 1];
+        firstTile = last.firstTile + last.count;
+    }
+
+    s32 columns = pAtlas->textureWidth / pAtlas->spriteWidth;
+    s32 count = columns * (pAtlas->textureHeight / pAtlas->spriteHeight);
+    if (count <= 0 || firstTile + count > 0xFFFF)
+    {
+        AddNote(PR_WARNING, "DefineTileset(): Atlas has no room for %d tiles", count);
+        return 0;
+    }
+
+    Tileset& tileset = m_aTilesets[m_tilesetCount++];
+    tileset.pAtlas = pAtlas;
+    tileset.firstTile = (u16)firstTile;
+    tileset.count = (u16)count;
+    tileset.columns = columns;
+
+    // Tiles which were unknown may be drawn now
+    MarkDirty();
+
+    return tileset.firstTile;
+}
+
+void Tilemap::UndefineTilesets()
+{
+    m_tilesetCount = 0;
+    MarkDirty();
+}
+
+void Tilemap::SetLayer(s32 layer, s32 renderMode, s32 zIndex)
+{
+    if (layer < 0 || layer >= m_layerCount)
+    {
+        AddNote(PR_WARNING, "SetLayer(): There's no layer %d", layer);
+        return;
+    }
+
+    if (!IsValidLayer(renderMode, zIndex))
+    {
+        AddNote(PR_WARNING, "SetLayer(): Bad render mode %d or z index %d", renderMode, zIndex);
+        return;
+    }
+
+    m_aLayers[layer].renderMode = renderMode;
+    m_aLayers[layer].zIndex = zIndex;
+}
+
+b32 Tilemap::IsValidLayer(s32 renderMode, s32 zIndex)
+{
+    return renderMode >= 0 && renderMode < RENDER_MODE_COUNT && zIndex >= -MAX_Z_INDEX && zIndex <= MAX_Z_INDEX;
+}
+
+void Tilemap::SetTile(s32 layer, s32 x, s32 y, u16 tile)
+{
+    if (!IsInside(layer, x, y))
+    {
+        return;
+    }
+
+    Chunk& chunk = GetChunk(layer, x / TILE_CHUNK_SIZE, y / TILE_CHUNK_SIZE);
+    s32 index = (y % TILE_CHUNK_SIZE) * TILE_CHUNK_SIZE + (x % TILE_CHUNK_SIZE);
+
+    if ((chunk.pTiles ? chunk.pTiles[index] : 0) == tile)
+    {
+        return;
+    }
+
+    // Copy on first write
+    if (!chunk.aOwned)
+    {
+        chunk.aOwned = new u16[TILE_CHUNK_TILES];
+        if (chunk.pTiles)
+        {
+            std::memcpy(chunk.aOwned, chunk.pTiles, sizeof(u16) * TILE_CHUNK_TILES);
+        }
+        else
+        {
+            std::memset(chunk.aOwned, 0, sizeof(u16) * TILE_CHUNK_TILES);
+        }
+        chunk.pTiles = chunk.aOwned;
+    }
+
+    chunk.aOwned[index] = tile;
+    chunk.bDirty = true;
+}
+
+u16 Tilemap::GetTile(s32 layer, s32 x, s32 y) const
+{
+    if (!IsInside(layer, x, y))
+    {
+        return 0;
+    }
+
+    const Chunk& chunk = GetChunk(layer, x / TILE_CHUNK_SIZE, y / TILE_CHUNK_SIZE);
+    return chunk.pTiles ? chunk.pTiles[(y % TILE_CHUNK_SIZE) * TILE_CHUNK_SIZE + (x % TILE_CHUNK_SIZE)] : 0;
+}
+
+b32 Tilemap::GetTileCoords(f32 x, f32 y, s32& tileX, s32& tileY) const
+{
+    if (!IsLoaded())
+    {
+        return false;
+    }
+
+    tileX = (s32)std::floor(x / m_tileWidth);
+    tileY = (s32)std::floor(y / m_tileHeight);
+
+    return IsInside(0, tileX, tileY);
+}
+
+void Tilemap::Draw()
+{
+    if (!IsLoaded())
+    {
+        return;
+    }
+
+    ++m_drawCount;
+
+    // Chunks around camera
+    s32 cameraX, cameraY;
+    g_graphicsModule.GetCamera().GetPosition(cameraX, cameraY);
+
+    f32 chunkWidth = m_tileWidth * TILE_CHUNK_SIZE;
+    f32 chunkHeight = m_tileHeight * TILE_CHUNK_SIZE;
+
+    s32 firstX = Math::Max((s32)std::floor((f32)cameraX / chunkWidth), 0);
+    s32 firstY = Math::Max((s32)std::floor((f32)cameraY / chunkHeight), 0);
+    s32 lastX = Math::Min((s32)std::floor((f32)(cameraX + g_graphicsModule.GetScreenWidth()) / chunkWidth), m_chunksX - 1);
+    s32 lastY = Math::Min((s32)std::floor((f32)(cameraY + g_graphicsModule.GetScreenHeight()) / chunkHeight), m_chunksY - 1);
+
+    for (i32f layer = 0; layer < m_layerCount; ++layer)
+    {
+        for (s32 y = firstY; y <= lastY; ++y)
+        {
+            for (s32 x = firstX; x <= lastX; ++x)
+            {
+                Chunk& chunk = GetChunk((s32)layer, x, y);
+                if (!chunk.pTiles)
+                {
+                    continue;
+                }
+
+                if (!chunk.bBuilt || chunk.bDirty)
+                {
+                    BuildChunk(chunk);
+                }
+                chunk.lastDrawn = m_drawCount;
+
+                // Chunk rect, quads are relative to its corner
+                s32 left = (s32)(x * TILE_CHUNK_SIZE * m_tileWidth + 0.5f);
+                s32 top = (s32)(y * TILE_CHUNK_SIZE * m_tileHeight + 0.5f);
+                SDL_Rect dest = {
+                    left, top,
+                    (s32)((x + 1) * TILE_CHUNK_SIZE * m_tileWidth + 0.5f) - left,
+                    (s32)((y + 1) * TILE_CHUNK_SIZE * m_tileHeight + 0.5f) - top
+                };
+
+                for (TileMesh* pMesh = chunk.pMeshes; pMesh; pMesh = pMesh->pNext)
+                {
+                    g_graphicsModule.DrawTiles(m_aLayers[layer].renderMode, m_aLayers[layer].zIndex, dest, pMesh);
+                }
+            }
+        }
+    }
+
+    ReleaseStaleMeshes();
+}
+
+b32 Tilemap::Allocate(s32 width, s32 height, f32 tileUnitsX, f32 tileUnitsY, s32 layerCount)
+{
+    MemoryScope scope(MEMORY_GRAPHICS);
+
+    if (width <= 0 || width > MAX_SIDE || height <= 0 || height > MAX_SIDE ||
+        !(tileUnitsX > 0.0f) || !(tileUnitsY > 0.0f) || layerCount <= 0 || layerCount > MAX_LAYERS)
+    {
+        AddNote(PR_WARNING, "Bad tilemap %dx%d, tile %.2fx%.2f, %d layers", width, height, tileUnitsX, tileUnitsY, layerCount);
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_chunksX = (width + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+    m_chunksY = (height + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+
+    m_tileUnitsX = tileUnitsX;
+    m_tileUnitsY = tileUnitsY;
+    m_tileWidth = g_graphicsModule.UnitsToPixelsX(tileUnitsX);
+    m_tileHeight = g_graphicsModule.UnitsToPixelsY(tileUnitsY);
+
+    s32 chunkCount = m_chunksX * m_chunksY;
+    m_layerCount = layerCount;
+    for (i32f i = 0; i < m_layerCount; ++i)
+    {
+        m_aLayers[i].renderMode = RENDER_MODE_BACKGROUND;
+        m_aLayers[i].zIndex = (s32)i;
+        m_aLayers[i].aChunks = new Chunk[chunkCount];
+        std::memset(m_aLayers[i].aChunks, 0, sizeof(Chunk) * chunkCount);
+    }
+
+    m_apBuilt = new Chunk*[chunkCount * m_layerCount];
+    m_builtCount = 0;
+
+    return true;
+}
+
+void Tilemap::Detach()
+{
+    if (!m_file.IsOpen())
+    {
+        return;
+    }
+
+    s32 chunkCount = m_chunksX * m_chunksY;
+    for (i32f i = 0; i < m_layerCount; ++i)
+    {
+        for (i32f j = 0; j < chunkCount; ++j)
+        {
+            Chunk& chunk = m_aLayers[i].aChunks[j];
+            if (chunk.pTiles && !chunk.aOwned)
+            {
+                chunk.aOwned = new u16[TILE_CHUNK_TILES];
+                std::memcpy(chunk.aOwned, chunk.pTiles, sizeof(u16) * TILE_CHUNK_TILES);
+                chunk.pTiles = chunk.aOwned;
+            }
+        }
+    }
+
+    m_file.Close();
+}
+
+void Tilemap::BuildChunk(Chunk& chunk)
+{
+    if (!chunk.bBuilt)
+    {
+        m_apBuilt[m_builtCount++] = &chunk;
+    }
+
+    ReleaseMeshes(chunk);
+    chunk.bBuilt = true;
+    chunk.bDirty = false;
+
+    // Count quads of every tileset
+    s32 aCounts[MAX_TILESETS] = {};
+    for (i32f i = 0; i < TILE_CHUNK_TILES; ++i)
+    {
+        const Tileset* pTileset = FindTileset(chunk.pTiles[i]);
+        if (pTileset)
+        {
+            ++aCounts[pTileset - m_aTilesets];
+        }
+    }
+
+    TileMesh* apMeshes[MAX_TILESETS] = {};
+    for (i32f i = 0; i < m_tilesetCount; ++i)
+    {
+        if (aCounts[i] > 0)
+        {
+            apMeshes[i] = new TileMesh(m_aTilesets[i].pAtlas, aCounts[i], ++m_meshVersion);
+            apMeshes[i]->pNext = chunk.pMeshes;
+            chunk.pMeshes = apMeshes[i];
+            aCounts[i] = 0;
+        }
+    }
+
+    // Fill quads, rounded the same way as chunk rect so there're no seams
+    for (i32f i = 0; i < TILE_CHUNK_TILES; ++i)
+    {
+        const Tileset* pTileset = FindTileset(chunk.pTiles[i]);
+        if (!pTileset)
+        {
+            continue;
+        }
+
+        s32 set = (s32)(pTileset - m_aTilesets);
+        TileMesh* pMesh = apMeshes[set];
+        s32 quad = aCounts[set]++;
+
+        s32 tileX = (s32)(i % TILE_CHUNK_SIZE);
+        s32 tileY = (s32)(i / TILE_CHUNK_SIZE);
+        f32 x1 = std::floor(tileX * m_tileWidth + 0.5f);
+        f32 y1 = std::floor(tileY * m_tileHeight + 0.5f);
+        f32 x2 = std::floor((tileX + 1) * m_tileWidth + 0.5f);
+        f32 y2 = std::floor((tileY + 1) * m_tileHeight + 0.5f);
+
+        const Texture* pAtlas = pTileset->pAtlas;
+        s32 sprite = chunk.pTiles[i] - pTileset->firstTile;
+        s32 srcX = (sprite % pTileset->columns) * pAtlas->spriteWidth;
+        s32 srcY = (sprite / pTileset->columns) * pAtlas->spriteHeight;
+
+#ifdef TILEMAP_GEOMETRY
+        f32 u1 = (f32)srcX / (f32)pAtlas->textureWidth;
+        f32 v1 = (f32)srcY / (f32)pAtlas->textureHeight;
+        f32 u2 = (f32)(srcX + pAtlas->spriteWidth) / (f32)pAtlas->textureWidth;
+        f32 v2 = (f32)(srcY + pAtlas->spriteHeight) / (f32)pAtlas->textureHeight;
+
+        SDL_Vertex* aVertices = &pMesh->aVertices[quad * 4];
+        aVertices[0] = { { x1, y1 }, { 0xFF, 0xFF, 0xFF, 0xFF }, { u1, v1 } };
+        aVertices[1] = { { x2, y1 }, { 0xFF, 0xFF, 0xFF, 0xFF }, { u2, v1 } };
+        aVertices[2] = { { x2, y2 }, { 0xFF, 0xFF, 0xFF, 0xFF }, { u2, v2 } };
+        aVertices[3] = { { x1, y2 }, { 0xFF, 0xFF, 0xFF, 0xFF }, { u1, v2 } };
+#else
+        pMesh->aSrc[quad] = { srcX, srcY, pAtlas->spriteWidth, pAtlas->spriteHeight };
+        pMesh->aDst[quad] = { (s32)x1, (s32)y1, (s32)(x2 - x1), (s32)(y2 - y1) };
+#endif
+    }
+}
+
+void Tilemap::ReleaseMeshes(Chunk& chunk)
+{
+    TileMesh* pMesh = chunk.pMeshes;
+    while (pMesh)
+    {
+        TileMesh* pNext = pMesh->pNext;
+        pMesh->Release();
+        pMesh = pNext;
+    }
+    chunk.pMeshes = nullptr;
+}
+
+void Tilemap::ReleaseStaleMeshes()
+{
+    for (i32f i = 0; i < m_builtCount; )
+    {
+        Chunk& chunk = *m_apBuilt[i];
+        if (m_drawCount - chunk.lastDrawn > MESH_LIFETIME)
+        {
+            ReleaseMeshes(chunk);
+            chunk.bBuilt = false;
+            m_apBuilt[i] = m_apBuilt[--m_builtCount];
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void Tilemap::MarkDirty()
+{
+    for (i32f i = 0; i < m_builtCount; ++i)
+    {
+        m_apBuilt[i]->bDirty = true;
+    }
+}
+
+const Tilemap::Tileset* Tilemap::FindTileset(u16 tile) const
+{
+    if (tile == 0)
+    {
+        return nullptr;
+    }
+
+    for (i32f i = 0; i < m_tilesetCount; ++i)
+    {
+        if (tile >= m_aTilesets[i].firstTile && tile < m_aTilesets[i].firstTile + m_aTilesets[i].count)
+        {
+            return &m_aTilesets[i];
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "SDL.h"
+#include "Engine/EngineModule.h"
+#include "Engine/MappedFile.h"
+#include "Graphics/GraphicsModule.h"
+#include "Graphics/Texture.h"
+
+/** SDL_RenderGeometry() appeared in 2.0.18, older SDL copies tiles one by one */
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    #define TILEMAP_GEOMETRY
+#endif
+
+/** Chunk side in tiles */
+static constexpr i32f TILE_CHUNK_SIZE = 16;
+static constexpr i32f TILE_CHUNK_TILES = TILE_CHUNK_SIZE * TILE_CHUNK_SIZE;
+
+/**
+ * Prebuilt quads of one chunk with one atlas, in chunk space.
+ * Frames in flight hold references, so chunk may rebuild it
+ * while render thread still draws the old one
+ */
+struct TileMesh
+{
+    SDL_atomic_t refCount;
+    u32 version;
+    const Texture* pAtlas;
+    s32 quadCount;
+
+#ifdef TILEMAP_GEOMETRY
+    SDL_Vertex* aVertices;
+#else
+    SDL_Rect* aSrc;
+    SDL_Rect* aDst;
+#endif
+
+    /** Next mesh of the same chunk */
+    TileMesh* pNext;
+
+    TileMesh(const Texture* _pAtlas, s32 _quadCount, u32 _version);
+    ~TileMesh();
+
+    forceinline void Retain() { SDL_AtomicAdd(&refCount, 1); }
+    forceinline void Release() { if (SDL_AtomicAdd(&refCount, -1) == 1) delete this; }
+};
+
+/**
+ * Tile layers split into chunks. Level files are mapped into
+ * memory and chunks point right into them until they're changed.
+ * Tile 0 is empty, others come from tilesets' atlases
+ */
+class Tilemap final : public EngineModule
+{
+    static constexpr i32f MAX_TILESETS = 16;
+    static constexpr i32f MAX_LAYERS = 4;
+
+    /** In tiles, so chunk counts stay far from s32 overflow */
+    static constexpr i32f MAX_SIDE = 16384;
+
+    /** Dynamic layers add pixel y to z index, so it's kept far from overflow */
+    static constexpr i32f MAX_Z_INDEX = 65536;
+
+    /** Meshes of chunks which weren't drawn for this count of frames are freed */
+    static constexpr i32f MESH_LIFETIME = 120;
+
+    struct Tileset
+    {
+        const Texture* pAtlas;
+        u16 firstTile;
+        u16 count;
+        s32 columns;
+    };
+
+    struct Chunk
+    {
+        /** Into mapped file or aOwned, null if chunk is empty */
+        const u16* pTiles;
+        u16* aOwned;
+
+        TileMesh* pMeshes;
+        b32 bDirty;
+        b32 bBuilt;
+        u32 lastDrawn;
+    };
+
+    struct Layer
+    {
+        s32 renderMode;
+        s32 zIndex;
+        Chunk* aChunks;
+    };
+
+private:
+    Tileset m_aTilesets[MAX_TILESETS];
+    s32 m_tilesetCount;
+
+    Layer m_aLayers[MAX_LAYERS];
+    s32 m_layerCount;
+
+    /** In tiles */
+    s32 m_width, m_height;
+    s32 m_chunksX, m_chunksY;
+
+    /** Tile size in units is what goes to file, pixels are for drawing */
+    f32 m_tileUnitsX, m_tileUnitsY;
+    f32 m_tileWidth, m_tileHeight;
+
+    MappedFile m_file;
+
+    /** Chunks which have meshes */
+    Chunk** m_apBuilt;
+    s32 m_builtCount;
+
+    u32 m_drawCount;
+    u32 m_meshVersion;
+
+    /** Same for every mesh, quad after quad */
+    s32* m_aQuadIndices;
+
+public:
+    Tilemap() : EngineModule("Tilemap", CHANNEL_GRAPHICS) {}
+
+    void StartUp();
+    void ShutDown();
+
+    /** Size in tiles, tile size in units */
+    b32 Create(s32 width, s32 height, f32 tileUnitsX, f32 tileUnitsY, s32 layerCount);
+    b32 Load(const char* path);
+    b32 Save(const char* path);
+    void Unload();
+
+    /** Next tiles are atlas' sprites row by row, returns first of them or 0 on error */
+    u16 DefineTileset(const Texture* pAtlas);
+    void UndefineTilesets();
+
+    void SetLayer(s32 layer, s32 renderMode, s32 zIndex);
+    void SetTile(s32 layer, s32 x, s32 y, u16 tile);
+    u16 GetTile(s32 layer, s32 x, s32 y) const;
+
+    /** Pixels to tile, false if outside of map */
+    b32 GetTileCoords(f32 x, f32 y, s32& tileX, s32& tileY) const;
+
+    /** Queues chunks around camera */
+    void Draw();
+
+    forceinline b32 IsLoaded() const { return m_layerCount > 0; }
+    forceinline s32 GetWidth() const { return m_width; }
+    forceinline s32 GetHeight() const { return m_height; }
+    forceinline s32 GetLayerCount() const { return m_layerCount; }
+    forceinline f32 GetTileWidth() const { return m_tileWidth; }
+    forceinline f32 GetTileHeight() const { return m_tileHeight; }
+    forceinline const s32* GetQuadIndices() const { return m_aQuadIndices; }
+
+private:
+    b32 Allocate(s32 width, s32 height, f32 tileUnitsX, f32 tileUnitsY, s32 layerCount);
+
+    /** Copies mapped chunks into memory and closes file */
+    void Detach();
+
+    void BuildChunk(Chunk& chunk);
+    void ReleaseMeshes(Chunk& chunk);
+    void ReleaseStaleMeshes();
+    void MarkDirty();
+
+    const Tileset* FindTileset(u16 tile) const;
+
+    /** Known render mode, z index in [-MAX_Z_INDEX, MAX_Z_INDEX] */
+    static b32 IsValidLayer(s32 renderMode, s32 zIndex);
+
+    forceinline Chunk& GetChunk(s32 layer, s32 chunkX, s32 chunkY) const { return m_aLayers[layer].aChunks[chunkY * m_chunksX + chunkX]; }
+    forceinline b32 IsInside(s32 layer, s32 x, s32 y) const { return layer >= 0 && layer < m_layerCount && x >= 0 && y >= 0 && x < m_width && y < m_height; }
+};
+
+inline Tilemap g_tilemap;
@@ -1,4 +1,5 @@
 #include "Engine/Console.h"
+#include "Graphics/GraphicsModule.h"
 #include "Input/InputModule.h"
 
 void InputModule::StartUp()
@@ -37,6 +38,12 @@ b32 InputModule::HandleEvents()
             OnKeyDown(e);
         } break;
 
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+        {
+            g_graphicsModule.InvalidateLayers();
+        } break;
+
         default: {} break;
         }
     }
@@ -1,8 +1,43 @@
 #include "SDL.h"
+#include "Engine/StdHeaders.h"
 #include "Engine/Engine.h"
+#include "Game/PlayState.h"
 
+/**
+ * Mission script bench instead of the game:
+ *   GT2D -benchScript <path> [-location <location>] [-frames <count>]
+ */
 int main(int argc, char** argv)
 {
-    g_engine.StartUp();
-    return g_engine.Run();
+    // Parse arguments
+    const char* benchPath = nullptr;
+    s32 location = 0;
+    s32 frames = 600;
+
+    for (s32 i = 1; i + 1 < argc; ++i)
+    {
+        const char* arg = argv[i];
+
+        if (std::strcmp(arg, "-benchScript") == 0)
+        {
+            benchPath = argv[++i];
+        }
+        else if (std::strcmp(arg, "-location") == 0)
+        {
+            location = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(arg, "-frames") == 0)
+        {
+            frames = std::atoi(argv[++i]);
+        }
+    }
+
+    if (benchPath && (std::strlen(benchPath) >= PLAYSTATE_PATH_STRSIZE || frames <= 0))
+    {
+        std::fprintf(stderr, "Mission path must be shorter than %d characters, frames must be positive\n", (s32)PLAYSTATE_PATH_STRSIZE);
+        return 1;
+    }
+
+    g_engine.StartUp(benchPath, location);
+    return benchPath ? g_engine.RunScriptBench(benchPath, location, frames) : g_engine.Run();
 }
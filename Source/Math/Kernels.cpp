@@ -0,0 +1,499 @@
+#include "SDL.h"
+#include "Engine/DebugLogManager.h"
+#include "Math/Kernels.h"
+
+/** Scalar kernels over [first, count) range, also finish SIMD tails */
+forceinline internal b32 IsOnGround(const Vector2& vPoint, const FRect& hitBox, const SRect& ground)
+{
+    return vPoint.y + hitBox.y2 >= ground.y1 && vPoint.y + hitBox.y2 <= ground.y2 && vPoint.x + hitBox.x1 >= ground.x1 && vPoint.x + hitBox.x2 <= ground.x2;
+}
+
+internal void IntegrateRange(Vector2* aPosition, const Vector2* aVelocity, const u32* aFlags, u32 flag, f32 scale, s32 first, s32 count)
+{
+    for (i32f i = first; i < count; ++i)
+    {
+        if (aFlags[i] & flag)
+        {
+            aPosition[i] += aVelocity[i] * scale;
+        }
+    }
+}
+
+internal void WalkRange(Vector2* aPosition, const Vector2* aVelocity, const FRect* aHitBox, const b32* abCollidable,
+                        const u32* aFlags, u32 flag, const SRect& ground, s32 first, s32 count)
+{
+    for (i32f i = first; i < count; ++i)
+    {
+        if (!(aFlags[i] & flag))
+        {
+            continue;
+        }
+
+        const Vector2& vVelocity = aVelocity[i];
+        const FRect& hitBox = aHitBox[i];
+
+        Vector2 vNewPosition = aPosition[i] + vVelocity;
+        if (abCollidable[i] && !IsOnGround(vNewPosition, hitBox, ground))
+        {
+            // Try move only through x-axis
+            vNewPosition.y -= vVelocity.y;
+            if (!IsOnGround(vNewPosition, hitBox, ground))
+            {
+                // Try to move only through y-axis
+                vNewPosition.x -= vVelocity.x;
+                vNewPosition.y += vVelocity.y;
+                if (!IsOnGround(vNewPosition, hitBox, ground))
+                {
+                    // So we'll not move...
+                    vNewPosition.y -= vVelocity.y;
+                }
+            }
+        }
+
+        aPosition[i] = vNewPosition;
+    }
+}
+
+internal s32 OverlapRange(const Vector2* aPosition, const FRect* aHitBox, const FRect& rect, s32* aIndices, s32 found, s32 first, s32 count)
+{
+    for (i32f i = first; i < count; ++i)
+    {
+        const Vector2& vPosition = aPosition[i];
+        const FRect& hitBox = aHitBox[i];
+
+        if (vPosition.x + hitBox.x1 > rect.x2) continue;
+        if (vPosition.x + hitBox.x2 < rect.x1) continue;
+        if (vPosition.y + hitBox.y1 > rect.y2) continue;
+        if (vPosition.y + hitBox.y2 < rect.y1) continue;
+
+        aIndices[found++] = (s32)i;
+    }
+
+    return found;
+}
+
+#if defined(SIMD_AVX2)
+
+/**
+ * 8-wide kernels. Vectors and rectangles are transposed inside
+ * 128-bit lanes, so lanes hold entries in 0 1 4 5 2 3 6 7 order
+ */
+struct Box8
+{
+    __m256 x1, y1, x2, y2;
+};
+
+forceinline internal __m256i LaneOrder8(const void* p)
+{
+    return _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)p), _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+}
+
+forceinline internal __m256 FlagMask8(const u32* aFlags, u32 flag)
+{
+    __m256i vFlag = _mm256_set1_epi32((s32)flag);
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(LaneOrder8(aFlags), vFlag), vFlag));
+}
+
+forceinline internal void Load8Vectors(const Vector2* a, __m256& x, __m256& y)
+{
+    __m256 lo = _mm256_loadu_ps(&a[0].x);
+    __m256 hi = _mm256_loadu_ps(&a[4].x);
+    x = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+forceinline internal void Store8Vectors(Vector2* a, const __m256& x, const __m256& y)
+{
+    _mm256_storeu_ps(&a[0].x, _mm256_unpacklo_ps(x, y));
+    _mm256_storeu_ps(&a[4].x, _mm256_unpackhi_ps(x, y));
+}
+
+forceinline internal __m256 LoadRectPair(const FRect* a, s32 lo, s32 hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&a[lo].x1)), _mm_loadu_ps(&a[hi].x1), 1);
+}
+
+forceinline internal void Load8Rects(const FRect* a, Box8& box)
+{
+    __m256 r0 = LoadRectPair(a, 0, 2);
+    __m256 r1 = LoadRectPair(a, 1, 3);
+    __m256 r2 = LoadRectPair(a, 4, 6);
+    __m256 r3 = LoadRectPair(a, 5, 7);
+
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+    box.x1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    box.y1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    box.x2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    box.y2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+forceinline internal __m256 OnGround8(const __m256& x, const __m256& y, const Box8& hitBox, const Box8& ground)
+{
+    __m256 bottom = _mm256_add_ps(y, hitBox.y2);
+    __m256 mask = _mm256_and_ps(_mm256_cmp_ps(bottom, ground.y1, _CMP_GE_OQ), _mm256_cmp_ps(bottom, ground.y2, _CMP_LE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(x, hitBox.x1), ground.x1, _CMP_GE_OQ));
+    return _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(x, hitBox.x2), ground.x2, _CMP_LE_OQ));
+}
+
+#elif defined(SIMD_SSE2)
+
+/** 4-wide kernels */
+struct Box4
+{
+    __m128 x1, y1, x2, y2;
+};
+
+forceinline internal __m128 Select4(const __m128& mask, const __m128& a, const __m128& b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+forceinline internal __m128 FlagMask4(const u32* aFlags, u32 flag)
+{
+    __m128i vFlag = _mm_set1_epi32((s32)flag);
+    __m128i vFlags = _mm_loadu_si128((const __m128i*)aFlags);
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(vFlags, vFlag), vFlag));
+}
+
+forceinline internal void Load4Vectors(const Vector2* a, __m128& x, __m128& y)
+{
+    __m128 lo = _mm_loadu_ps(&a[0].x);
+    __m128 hi = _mm_loadu_ps(&a[2].x);
+    x = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+forceinline internal void Store4Vectors(Vector2* a, const __m128& x, const __m128& y)
+{
+    _mm_storeu_ps(&a[0].x, _mm_unpacklo_ps(x, y));
+    _mm_storeu_ps(&a[2].x, _mm_unpackhi_ps(x, y));
+}
+
+forceinline internal void Load4Rects(const FRect* a, Box4& box)
+{
+    __m128 r0 = _mm_loadu_ps(&a[0].x1);
+    __m128 r1 = _mm_loadu_ps(&a[1].x1);
+    __m128 r2 = _mm_loadu_ps(&a[2].x1);
+    __m128 r3 = _mm_loadu_ps(&a[3].x1);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    box.x1 = r0;
+    box.y1 = r1;
+    box.x2 = r2;
+    box.y2 = r3;
+}
+
+forceinline internal __m128 OnGround4(const __m128& x, const __m128& y, const Box4& hitBox, const Box4& ground)
+{
+    __m128 bottom = _mm_add_ps(y, hitBox.y2);
+    __m128 mask = _mm_and_ps(_mm_cmpge_ps(bottom, ground.y1), _mm_cmple_ps(bottom, ground.y2));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(x, hitBox.x1), ground.x1));
+    return _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(x, hitBox.x2), ground.x2));
+}
+
+#endif
+
+void Kernels::Integrate(Vector2* aPosition, const Vector2* aVelocity, const u32* aFlags, u32 flag, f32 scale, s32 count)
+{
+    i32f i = 0;
+
+#if defined(SIMD_AVX2)
+    __m256 vScale = _mm256_set1_ps(scale);
+    __m256i vFlag = _mm256_set1_epi32((s32)flag);
+
+    for ( ; i + 8 <= count; i += 8)
+    {
+        // Entry mask in natural order, then spread it over x and y
+        __m256i vFlags = _mm256_loadu_si256((const __m256i*)&aFlags[i]);
+        __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(vFlags, vFlag), vFlag);
+        __m256 lo = _mm256_castsi256_ps(_mm256_permutevar8x32_epi32(mask, _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3)));
+        __m256 hi = _mm256_castsi256_ps(_mm256_permutevar8x32_epi32(mask, _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7)));
+
+        f32* p = &aPosition[i].x;
+        const f32* v = &aVelocity[i].x;
+
+        __m256 p0 = _mm256_loadu_ps(p);
+        __m256 p1 = _mm256_loadu_ps(p + 8);
+        __m256 n0 = _mm256_add_ps(p0, _mm256_mul_ps(_mm256_loadu_ps(v), vScale));
+        __m256 n1 = _mm256_add_ps(p1, _mm256_mul_ps(_mm256_loadu_ps(v + 8), vScale));
+
+        _mm256_storeu_ps(p, _mm256_blendv_ps(p0, n0, lo));
+        _mm256_storeu_ps(p + 8, _mm256_blendv_ps(p1, n1, hi));
+    }
+#elif defined(SIMD_SSE2)
+    __m128 vScale = _mm_set1_ps(scale);
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        __m128i mask = _mm_castps_si128(FlagMask4(&aFlags[i], flag));
+        __m128 lo = _mm_castsi128_ps(_mm_unpacklo_epi32(mask, mask));
+        __m128 hi = _mm_castsi128_ps(_mm_unpackhi_epi32(mask, mask));
+
+        f32* p = &aPosition[i].x;
+        const f32* v = &aVelocity[i].x;
+
+        __m128 p0 = _mm_loadu_ps(p);
+        __m128 p1 = _mm_loadu_ps(p + 4);
+        __m128 n0 = _mm_add_ps(p0, _mm_mul_ps(_mm_loadu_ps(v), vScale));
+        __m128 n1 = _mm_add_ps(p1, _mm_mul_ps(_mm_loadu_ps(v + 4), vScale));
+
+        _mm_storeu_ps(p, Select4(lo, n0, p0));
+        _mm_storeu_ps(p + 4, Select4(hi, n1, p1));
+    }
+#endif
+
+    IntegrateRange(aPosition, aVelocity, aFlags, flag, scale, (s32)i, count);
+}
+
+void Kernels::Walk(Vector2* aPosition, const Vector2* aVelocity, const FRect* aHitBox, const b32* abCollidable,
+                   const u32* aFlags, u32 flag, const SRect& ground, s32 count)
+{
+    i32f i = 0;
+
+    // Candidates are computed the same way scalar code does to get the same floats:
+    // (x+vx, y+vy), then (x+vx, y), then (x, y+vy), then (x, y)
+#if defined(SIMD_AVX2)
+    Box8 vGround = {
+        _mm256_set1_ps((f32)ground.x1), _mm256_set1_ps((f32)ground.y1),
+        _mm256_set1_ps((f32)ground.x2), _mm256_set1_ps((f32)ground.y2)
+    };
+
+    for ( ; i + 8 <= count; i += 8)
+    {
+        __m256 px, py, vx, vy;
+        Load8Vectors(&aPosition[i], px, py);
+        Load8Vectors(&aVelocity[i], vx, vy);
+
+        Box8 hitBox;
+        Load8Rects(&aHitBox[i], hitBox);
+
+        __m256 walk = FlagMask8(&aFlags[i], flag);
+        __m256 noCollide = _mm256_castsi256_ps(_mm256_cmpeq_epi32(LaneOrder8(&abCollidable[i]), _mm256_setzero_si256()));
+
+        __m256 nx = _mm256_add_ps(px, vx);
+        __m256 ny = _mm256_add_ps(py, vy);
+        __m256 y2 = _mm256_sub_ps(ny, vy);
+        __m256 x3 = _mm256_sub_ps(nx, vx);
+        __m256 y3 = _mm256_add_ps(y2, vy);
+        __m256 y4 = _mm256_sub_ps(y3, vy);
+
+        __m256 rx = x3;
+        __m256 ry = _mm256_blendv_ps(y4, y3, OnGround8(x3, y3, hitBox, vGround));
+
+        __m256 mask = OnGround8(nx, y2, hitBox, vGround);
+        rx = _mm256_blendv_ps(rx, nx, mask);
+        ry = _mm256_blendv_ps(ry, y2, mask);
+
+        mask = _mm256_or_ps(noCollide, OnGround8(nx, ny, hitBox, vGround));
+        rx = _mm256_blendv_ps(rx, nx, mask);
+        ry = _mm256_blendv_ps(ry, ny, mask);
+
+        Store8Vectors(&aPosition[i], _mm256_blendv_ps(px, rx, walk), _mm256_blendv_ps(py, ry, walk));
+    }
+#elif defined(SIMD_SSE2)
+    Box4 vGround = {
+        _mm_set1_ps((f32)ground.x1), _mm_set1_ps((f32)ground.y1),
+        _mm_set1_ps((f32)ground.x2), _mm_set1_ps((f32)ground.y2)
+    };
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        __m128 px, py, vx, vy;
+        Load4Vectors(&aPosition[i], px, py);
+        Load4Vectors(&aVelocity[i], vx, vy);
+
+        Box4 hitBox;
+        Load4Rects(&aHitBox[i], hitBox);
+
+        __m128 walk = FlagMask4(&aFlags[i], flag);
+        __m128i vCollidable = _mm_loadu_si128((const __m128i*)&abCollidable[i]);
+        __m128 noCollide = _mm_castsi128_ps(_mm_cmpeq_epi32(vCollidable, _mm_setzero_si128()));
+
+        __m128 nx = _mm_add_ps(px, vx);
+        __m128 ny = _mm_add_ps(py, vy);
+        __m128 y2 = _mm_sub_ps(ny, vy);
+        __m128 x3 = _mm_sub_ps(nx, vx);
+        __m128 y3 = _mm_add_ps(y2, vy);
+        __m128 y4 = _mm_sub_ps(y3, vy);
+
+        __m128 rx = x3;
+        __m128 ry = Select4(OnGround4(x3, y3, hitBox, vGround), y3, y4);
+
+        __m128 mask = OnGround4(nx, y2, hitBox, vGround);
+        rx = Select4(mask, nx, rx);
+        ry = Select4(mask, y2, ry);
+
+        mask = _mm_or_ps(noCollide, OnGround4(nx, ny, hitBox, vGround));
+        rx = Select4(mask, nx, rx);
+        ry = Select4(mask, ny, ry);
+
+        Store4Vectors(&aPosition[i], Select4(walk, rx, px), Select4(walk, ry, py));
+    }
+#endif
+
+    WalkRange(aPosition, aVelocity, aHitBox, abCollidable, aFlags, flag, ground, (s32)i, count);
+}
+
+s32 Kernels::Overlap(const Vector2* aPosition, const FRect* aHitBox, const FRect& rect, s32* aIndices, s32 count)
+{
+    i32f i = 0;
+    s32 found = 0;
+
+#if defined(SIMD_AVX2)
+    __m256 rx1 = _mm256_set1_ps(rect.x1);
+    __m256 ry1 = _mm256_set1_ps(rect.y1);
+    __m256 rx2 = _mm256_set1_ps(rect.x2);
+    __m256 ry2 = _mm256_set1_ps(rect.y2);
+
+    for ( ; i + 8 <= count; i += 8)
+    {
+        __m256 px, py;
+        Load8Vectors(&aPosition[i], px, py);
+
+        Box8 hitBox;
+        Load8Rects(&aHitBox[i], hitBox);
+
+        __m256 mask = _mm256_cmp_ps(_mm256_add_ps(px, hitBox.x1), rx2, _CMP_NGT_UQ);
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(px, hitBox.x2), rx1, _CMP_NLT_UQ));
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(py, hitBox.y1), ry2, _CMP_NGT_UQ));
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(py, hitBox.y2), ry1, _CMP_NLT_UQ));
+
+        // Back from lane order to entry order
+        s32 bits = _mm256_movemask_ps(mask);
+        bits = (bits & 0xC3) | ((bits & 0x0C) << 2) | ((bits & 0x30) >> 2);
+
+        for (i32f j = 0; j < 8; ++j)
+        {
+            if (bits & (1 << j))
+            {
+                aIndices[found++] = (s32)(i + j);
+            }
+        }
+    }
+#elif defined(SIMD_SSE2)
+    __m128 rx1 = _mm_set1_ps(rect.x1);
+    __m128 ry1 = _mm_set1_ps(rect.y1);
+    __m128 rx2 = _mm_set1_ps(rect.x2);
+    __m128 ry2 = _mm_set1_ps(rect.y2);
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        __m128 px, py;
+        Load4Vectors(&aPosition[i], px, py);
+
+        Box4 hitBox;
+        Load4Rects(&aHitBox[i], hitBox);
+
+        __m128 mask = _mm_cmpngt_ps(_mm_add_ps(px, hitBox.x1), rx2);
+        mask = _mm_and_ps(mask, _mm_cmpnlt_ps(_mm_add_ps(px, hitBox.x2), rx1));
+        mask = _mm_and_ps(mask, _mm_cmpngt_ps(_mm_add_ps(py, hitBox.y1), ry2));
+        mask = _mm_and_ps(mask, _mm_cmpnlt_ps(_mm_add_ps(py, hitBox.y2), ry1));
+
+        s32 bits = _mm_movemask_ps(mask);
+        for (i32f j = 0; j < 4; ++j)
+        {
+            if (bits & (1 << j))
+            {
+                aIndices[found++] = (s32)(i + j);
+            }
+        }
+    }
+#endif
+
+    return OverlapRange(aPosition, aHitBox, rect, aIndices, found, (s32)i, count);
+}
+
+void Kernels::IntegrateScalar(Vector2* aPosition, const Vector2* aVelocity, const u32* aFlags, u32 flag, f32 scale, s32 count)
+{
+    IntegrateRange(aPosition, aVelocity, aFlags, flag, scale, 0, count);
+}
+
+void Kernels::WalkScalar(Vector2* aPosition, const Vector2* aVelocity, const FRect* aHitBox, const b32* abCollidable,
+                         const u32* aFlags, u32 flag, const SRect& ground, s32 count)
+{
+    WalkRange(aPosition, aVelocity, aHitBox, abCollidable, aFlags, flag, ground, 0, count);
+}
+
+s32 Kernels::OverlapScalar(const Vector2* aPosition, const FRect* aHitBox, const FRect& rect, s32* aIndices, s32 count)
+{
+    return OverlapRange(aPosition, aHitBox, rect, aIndices, 0, 0, count);
+}
+
+/** Millions of entries per second */
+template<typename F>
+internal f64 MeasureThroughput(F kernel, s32 count, s32 iterations)
+{
+    u64 start = SDL_GetPerformanceCounter();
+    for (i32f i = 0; i < iterations; ++i)
+    {
+        kernel();
+    }
+    f64 seconds = (f64)(SDL_GetPerformanceCounter() - start) / (f64)SDL_GetPerformanceFrequency();
+
+    return seconds > 0.0 ? (f64)count * (f64)iterations / seconds / 1000000.0 : 0.0;
+}
+
+void Kernels::Benchmark(s32 count, s32 iterations)
+{
+    if (count <= 0 || iterations <= 0)
+    {
+        return;
+    }
+
+#if defined(SIMD_AVX2)
+    const char* simdName = "AVX2";
+#elif defined(SIMD_SSE2)
+    const char* simdName = "SSE2";
+#else
+    const char* simdName = "scalar";
+#endif
+
+    // Fill arrays with entities scattered around the ground, some of them leave it
+    static constexpr i32f GROUND_SIZE = 1024;
+    SRect ground = { 0, 0, GROUND_SIZE - 1, GROUND_SIZE - 1 };
+    FRect rect = { 256.0f, 256.0f, 512.0f, 512.0f };
+
+    Vector2* aPosition = new Vector2[count];
+    Vector2* aVelocity = new Vector2[count];
+    FRect* aHitBox = new FRect[count];
+    b32* abCollidable = new b32[count];
+    u32* aFlags = new u32[count];
+    s32* aIndices = new s32[count];
+
+    for (i32f i = 0; i < count; ++i)
+    {
+        aPosition[i] = { (f32)(std::rand() % GROUND_SIZE), (f32)(std::rand() % GROUND_SIZE) };
+        aVelocity[i] = { (f32)(std::rand() % 9 - 4), (f32)(std::rand() % 9 - 4) };
+        aHitBox[i] = { -8.0f, -16.0f, 8.0f, 16.0f };
+        abCollidable[i] = i % 8 != 0;
+        aFlags[i] = i % 4 != 0 ? 1 : 0;
+    }
+
+    // Measure
+    f64 integrateScalar = MeasureThroughput([&] { IntegrateScalar(aPosition, aVelocity, aFlags, 1, 0.016f, count); }, count, iterations);
+    f64 integrate = MeasureThroughput([&] { Integrate(aPosition, aVelocity, aFlags, 1, 0.016f, count); }, count, iterations);
+
+    f64 walkScalar = MeasureThroughput([&] { WalkScalar(aPosition, aVelocity, aHitBox, abCollidable, aFlags, 1, ground, count); }, count, iterations);
+    f64 walk = MeasureThroughput([&] { Walk(aPosition, aVelocity, aHitBox, abCollidable, aFlags, 1, ground, count); }, count, iterations);
+
+    s32 foundScalar = 0, found = 0;
+    f64 overlapScalar = MeasureThroughput([&] { foundScalar = OverlapScalar(aPosition, aHitBox, rect, aIndices, count); }, count, iterations);
+    f64 overlap = MeasureThroughput([&] { found = Overlap(aPosition, aHitBox, rect, aIndices, count); }, count, iterations);
+
+    // Report
+    LogNote(CHANNEL_GAME, PR_NOTE, "Kernels", "%d entries, %d iterations, %s vs scalar, millions of entries per second:", count, iterations, simdName);
+    LogNote(CHANNEL_GAME, PR_NOTE, "Kernels", "Integrate %.1f vs %.1f", integrate, integrateScalar);
+    LogNote(CHANNEL_GAME, PR_NOTE, "Kernels", "Walk      %.1f vs %.1f", walk, walkScalar);
+    LogNote(CHANNEL_GAME, PR_NOTE, "Kernels", "Overlap   %.1f vs %.1f (%d/%d hits)", overlap, overlapScalar, found, foundScalar);
+
+    delete[] aPosition;
+    delete[] aVelocity;
+    delete[] aHitBox;
+    delete[] abCollidable;
+    delete[] aFlags;
+    delete[] aIndices;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Math/Math.h"
+
+/**
+ * Batch kernels over packed entity arrays. Each one processes
+ * 8 (AVX2) or 4 (SSE2) entries per instruction when compiled
+ * with support and falls back to scalar code for the rest
+ */
+class Kernels
+{
+public:
+    /** Position += velocity * scale for entries with flag set */
+    static void Integrate(Vector2* aPosition, const Vector2* aVelocity, const u32* aFlags, u32 flag, f32 scale, s32 count);
+
+    /** Position += velocity for entries with flag set, collidable ones drop velocity axes to stay on the ground */
+    static void Walk(Vector2* aPosition, const Vector2* aVelocity, const FRect* aHitBox, const b32* abCollidable,
+                     const u32* aFlags, u32 flag, const SRect& ground, s32 count);
+
+    /** Writes indices of entries which hitbox overlaps rect, returns their count */
+    static s32 Overlap(const Vector2* aPosition, const FRect* aHitBox, const FRect& rect, s32* aIndices, s32 count);
+
+    /** Same kernels without SIMD, for comparison */
+    static void IntegrateScalar(Vector2* aPosition, const Vector2* aVelocity, const u32* aFlags, u32 flag, f32 scale, s32 count);
+    static void WalkScalar(Vector2* aPosition, const Vector2* aVelocity, const FRect* aHitBox, const b32* abCollidable,
+                           const u32* aFlags, u32 flag, const SRect& ground, s32 count);
+    static s32 OverlapScalar(const Vector2* aPosition, const FRect* aHitBox, const FRect& rect, s32* aIndices, s32 count);
+
+    /** Logs throughput of every kernel for count entries */
+    static void Benchmark(s32 count, s32 iterations);
+};
@@ -146,6 +146,15 @@ public:
         return min + (std::rand() % (max - min + 1));
     }
 
+    /** Xorshift32, for code on job system where std::rand() can't be used. State must not be zero */
+    forceinline static u32 XorShift(u32& state) noexcept
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
     /** @DEPRECATED */
     static s32 FastDist2(s32 x, s32 y);
 
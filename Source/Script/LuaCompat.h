@@ -0,0 +1,77 @@
+#pragma once
+
+extern "C"
+{
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+#ifdef GT2D_LUAJIT
+#include "luajit.h"
+#endif
+}
+
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+/**
+ * Calls which differ between Lua 5.4 and LuaJIT (5.1 API). Build
+ * against LuaJIT defines GT2D_LUAJIT, see LuaJIT configurations of project
+ */
+namespace LuaCompat
+{
+#ifdef LUAJIT_VERSION
+
+#ifndef LUA_OK
+#define LUA_OK 0
+#endif
+
+    /** LuaJIT x64 doesn't take custom allocators, its memory isn't tracked */
+    forceinline lua_State* NewState(lua_Alloc alloc) { return luaL_newstate(); }
+
+    /** LuaJIT keeps debug info, there's no strip flag */
+    forceinline s32 Dump(lua_State* L, lua_Writer writer, void* userdata) { return lua_dump(L, writer, userdata); }
+
+    /** Mode isn't checked, chunks come only from Dump() */
+    forceinline s32 LoadBinary(lua_State* L, const char* code, size_t size, const char* name) { return luaL_loadbuffer(L, code, size, name); }
+
+    /** Values yielded or returned by coroutine are all that's left on its stack */
+    forceinline s32 Resume(lua_State* pThread, lua_State* pFrom, s32 args, s32* pResults)
+    {
+        s32 res = lua_resume(pThread, args);
+        *pResults = res == LUA_OK || res == LUA_YIELD ? lua_gettop(pThread) : 0;
+        return res;
+    }
+
+    /** Everything but main thread is coroutine of scheduler or runScript() */
+    forceinline b32 IsYieldable(lua_State* L)
+    {
+        b32 bMain = lua_pushthread(L);
+        lua_pop(L, 1);
+        return !bMain;
+    }
+
+    forceinline b32 IsInteger(lua_State* L, s32 index)
+    {
+        return lua_type(L, index) == LUA_TNUMBER && (lua_Number)lua_tointeger(L, index) == lua_tonumber(L, index);
+    }
+
+    forceinline size_t RawLength(lua_State* L, s32 index) { return lua_objlen(L, index); }
+
+#else
+
+    forceinline lua_State* NewState(lua_Alloc alloc) { return lua_newstate(alloc, nullptr); }
+
+    forceinline s32 Dump(lua_State* L, lua_Writer writer, void* userdata) { return lua_dump(L, writer, userdata, 0); }
+
+    forceinline s32 LoadBinary(lua_State* L, const char* code, size_t size, const char* name) { return luaL_loadbufferx(L, code, size, name, "b"); }
+
+    forceinline s32 Resume(lua_State* pThread, lua_State* pFrom, s32 args, s32* pResults) { return lua_resume(pThread, pFrom, args, pResults); }
+
+    forceinline b32 IsYieldable(lua_State* L) { return lua_isyieldable(L); }
+
+    forceinline b32 IsInteger(lua_State* L, s32 index) { return lua_isinteger(L, index); }
+
+    forceinline size_t RawLength(lua_State* L, s32 index) { return lua_rawlen(L, index); }
+
+#endif
+}
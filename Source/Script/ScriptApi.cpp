@@ -0,0 +1,137 @@
+#include "Graphics/GraphicsModule.h"
+#include "Game/Actor.h"
+#include "Script/ScriptApi.h"
+
+static forceinline b32 CheckPointer(const void* p, const char* funName)
+{
+    if (!p)
+    {
+        LogNote(CHANNEL_SCRIPT, PR_WARNING, "ScriptApi", "%s() called with null pointer", funName);
+        return false;
+    }
+
+    return true;
+}
+
+/** Entity */
+void GT_SetEntityPosition(void* pEntity, float x, float y)
+{
+    if (CheckPointer(pEntity, "GT_SetEntityPosition"))
+    {
+        ((Entity*)pEntity)->SetPosition({ g_graphicsModule.UnitsToPixelsX(x), g_graphicsModule.UnitsToPixelsY(y) });
+    }
+}
+
+float GT_GetEntityPositionX(void* pEntity)
+{
+    return CheckPointer(pEntity, "GT_GetEntityPositionX") ? g_graphicsModule.PixelsToUnitsX(((Entity*)pEntity)->Position().x) : 0.0f;
+}
+
+float GT_GetEntityPositionY(void* pEntity)
+{
+    return CheckPointer(pEntity, "GT_GetEntityPositionY") ? g_graphicsModule.PixelsToUnitsY(((Entity*)pEntity)->Position().y) : 0.0f;
+}
+
+void GT_SetEntityVelocity(void* pEntity, float x, float y)
+{
+    if (CheckPointer(pEntity, "GT_SetEntityVelocity"))
+    {
+        ((Entity*)pEntity)->Velocity() = { g_graphicsModule.UnitsToPixelsX(x), g_graphicsModule.UnitsToPixelsY(y) };
+    }
+}
+
+float GT_GetEntityVelocityX(void* pEntity)
+{
+    return CheckPointer(pEntity, "GT_GetEntityVelocityX") ? g_graphicsModule.PixelsToUnitsX(((Entity*)pEntity)->Velocity().x) : 0.0f;
+}
+
+float GT_GetEntityVelocityY(void* pEntity)
+{
+    return CheckPointer(pEntity, "GT_GetEntityVelocityY") ? g_graphicsModule.PixelsToUnitsY(((Entity*)pEntity)->Velocity().y) : 0.0f;
+}
+
+void GT_SetEntityZIndex(void* pEntity, int zIndex)
+{
+    if (CheckPointer(pEntity, "GT_SetEntityZIndex"))
+    {
+        ((Entity*)pEntity)->m_zIndex = zIndex;
+    }
+}
+
+int GT_GetEntityZIndex(void* pEntity)
+{
+    return CheckPointer(pEntity, "GT_GetEntityZIndex") ? ((Entity*)pEntity)->m_zIndex : 0;
+}
+
+void GT_SetEntityAnimFrame(void* pEntity, int frame)
+{
+    if (CheckPointer(pEntity, "GT_SetEntityAnimFrame"))
+    {
+        ((Entity*)pEntity)->AnimFrame() = frame;
+    }
+}
+
+int GT_GetEntityAnimFrame(void* pEntity)
+{
+    return CheckPointer(pEntity, "GT_GetEntityAnimFrame") ? ((Entity*)pEntity)->AnimFrame() : 0;
+}
+
+/** Actor */
+void GT_SetActorTeam(void* pActor, int team)
+{
+    if (CheckPointer(pActor, "GT_SetActorTeam"))
+    {
+        ((Actor*)pActor)->m_actorTeam = team;
+    }
+}
+
+int GT_GetActorTeam(void* pActor)
+{
+    return CheckPointer(pActor, "GT_GetActorTeam") ? ((Actor*)pActor)->m_actorTeam : ACTOR_TEAM_DEFAULT;
+}
+
+void GT_SetActorHealth(void* pActor, float health)
+{
+    if (CheckPointer(pActor, "GT_SetActorHealth"))
+    {
+        ((Actor*)pActor)->m_health = health;
+    }
+}
+
+float GT_GetActorHealth(void* pActor)
+{
+    return CheckPointer(pActor, "GT_GetActorHealth") ? ((Actor*)pActor)->m_health : 0.0f;
+}
+
+int GT_IsActorAlive(void* pActor)
+{
+    return CheckPointer(pActor, "GT_IsActorAlive") ? ((Actor*)pActor)->m_actorState != ACTOR_STATE_DEAD : false;
+}
+
+void GT_SetActorSpeed(void* pActor, float x, float y)
+{
+    if (CheckPointer(pActor, "GT_SetActorSpeed"))
+    {
+        ((Actor*)pActor)->m_vSpeed = { g_graphicsModule.UnitsToPixelsX(x), g_graphicsModule.UnitsToPixelsY(y) };
+    }
+}
+
+/** Camera */
+void GT_SetCameraPosition(float x, float y)
+{
+    g_graphicsModule.GetCamera().SetPosition((s32)g_graphicsModule.UnitsToPixelsX(x), (s32)g_graphicsModule.UnitsToPixelsY(y));
+}
+
+float GT_GetCameraPositionX(void)
+{
+    s32 x, y;
+    g_graphicsModule.GetCamera().GetPosition(x, y);
+    return g_graphicsModule.PixelsToUnitsX((f32)x);
+}
+
+float GT_GetCameraPositionY(void)
+{
+    s32 x, y;
+    g_graphicsModule.GetCamera().GetPosition(x, y);
+    return g_graphicsModule.PixelsToUnitsY((f32)y);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Engine/Platform.h"
+
+/**
+ * Flat C interface for entity, actor and camera operations.
+ * Every function is declared once in SCRIPT_API table,
+ * prototypes and LuaJIT FFI declarations are generated from it.
+ * Pointers are the same as light userdata in Lua bindings, coordinates are in units.
+ */
+#if defined(_MSC_VER)
+    #define SCRIPT_API_EXPORT __declspec(dllexport)
+#else
+    #define SCRIPT_API_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define SCRIPT_API(X) \
+    /** Entity */ \
+    X(void,  GT_SetEntityPosition,  (void* pEntity, float x, float y)) \
+    X(float, GT_GetEntityPositionX, (void* pEntity)) \
+    X(float, GT_GetEntityPositionY, (void* pEntity)) \
+    X(void,  GT_SetEntityVelocity,  (void* pEntity, float x, float y)) \
+    X(float, GT_GetEntityVelocityX, (void* pEntity)) \
+    X(float, GT_GetEntityVelocityY, (void* pEntity)) \
+    X(void,  GT_SetEntityZIndex,    (void* pEntity, int zIndex)) \
+    X(int,   GT_GetEntityZIndex,    (void* pEntity)) \
+    X(void,  GT_SetEntityAnimFrame, (void* pEntity, int frame)) \
+    X(int,   GT_GetEntityAnimFrame, (void* pEntity)) \
+    /** Actor */ \
+    X(void,  GT_SetActorTeam,       (void* pActor, int team)) \
+    X(int,   GT_GetActorTeam,       (void* pActor)) \
+    X(void,  GT_SetActorHealth,     (void* pActor, float health)) \
+    X(float, GT_GetActorHealth,     (void* pActor)) \
+    X(int,   GT_IsActorAlive,       (void* pActor)) \
+    X(void,  GT_SetActorSpeed,      (void* pActor, float x, float y)) \
+    /** Camera */ \
+    X(void,  GT_SetCameraPosition,  (float x, float y)) \
+    X(float, GT_GetCameraPositionX, (void)) \
+    X(float, GT_GetCameraPositionY, (void))
+
+#define SCRIPT_API_PROTOTYPE(ret, name, params) SCRIPT_API_EXPORT ret name params;
+#define SCRIPT_API_CDEF(ret, name, params) #ret " " #name #params ";\n"
+
+extern "C"
+{
+    SCRIPT_API(SCRIPT_API_PROTOTYPE)
+}
+
+/** Passed to ffi.cdef() by Api.lua */
+static constexpr char SCRIPT_API_DECLARATIONS[] = SCRIPT_API(SCRIPT_API_CDEF);
@@ -1,13 +1,10 @@
-extern "C"
-{
-#include "lua.h"
-#include "lauxlib.h"
-#include "lualib.h"
-}
+#include "Script/LuaCompat.h"
 #include "Graphics/GraphicsModule.h"
+#include "Graphics/Tilemap.h"
 #include "Sound/SoundModule.h"
 #include "Input/InputModule.h"
 #include "Engine/Console.h"
+#include "Engine/MemoryTracker.h"
 #include "Game/Game.h"
 #include "Game/PauseState.h"
 #include "Game/Actor.h"
@@ -27,26 +24,200 @@ extern "C"
 #include "Game/Car.h"
 #include "Game/Trigger.h"
 #include "Game/Dialog.h"
+#include "Script/ScriptApi.h"
+#include "Script/ScriptScheduler.h"
 #include "Script/ScriptModule.h"
 
 static constexpr char MISSION_SAVER_PATH[] = "Scripts/Internal/Saver.lua";
 static constexpr char SCRIPT_SET_UP[] = "package.path = package.path .. \";Scripts/?.lua;Scripts/Internal/?.lua\"";
 
+static constexpr char INTERNAL_LIBRARY_PATH[] = "Scripts/Internal/%s.lua";
+static constexpr const char* INTERNAL_LIBRARIES[] = {
+    "Mission",
+    "Console",
+    "Graphics",
+    "Camera",
+    "Tilemap",
+    "Input",
+    "Sound",
+    "Music",
+    "Clock",
+    "Resource",
+    "Entity",
+    "Actor",
+    "Car",
+    "Dialog",
+    "Trigger",
+    "Saver",
+    "Cutscene",
+    "ConsoleDev",
+    "Api"
+};
+static constexpr s32 INTERNAL_LIBRARIES_COUNT = sizeof(INTERNAL_LIBRARIES) / sizeof(INTERNAL_LIBRARIES[0]);
+static constexpr size_t LUA_CHUNK_START_CAPACITY = 4096;
+static constexpr char SCHEDULER_REGISTRY_KEY[] = "GT_SCHEDULER";
+
 void ScriptModule::StartUp()
 {
+    CompileLibraries();
+
     AddNote(PR_NOTE, "Module started");
 }
 
 void ScriptModule::ShutDown()
 {
+    FreeLibraries();
+
     AddNote(PR_NOTE, "Module shut down");
 }
 
+void ScriptModule::CompileLibraries()
+{
+    m_aLibraries = new LuaChunk[INTERNAL_LIBRARIES_COUNT];
+    m_librariesCount = 0;
+
+    // Internal libraries are the same for every mission,
+    // so parse them once and keep only bytecode
+    lua_State* L = NewLuaState();
+    char path[256];
+
+    for (i32f i = 0; i < INTERNAL_LIBRARIES_COUNT; ++i)
+    {
+        std::snprintf(path, sizeof(path), INTERNAL_LIBRARY_PATH, INTERNAL_LIBRARIES[i]);
+        if (!CheckLua(L, luaL_loadfile(L, path)))
+        {
+            continue;
+        }
+
+        LuaChunk& chunk = m_aLibraries[m_librariesCount];
+        chunk.name = INTERNAL_LIBRARIES[i];
+        chunk.code = new u8[LUA_CHUNK_START_CAPACITY];
+        chunk.size = 0;
+        chunk.capacity = LUA_CHUNK_START_CAPACITY;
+
+        // Keep debug info for error messages
+        LuaCompat::Dump(L, WriteChunk, &chunk);
+        lua_pop(L, 1);
+
+        ++m_librariesCount;
+    }
+
+    lua_close(L);
+
+    AddNote(PR_NOTE, "%d of %d internal libraries precompiled", m_librariesCount, INTERNAL_LIBRARIES_COUNT);
+}
+
+void ScriptModule::FreeLibraries()
+{
+    for (i32f i = 0; i < m_librariesCount; ++i)
+    {
+        delete[] m_aLibraries[i].code;
+    }
+
+    delete[] m_aLibraries;
+    m_librariesCount = 0;
+}
+
+void ScriptModule::PreloadLibraries(lua_State* L)
+{
+    // Get package.preload table
+    lua_getglobal(L, "package");
+    lua_getfield(L, -1, "preload");
+
+    // Put loaders, require() will run them instead of searching files
+    for (i32f i = 0; i < m_librariesCount; ++i)
+    {
+        const LuaChunk& chunk = m_aLibraries[i];
+        if (!CheckLua(L, LuaCompat::LoadBinary(L, (const char*)chunk.code, chunk.size, chunk.name)))
+        {
+            continue;
+        }
+
+        lua_setfield(L, -2, chunk.name);
+    }
+
+    // Pop package and preload tables
+    lua_pop(L, 2);
+}
+
+s32 ScriptModule::WriteChunk(lua_State* L, const void* p, size_t size, void* userdata)
+{
+    LuaChunk* pChunk = (LuaChunk*)userdata;
+
+    // Grow buffer if needed
+    if (pChunk->size + size > pChunk->capacity)
+    {
+        size_t capacity = pChunk->capacity * 2;
+        while (pChunk->size + size > capacity)
+        {
+            capacity *= 2;
+        }
+
+        u8* code = new u8[capacity];
+        std::memcpy(code, pChunk->code, pChunk->size);
+        delete[] pChunk->code;
+
+        pChunk->code = code;
+        pChunk->capacity = capacity;
+    }
+
+    std::memcpy(pChunk->code + pChunk->size, p, size);
+    pChunk->size += size;
+
+    return 0;
+}
+
+lua_State* ScriptModule::NewLuaState()
+{
+    lua_State* L = LuaCompat::NewState(LuaAlloc);
+    if (L)
+    {
+        lua_atpanic(L, LuaPanic);
+    }
+    return L;
+}
+
+void* ScriptModule::LuaAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    // Lua gives type instead of size for new blocks
+    s64 oldSize = ptr ? (s64)osize : 0;
+
+    if (nsize == 0)
+    {
+        if (ptr)
+        {
+            std::free(ptr);
+            MemoryTracker::Track(MEMORY_SCRIPT, -oldSize, -1);
+        }
+        return nullptr;
+    }
+
+    void* pNew = std::realloc(ptr, nsize);
+    if (pNew)
+    {
+        MemoryTracker::Track(MEMORY_SCRIPT, (s64)nsize - oldSize, ptr ? 0 : 1);
+    }
+    return pNew;
+}
+
+s32 ScriptModule::LuaPanic(lua_State* L)
+{
+    const char* message = lua_tostring(L, -1);
+    LuaNote(PR_ERROR, "Unprotected error: %s", message ? message : "error object is not a string");
+    return 0;
+}
+
 void ScriptModule::DefineFunctions(lua_State* L)
 {
     lua_register(L, "GT_LOG", _GT_LOG);
     lua_register(L, "dostring", _dostring);
 
+    lua_register(L, "runScript", _runScript);
+    lua_register(L, "waitTime", _waitTime);
+    lua_register(L, "waitAnimation", _waitAnimation);
+    lua_register(L, "waitDialog", _waitDialog);
+    lua_register(L, "waitDeath", _waitDeath);
+
     lua_register(L, "defineTexture", _defineTexture);
     lua_register(L, "showCursor", _showCursor);
     lua_register(L, "setDrawColor", _setDrawColor);
@@ -54,20 +225,47 @@ void ScriptModule::DefineFunctions(lua_State* L)
     lua_register(L, "drawText", _drawText);
     lua_register(L, "fillRect", _fillRect);
     lua_register(L, "drawRect", _drawRect);
+    lua_register(L, "setLayerCached", _setLayerCached);
+    lua_register(L, "setPartialRedraw", _setPartialRedraw);
 
     lua_register(L, "attachCamera", _attachCamera);
     lua_register(L, "detachCamera", _detachCamera);
     lua_register(L, "setCameraPosition", _setCameraPosition);
     lua_register(L, "setCameraBounds", _setCameraBounds);
     lua_register(L, "getCameraPosition", _getCameraPosition);
+    lua_register(L, "getRenderTimes", _getRenderTimes);
+    lua_register(L, "getRenderStats", _getRenderStats);
+    lua_register(L, "showOverdraw", _showOverdraw);
+
+    lua_register(L, "getMemoryStats", _getMemoryStats);
+    lua_register(L, "setMemoryBudget", _setMemoryBudget);
+    lua_register(L, "writeMemoryReport", _writeMemoryReport);
+
+    lua_register(L, "createTilemap", _createTilemap);
+    lua_register(L, "loadTilemap", _loadTilemap);
+    lua_register(L, "saveTilemap", _saveTilemap);
+    lua_register(L, "unloadTilemap", _unloadTilemap);
+    lua_register(L, "defineTileset", _defineTileset);
+    lua_register(L, "setTilemapLayer", _setTilemapLayer);
+    lua_register(L, "setTile", _setTile);
+    lua_register(L, "getTile", _getTile);
+    lua_register(L, "getTileAt", _getTileAt);
+    lua_register(L, "getTilemapSize", _getTilemapSize);
 
     lua_register(L, "defineSound", _defineSound);
     lua_register(L, "playSound", _playSound);
     lua_register(L, "playSoundLooped", _playSoundLooped);
+    lua_register(L, "playSoundAt", _playSoundAt);
+    lua_register(L, "setSoundPriority", _setSoundPriority);
+    lua_register(L, "getVoiceStats", _getVoiceStats);
     lua_register(L, "stopAllSounds", _stopAllSounds);
+    lua_register(L, "releaseSound", _releaseSound);
 
     lua_register(L, "defineMusic", _defineMusic);
     lua_register(L, "playMusic", _playMusic);
+    lua_register(L, "fadeInMusic", _fadeInMusic);
+    lua_register(L, "fadeOutMusic", _fadeOutMusic);
+    lua_register(L, "releaseMusic", _releaseMusic);
 
     lua_register(L, "isKeyDown", _isKeyDown);
     lua_register(L, "isMouseDown", _isMouseDown);
@@ -77,6 +275,8 @@ void ScriptModule::DefineFunctions(lua_State* L)
     lua_register(L, "cls", _cls);
 
     lua_register(L, "defineAnimation", _defineAnimation);
+    lua_register(L, "defineNamedAnimation", _defineNamedAnimation);
+    lua_register(L, "findAnimation", _findAnimation);
 
     lua_register(L, "getTicks", _getTicks);
     lua_register(L, "stopGame", _stopGame);
@@ -89,6 +289,8 @@ void ScriptModule::DefineFunctions(lua_State* L)
     lua_register(L, "hostSwitchLocation", _hostSwitchLocation);
     lua_register(L, "setGroundBounds", _setGroundBounds);
     lua_register(L, "hasWorldEntity", _hasWorldEntity);
+    lua_register(L, "getWorldUpdateTime", _getWorldUpdateTime);
+    lua_register(L, "benchKernels", _benchKernels);
 
     lua_register(L, "addEntity", _addEntity);
     lua_register(L, "removeEntity", _removeEntity);
@@ -115,10 +317,15 @@ void ScriptModule::DefineFunctions(lua_State* L)
     lua_register(L, "getEntityHUD", _getEntityHUD);
     lua_register(L, "setEntityTexture", _setEntityTexture);
     lua_register(L, "getEntityTexture", _getEntityTexture);
+    lua_register(L, "setEntityPositions", _setEntityPositions);
+    lua_register(L, "getEntityPositions", _getEntityPositions);
+    lua_register(L, "setEntityVelocities", _setEntityVelocities);
+    lua_register(L, "getEntitiesInRect", _getEntitiesInRect);
 
     lua_register(L, "addActor", _addActor);
     lua_register(L, "setActorTeam", _setActorTeam);
     lua_register(L, "getActorTeam", _getActorTeam);
+    lua_register(L, "getActorsByTeam", _getActorsByTeam);
     lua_register(L, "setActorHealth", _setActorHealth);
     lua_register(L, "getActorHealth", _getActorHealth);
     lua_register(L, "isActorAlive", _isActorAlive);
@@ -154,6 +361,9 @@ void ScriptModule::DefineFunctions(lua_State* L)
     lua_register(L, "ejectActorFromCar", _ejectActorFromCar);
 
     lua_register(L, "addTrigger", _addTrigger);
+    lua_register(L, "watchTriggerEntity", _watchTriggerEntity);
+    lua_register(L, "setTriggerRepeatable", _setTriggerRepeatable);
+    lua_register(L, "setTriggerExitFunction", _setTriggerExitFunction);
 
     lua_register(L, "addDialog", _addDialog);
     lua_register(L, "runDialog", _runDialog);
@@ -164,6 +374,9 @@ void ScriptModule::DefineFunctions(lua_State* L)
 
 void ScriptModule::DefineSymbols(lua_State* L)
 {
+    lua_pushstring(L, SCRIPT_API_DECLARATIONS);
+    lua_setglobal(L, "SCRIPT_API_DECLARATIONS");
+
     lua_pushinteger(L, PR_NOTE);
     lua_setglobal(L, "PR_NOTE");
     lua_pushinteger(L, PR_WARNING);
@@ -289,27 +502,64 @@ void ScriptModule::DefineSymbols(lua_State* L)
     lua_setglobal(L, "AITASK_FADE_OFF");
     lua_pushinteger(L, AITASK_PUSH_COMMAND);
     lua_setglobal(L, "AITASK_PUSH_COMMAND");
+
+    // Sound priorities
+    lua_pushinteger(L, SOUND_PRIORITY_LOW);
+    lua_setglobal(L, "SOUND_PRIORITY_LOW");
+    lua_pushinteger(L, SOUND_PRIORITY_NORMAL);
+    lua_setglobal(L, "SOUND_PRIORITY_NORMAL");
+    lua_pushinteger(L, SOUND_PRIORITY_HIGH);
+    lua_setglobal(L, "SOUND_PRIORITY_HIGH");
+    lua_pushinteger(L, SOUND_PRIORITY_CRITICAL);
+    lua_setglobal(L, "SOUND_PRIORITY_CRITICAL");
+
+    // Memory tags
+    lua_pushinteger(L, MEMORY_GENERAL);
+    lua_setglobal(L, "MEMORY_GENERAL");
+    lua_pushinteger(L, MEMORY_GRAPHICS);
+    lua_setglobal(L, "MEMORY_GRAPHICS");
+    lua_pushinteger(L, MEMORY_SOUND);
+    lua_setglobal(L, "MEMORY_SOUND");
+    lua_pushinteger(L, MEMORY_SCRIPT);
+    lua_setglobal(L, "MEMORY_SCRIPT");
+    lua_pushinteger(L, MEMORY_WORLD);
+    lua_setglobal(L, "MEMORY_WORLD");
+    lua_pushinteger(L, MEMORY_AI);
+    lua_setglobal(L, "MEMORY_AI");
+    lua_pushinteger(L, MEMORY_CONTAINERS);
+    lua_setglobal(L, "MEMORY_CONTAINERS");
 }
 
 lua_State* ScriptModule::EnterMission(const char* path, s32 location)
 {
     // Create mission lua state
-    lua_State* pScript = luaL_newstate();
+    lua_State* pScript = NewLuaState();
     luaL_openlibs(pScript);
 
+    // Create coroutine scheduler
+    ScriptScheduler* pScheduler = new ScriptScheduler();
+    pScheduler->StartUp(pScript);
+    m_lstScheduler.Push(pScheduler);
+
+    lua_pushlightuserdata(pScript, pScheduler);
+    lua_setfield(pScript, LUA_REGISTRYINDEX, SCHEDULER_REGISTRY_KEY);
+
     // Define all engine stuff
     DefineFunctions(pScript);
     DefineSymbols(pScript);
     if (!CheckLua(pScript, luaL_dostring(pScript, SCRIPT_SET_UP)))
     {
-        lua_close(pScript);
+        ExitMission(pScript);
         return nullptr;
     }
 
+    // Put precompiled internal libraries
+    PreloadLibraries(pScript);
+
     // Try to open script
     if (!CheckLua(pScript, luaL_dofile(pScript, path)))
     {
-        lua_close(pScript);
+        ExitMission(pScript);
         return nullptr;
     }
 
@@ -319,7 +569,7 @@ lua_State* ScriptModule::EnterMission(const char* path, s32 location)
     {
         LuaNote(PR_ERROR, "EnterMission(): global <Mission> is not table");
         lua_pop(pScript, 1);
-        lua_close(pScript);
+        ExitMission(pScript);
         return nullptr;
     }
 
@@ -329,7 +579,7 @@ lua_State* ScriptModule::EnterMission(const char* path, s32 location)
     {
         LuaNote(PR_ERROR, "EnterMission(): <Mission.onEnter> is not function");
         lua_pop(pScript, 2);
-        lua_close(pScript);
+        ExitMission(pScript);
         return nullptr;
     }
 
@@ -338,7 +588,7 @@ lua_State* ScriptModule::EnterMission(const char* path, s32 location)
     if (!CheckLua(pScript, lua_pcall(pScript, 1, 0, 0)))
     {
         lua_pop(pScript, 1);
-        lua_close(pScript);
+        ExitMission(pScript);
         return nullptr;
     }
 
@@ -352,6 +602,14 @@ void ScriptModule::ExitMission(lua_State* pScript)
 {
     if (pScript)
     {
+        ScriptScheduler* pScheduler = GetScheduler(pScript);
+        if (pScheduler)
+        {
+            m_lstScheduler.Remove(pScheduler);
+            pScheduler->ShutDown();
+            delete pScheduler;
+        }
+
         lua_close(pScript);
     }
 }
@@ -390,6 +648,9 @@ void ScriptModule::SwitchLocation(lua_State* pScript, s32 location)
 
 void ScriptModule::UpdateMission(lua_State* pScript, f32 dtTime)
 {
+    // Resume coroutines which are ready
+    GetScheduler(pScript)->Update(dtTime);
+
     // Get Mission table
     lua_getglobal(pScript, "Mission");
     if (!lua_istable(pScript, -1))
@@ -453,6 +714,42 @@ void ScriptModule::RenderMission(lua_State* pScript)
     lua_pop(pScript, 1);
 }
 
+b32 ScriptModule::SelectApi(lua_State* pScript, b32 bFFI)
+{
+    // Get Api table
+    lua_getglobal(pScript, "Api");
+    if (!lua_istable(pScript, -1))
+    {
+        LuaNote(PR_ERROR, "SelectApi(): global <Api> is not table");
+        lua_pop(pScript, 1);
+        return false;
+    }
+
+    // Get select function
+    lua_getfield(pScript, -1, "select");
+    if (!lua_isfunction(pScript, -1))
+    {
+        LuaNote(PR_ERROR, "SelectApi(): <Api.select> is not function");
+        lua_pop(pScript, 2);
+        return false;
+    }
+
+    // Call Api.select(bFFI)
+    lua_pushboolean(pScript, bFFI);
+    if (lua_pcall(pScript, 1, 1, 0) != 0)
+    {
+        LuaNote(PR_ERROR, "SelectApi(): %s", lua_tostring(pScript, -1));
+        lua_pop(pScript, 2);
+        return false;
+    }
+
+    // Pop result and table
+    b32 bSelected = lua_toboolean(pScript, -1);
+    lua_pop(pScript, 2);
+
+    return bSelected;
+}
+
 void ScriptModule::CallFunction(lua_State* pScript, const char* functionName, void* userdata)
 {
     // Check for null
@@ -598,19 +895,17 @@ void ScriptModule::Interpret(lua_State* pScript, const char* text)
 {
     if (0 != luaL_dostring(pScript, text))
     {
-        LuaNote(PR_WARNING, lua_tostring(pScript, -1));
+        LuaNote(PR_WARNING, "%s", lua_tostring(pScript, -1));
         lua_pop(pScript, 1);
     }
 }
 
-void ScriptModule::LuaNote(s32 priority, const char* fmt, ...)
+void ScriptModule::SignalEvent(Entity* pEntity, s32 event)
 {
-    std::va_list vl;
-    va_start(vl, fmt);
-
-    g_debugLogMgr.VAddNote(CHANNEL_SCRIPT, priority, "Lua", fmt, vl);
-
-    va_end(vl);
+    for (auto it = m_lstScheduler.Begin(); it; ++it)
+    {
+        it->data->Signal(pEntity, event);
+    }
 }
 
 b32 ScriptModule::LuaExpect(lua_State* L, const char* funName, s32 expect)
@@ -627,6 +922,101 @@ b32 ScriptModule::LuaExpect(lua_State* L, const char* funName, s32 expect)
     }
 }
 
+void* ScriptModule::LuaToPointer(lua_State* L, s32 index)
+{
+    // Accept both raw pointers and objects with Pointer field
+    if (lua_istable(L, index))
+    {
+        lua_getfield(L, index, "Pointer");
+        void* p = lua_touserdata(L, -1);
+        lua_pop(L, 1);
+        return p;
+    }
+
+    return lua_touserdata(L, index);
+}
+
+const Animation* ScriptModule::LuaToAnimation(lua_State* L, s32 index)
+{
+    if (lua_type(L, index) != LUA_TSTRING)
+    {
+        return (const Animation*)lua_touserdata(L, index);
+    }
+
+    const char* name = lua_tostring(L, index);
+    const Animation* pAnim = g_animModule.FindAnimation(name);
+    if (!pAnim)
+    {
+        LuaNote(PR_WARNING, "There's no animation named %s", name);
+    }
+    return pAnim;
+}
+
+ScriptScheduler* ScriptModule::GetScheduler(lua_State* L)
+{
+    lua_getfield(L, LUA_REGISTRYINDEX, SCHEDULER_REGISTRY_KEY);
+    ScriptScheduler* pScheduler = (ScriptScheduler*)lua_touserdata(L, -1);
+    lua_pop(L, 1);
+
+    return pScheduler;
+}
+
+s32 ScriptModule::WaitEvent(lua_State* L, const char* funName, s32 event)
+{
+    if (!LuaExpect(L, funName, 1))
+    {
+        return -1;
+    }
+
+    if (!LuaCompat::IsYieldable(L))
+    {
+        LuaNote(PR_WARNING, "%s() called outside of script coroutine", funName);
+        return -1;
+    }
+
+    Entity* pEntity = (Entity*)lua_touserdata(L, 1);
+    if (!g_game.GetWorld().HasEntity(pEntity))
+    {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    // Check if event has already happened
+    b32 bHappened = false;
+    switch (event)
+    {
+    case SCRIPT_EVENT_ANIMATION_END:
+    {
+        bHappened = pEntity->GetType() != ENTITY_TYPE_ACTOR || static_cast<Actor*>(pEntity)->m_actorState != ACTOR_STATE_ANIMATE_ONCE;
+    } break;
+
+    case SCRIPT_EVENT_DIALOG_CLOSE:
+    {
+        bHappened = pEntity->GetType() != ENTITY_TYPE_DIALOG || !static_cast<Dialog*>(pEntity)->Running();
+    } break;
+
+    case SCRIPT_EVENT_DEATH:
+    {
+        bHappened = pEntity->GetType() != ENTITY_TYPE_ACTOR || static_cast<Actor*>(pEntity)->m_actorState == ACTOR_STATE_DEAD;
+    } break;
+
+    default: {} break;
+    }
+
+    if (bHappened)
+    {
+        lua_pushboolean(L, true);
+        return 1;
+    }
+
+    // Reference running coroutine and sleep
+    lua_pushthread(L);
+    s32 ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    GetScheduler(L)->WaitEvent(ref, pEntity, event);
+
+    return lua_yield(L, 0);
+}
+
 b32 ScriptModule::CheckLua(lua_State* L, s32 res)
 {
     if (res != LUA_OK)
@@ -646,9 +1036,9 @@ s32 ScriptModule::_GT_LOG(lua_State* L)
         return -1;
     }
 
-    if (lua_isinteger(L, 1) && lua_isstring(L, 2))
+    if (LuaCompat::IsInteger(L, 1) && lua_isstring(L, 2))
     {
-        LuaNote((s32)lua_tointeger(L, 1), lua_tostring(L, 2));
+        LuaNote((s32)lua_tointeger(L, 1), "%s", lua_tostring(L, 2));
     }
 
     return 0;
@@ -670,6 +1060,77 @@ s32 ScriptModule::_dostring(lua_State* L)
     return 0;
 }
 
+s32 ScriptModule::_runScript(lua_State* L)
+{
+    if (!LuaExpect(L, "runScript", 1))
+    {
+        return -1;
+    }
+
+    if (!lua_isfunction(L, 1))
+    {
+        LuaNote(PR_WARNING, "runScript() expects function");
+        return -1;
+    }
+
+    // Run function as coroutine until it waits or ends
+    lua_State* pThread = lua_newthread(L);
+    lua_pushvalue(L, 1);
+    lua_xmove(L, pThread, 1);
+
+    s32 results;
+    s32 res = LuaCompat::Resume(pThread, L, 0, &results);
+    if (res == LUA_OK || res == LUA_YIELD)
+    {
+        lua_pop(pThread, results);
+    }
+    else
+    {
+        LuaNote(PR_ERROR, "runScript(): %s", lua_tostring(pThread, -1));
+    }
+
+    // Pop thread, scheduler keeps reference if it's waiting
+    lua_pop(L, 1);
+    return 0;
+}
+
+s32 ScriptModule::_waitTime(lua_State* L)
+{
+    if (!LuaExpect(L, "waitTime", 1))
+    {
+        return -1;
+    }
+
+    if (!LuaCompat::IsYieldable(L))
+    {
+        LuaNote(PR_WARNING, "waitTime() called outside of script coroutine");
+        return -1;
+    }
+
+    f32 time = (f32)lua_tonumber(L, 1);
+
+    lua_pushthread(L);
+    s32 ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    GetScheduler(L)->WaitTime(ref, time);
+
+    return lua_yield(L, 0);
+}
+
+s32 ScriptModule::_waitAnimation(lua_State* L)
+{
+    return WaitEvent(L, "waitAnimation", SCRIPT_EVENT_ANIMATION_END);
+}
+
+s32 ScriptModule::_waitDialog(lua_State* L)
+{
+    return WaitEvent(L, "waitDialog", SCRIPT_EVENT_DIALOG_CLOSE);
+}
+
+s32 ScriptModule::_waitDeath(lua_State* L)
+{
+    return WaitEvent(L, "waitDeath", SCRIPT_EVENT_DEATH);
+}
+
 s32 ScriptModule::_showCursor(lua_State* L)
 {
     if (!LuaExpect(L, "showCursor", 0))
@@ -802,6 +1263,28 @@ s32 ScriptModule::_drawRect(lua_State* L)
     return 0;
 }
 
+s32 ScriptModule::_setLayerCached(lua_State* L)
+{
+    if (!LuaExpect(L, "setLayerCached", 2))
+    {
+        return -1;
+    }
+
+    g_graphicsModule.SetLayerCached((s32)lua_tointeger(L, 1), (b32)lua_toboolean(L, 2));
+    return 0;
+}
+
+s32 ScriptModule::_setPartialRedraw(lua_State* L)
+{
+    if (!LuaExpect(L, "setPartialRedraw", 1))
+    {
+        return -1;
+    }
+
+    g_graphicsModule.SetPartialRedraw((b32)lua_toboolean(L, 1));
+    return 0;
+}
+
 s32 ScriptModule::_attachCamera(lua_State* L)
 {
     if (!LuaExpect(L, "attachCamera", 1))
@@ -855,126 +1338,500 @@ s32 ScriptModule::_setCameraBounds(lua_State* L)
     return 0;
 }
 
-s32 ScriptModule::_getCameraPosition(lua_State* L)
+s32 ScriptModule::_getCameraPosition(lua_State* L)
+{
+    if (!LuaExpect(L, "getCameraPosition", 0))
+    {
+        return -1;
+    }
+
+    s32 x, y;
+    g_graphicsModule.GetCamera().GetPosition(x, y);
+
+    lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX((f32)x));
+    lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY((f32)y));
+    return 2;
+}
+
+s32 ScriptModule::_createTilemap(lua_State* L)
+{
+    if (!LuaExpect(L, "createTilemap", 5))
+    {
+        return -1;
+    }
+
+    lua_pushboolean(
+        L,
+        g_tilemap.Create(
+            (s32)lua_tointeger(L, 1), (s32)lua_tointeger(L, 2),
+            (f32)lua_tonumber(L, 3), (f32)lua_tonumber(L, 4),
+            (s32)lua_tointeger(L, 5)
+        )
+    );
+    return 1;
+}
+
+s32 ScriptModule::_loadTilemap(lua_State* L)
+{
+    if (!LuaExpect(L, "loadTilemap", 1))
+    {
+        return -1;
+    }
+
+    lua_pushboolean(L, g_tilemap.Load(lua_tostring(L, 1)));
+    return 1;
+}
+
+s32 ScriptModule::_saveTilemap(lua_State* L)
+{
+    if (!LuaExpect(L, "saveTilemap", 1))
+    {
+        return -1;
+    }
+
+    lua_pushboolean(L, g_tilemap.Save(lua_tostring(L, 1)));
+    return 1;
+}
+
+s32 ScriptModule::_unloadTilemap(lua_State* L)
+{
+    if (!LuaExpect(L, "unloadTilemap", 0))
+    {
+        return -1;
+    }
+
+    g_tilemap.Unload();
+    return 0;
+}
+
+s32 ScriptModule::_defineTileset(lua_State* L)
+{
+    if (!LuaExpect(L, "defineTileset", 1))
+    {
+        return -1;
+    }
+
+    lua_pushinteger(L, g_tilemap.DefineTileset((const Texture*)lua_touserdata(L, 1)));
+    return 1;
+}
+
+s32 ScriptModule::_setTilemapLayer(lua_State* L)
+{
+    if (!LuaExpect(L, "setTilemapLayer", 3))
+    {
+        return -1;
+    }
+
+    g_tilemap.SetLayer((s32)lua_tointeger(L, 1), (s32)lua_tointeger(L, 2), (s32)lua_tointeger(L, 3));
+    return 0;
+}
+
+s32 ScriptModule::_setTile(lua_State* L)
+{
+    if (!LuaExpect(L, "setTile", 4))
+    {
+        return -1;
+    }
+
+    g_tilemap.SetTile((s32)lua_tointeger(L, 1), (s32)lua_tointeger(L, 2), (s32)lua_tointeger(L, 3), (u16)lua_tointeger(L, 4));
+    return 0;
+}
+
+s32 ScriptModule::_getTile(lua_State* L)
+{
+    if (!LuaExpect(L, "getTile", 3))
+    {
+        return -1;
+    }
+
+    lua_pushinteger(L, g_tilemap.GetTile((s32)lua_tointeger(L, 1), (s32)lua_tointeger(L, 2), (s32)lua_tointeger(L, 3)));
+    return 1;
+}
+
+s32 ScriptModule::_getTileAt(lua_State* L)
+{
+    if (!LuaExpect(L, "getTileAt", 3))
+    {
+        return -1;
+    }
+
+    s32 tileX, tileY;
+    if (!g_tilemap.GetTileCoords(
+            g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 2)),
+            g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 3)),
+            tileX, tileY
+        ))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushinteger(L, g_tilemap.GetTile((s32)lua_tointeger(L, 1), tileX, tileY));
+    lua_pushinteger(L, tileX);
+    lua_pushinteger(L, tileY);
+    return 3;
+}
+
+s32 ScriptModule::_getTilemapSize(lua_State* L)
+{
+    if (!LuaExpect(L, "getTilemapSize", 0))
+    {
+        return -1;
+    }
+
+    lua_pushinteger(L, g_tilemap.GetWidth());
+    lua_pushinteger(L, g_tilemap.GetHeight());
+    lua_pushinteger(L, g_tilemap.GetLayerCount());
+    return 3;
+}
+
+s32 ScriptModule::_getRenderTimes(lua_State* L)
+{
+    if (!LuaExpect(L, "getRenderTimes", 0))
+    {
+        return -1;
+    }
+
+    lua_pushnumber(L, g_graphicsModule.GetRecordTime());
+    lua_pushnumber(L, g_graphicsModule.GetSubmitTime());
+    lua_pushnumber(L, g_graphicsModule.GetWaitTime());
+    return 3;
+}
+
+s32 ScriptModule::_getRenderStats(lua_State* L)
+{
+    if (!LuaExpect(L, "getRenderStats", 0))
+    {
+        return -1;
+    }
+
+    RenderStats stats;
+    g_graphicsModule.GetRenderStats(stats);
+
+    lua_newtable(L);
+
+    lua_pushinteger(L, stats.aElements[RENDER_MODE_BACKGROUND]);
+    lua_setfield(L, -2, "Background");
+    lua_pushinteger(L, stats.aElements[RENDER_MODE_DYNAMIC]);
+    lua_setfield(L, -2, "Dynamic");
+    lua_pushinteger(L, stats.aElements[RENDER_MODE_FOREGROUND]);
+    lua_setfield(L, -2, "Foreground");
+    lua_pushinteger(L, stats.aElements[RENDER_MODE_DEBUG]);
+    lua_setfield(L, -2, "Debug");
+    lua_pushinteger(L, stats.culledElements);
+    lua_setfield(L, -2, "Culled");
+    lua_pushnumber(L, stats.sortTime);
+    lua_setfield(L, -2, "SortTime");
+
+    lua_pushinteger(L, stats.drawCalls);
+    lua_setfield(L, -2, "DrawCalls");
+    lua_pushinteger(L, stats.textureBinds);
+    lua_setfield(L, -2, "TextureBinds");
+    lua_pushinteger(L, stats.blendChanges);
+    lua_setfield(L, -2, "BlendChanges");
+    lua_pushinteger(L, stats.textRasterizations);
+    lua_setfield(L, -2, "TextRasterizations");
+
+    return 1;
+}
+
+s32 ScriptModule::_getMemoryStats(lua_State* L)
+{
+    if (!LuaExpect(L, "getMemoryStats", 0))
+    {
+        return -1;
+    }
+
+    MemoryStats stats;
+    lua_newtable(L);
+
+    for (i32f i = 0; i < MEMORY_TAG_COUNT; ++i)
+    {
+        g_memoryTracker.GetStats(i, stats);
+
+        lua_newtable(L);
+        lua_pushinteger(L, stats.liveBytes);
+        lua_setfield(L, -2, "Live");
+        lua_pushinteger(L, stats.peakBytes);
+        lua_setfield(L, -2, "Peak");
+        lua_pushinteger(L, stats.liveAllocs);
+        lua_setfield(L, -2, "Blocks");
+        lua_pushinteger(L, stats.frameAllocs);
+        lua_setfield(L, -2, "FrameAllocs");
+        lua_pushinteger(L, stats.frameBytes);
+        lua_setfield(L, -2, "FrameBytes");
+        lua_pushinteger(L, stats.budget);
+        lua_setfield(L, -2, "Budget");
+
+        lua_setfield(L, -2, MemoryTracker::GetTagName(i));
+    }
+
+    return 1;
+}
+
+s32 ScriptModule::_setMemoryBudget(lua_State* L)
+{
+    if (!LuaExpect(L, "setMemoryBudget", 2))
+    {
+        return -1;
+    }
+
+    s32 tag = (s32)lua_tointeger(L, 1);
+    if (tag < 0 || tag >= MEMORY_TAG_COUNT)
+    {
+        LuaNote(PR_WARNING, "setMemoryBudget(): unknown tag %d", tag);
+        return 0;
+    }
+
+    g_memoryTracker.SetBudget(tag, (s32)lua_tointeger(L, 2));
+    return 0;
+}
+
+s32 ScriptModule::_writeMemoryReport(lua_State* L)
+{
+    const char* path = lua_gettop(L) >= 1 ? lua_tostring(L, 1) : nullptr;
+
+    lua_pushboolean(L, g_memoryTracker.WriteReport(path ? path : "Logs/Memory.txt"));
+    return 1;
+}
+
+s32 ScriptModule::_showOverdraw(lua_State* L)
+{
+    if (!LuaExpect(L, "showOverdraw", 1))
+    {
+        return -1;
+    }
+
+    g_graphicsModule.SetOverdrawShown((b32)lua_toboolean(L, 1));
+    return 0;
+}
+
+s32 ScriptModule::_hostSwitchLocation(lua_State* L)
+{
+    if (!LuaExpect(L, "hostSwitchLocation", 1))
+    {
+        return -1;
+    }
+
+    g_game.GetWorld().SwitchLocation((s32)lua_tointeger(L, 1));
+    return 0;
+}
+
+s32 ScriptModule::_setGroundBounds(lua_State* L)
+{
+    if (!LuaExpect(L, "setGroundBounds", 4))
+    {
+        return -1;
+    }
+
+    SRect rect;
+    rect.x1 = (s32)( g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 1)) );
+    rect.y1 = (s32)( g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 2)) );
+    rect.x2 = rect.x1 + (s32)( g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 3)) ) - 1;
+    rect.y2 = rect.y1 + (s32)( g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 4)) ) - 1,
+
+    g_game.GetWorld().SetGroundBounds(rect);
+    return 0;
+}
+
+s32 ScriptModule::_hasWorldEntity(lua_State* L)
+{
+    if (!LuaExpect(L, "hasWorldEntity", 1))
+    {
+        return -1;
+    }
+
+    Entity* pEntity = (Entity*)lua_touserdata(L, 1);
+    b32 bAvailable = g_game.GetWorld().HasEntity(pEntity);
+
+    lua_pushboolean(L, bAvailable);
+    return 1;
+}
+
+s32 ScriptModule::_getWorldUpdateTime(lua_State* L)
+{
+    if (!LuaExpect(L, "getWorldUpdateTime", 0))
+    {
+        return -1;
+    }
+
+    lua_pushnumber(L, g_game.GetWorld().GetUpdateTime());
+    return 1;
+}
+
+s32 ScriptModule::_benchKernels(lua_State* L)
+{
+    if (!LuaExpect(L, "benchKernels", 2))
+    {
+        return -1;
+    }
+
+    Kernels::Benchmark((s32)lua_tointeger(L, 1), (s32)lua_tointeger(L, 2));
+    return 0;
+}
+
+s32 ScriptModule::_defineSound(lua_State* L)
+{
+    if (!LuaExpect(L, "defineSound", 1))
+    {
+        return -1;
+    }
+
+    lua_pushlightuserdata(L, g_soundModule.DefineWAV(lua_tostring(L, 1)));
+    return 1;
+}
+
+s32 ScriptModule::_playSound(lua_State* L)
+{
+    if (!LuaExpect(L, "playSound", 1))
+    {
+        return -1;
+    }
+
+    g_soundModule.PlaySound( (Sound*)lua_touserdata(L, 1) );
+    return 0;
+}
+
+s32 ScriptModule::_playSoundLooped(lua_State* L)
 {
-    if (!LuaExpect(L, "getCameraPosition", 0))
+    if (!LuaExpect(L, "playSound", 1))
     {
         return -1;
     }
 
-    s32 x, y;
-    g_graphicsModule.GetCamera().GetPosition(x, y);
-
-    lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX((f32)x));
-    lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY((f32)y));
-    return 2;
+    g_soundModule.PlaySound((Sound*)lua_touserdata(L, 1), true);
+    return 0;
 }
 
-s32 ScriptModule::_hostSwitchLocation(lua_State* L)
+s32 ScriptModule::_playSoundAt(lua_State* L)
 {
-    if (!LuaExpect(L, "hostSwitchLocation", 1))
+    if (!LuaExpect(L, "playSoundAt", 3))
     {
         return -1;
     }
 
-    g_game.GetWorld().SwitchLocation((s32)lua_tointeger(L, 1));
+    Vector2 vPosition((f32)lua_tonumber(L, 2), (f32)lua_tonumber(L, 3));
+    g_soundModule.PlaySoundAt((Sound*)lua_touserdata(L, 1), vPosition);
     return 0;
 }
 
-s32 ScriptModule::_setGroundBounds(lua_State* L)
+s32 ScriptModule::_setSoundPriority(lua_State* L)
 {
-    if (!LuaExpect(L, "setGroundBounds", 4))
+    if (!LuaExpect(L, "setSoundPriority", 3))
     {
         return -1;
     }
 
-    SRect rect;
-    rect.x1 = (s32)( g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 1)) );
-    rect.y1 = (s32)( g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 2)) );
-    rect.x2 = rect.x1 + (s32)( g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 3)) ) - 1;
-    rect.y2 = rect.y1 + (s32)( g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 4)) ) - 1,
-
-    g_game.GetWorld().SetGroundBounds(rect);
+    g_soundModule.SetSoundPriority((Sound*)lua_touserdata(L, 1), (s32)lua_tointeger(L, 2), (s32)lua_tointeger(L, 3));
     return 0;
 }
 
-s32 ScriptModule::_hasWorldEntity(lua_State* L)
+s32 ScriptModule::_getVoiceStats(lua_State* L)
 {
-    if (!LuaExpect(L, "hasWorldEntity", 1))
+    if (!LuaExpect(L, "getVoiceStats", 0))
     {
         return -1;
     }
 
-    Entity* pEntity = (Entity*)lua_touserdata(L, 1);
-    b32 bAvailable = g_game.GetWorld().HasEntity(pEntity);
+    const VoiceStats& stats = g_soundModule.GetVoiceStats();
+
+    lua_newtable(L);
+
+    lua_pushinteger(L, stats.voiceCount);
+    lua_setfield(L, -2, "Voices");
+    lua_pushinteger(L, stats.activeVoices);
+    lua_setfield(L, -2, "Active");
+    lua_pushinteger(L, stats.peakVoices);
+    lua_setfield(L, -2, "Peak");
+
+    lua_pushinteger(L, stats.played);
+    lua_setfield(L, -2, "Played");
+    lua_pushinteger(L, stats.stolen);
+    lua_setfield(L, -2, "Stolen");
+    lua_pushinteger(L, stats.limited);
+    lua_setfield(L, -2, "Limited");
+    lua_pushinteger(L, stats.culled);
+    lua_setfield(L, -2, "Culled");
+    lua_pushinteger(L, stats.rejected);
+    lua_setfield(L, -2, "Rejected");
 
-    lua_pushboolean(L, bAvailable);
     return 1;
 }
 
-s32 ScriptModule::_defineSound(lua_State* L)
+s32 ScriptModule::_stopAllSounds(lua_State* L)
 {
-    if (!LuaExpect(L, "defineSound", 1))
+    if (!LuaExpect(L, "stopAllSounds", 0))
     {
         return -1;
     }
 
-    lua_pushlightuserdata(L, g_soundModule.DefineWAV(lua_tostring(L, 1)));
-    return 1;
+    g_soundModule.StopSounds();
+    return 0;
 }
 
-s32 ScriptModule::_playSound(lua_State* L)
+s32 ScriptModule::_releaseSound(lua_State* L)
 {
-    if (!LuaExpect(L, "playSound", 1))
+    if (!LuaExpect(L, "releaseSound", 1))
     {
         return -1;
     }
 
-    g_soundModule.PlaySound( (Sound*)lua_touserdata(L, 1) );
+    g_soundModule.ReleaseSound((Sound*)lua_touserdata(L, 1));
     return 0;
 }
 
-s32 ScriptModule::_playSoundLooped(lua_State* L)
+s32 ScriptModule::_defineMusic(lua_State* L)
 {
-    if (!LuaExpect(L, "playSound", 1))
+    if (!LuaExpect(L, "defineMusic", 1))
     {
         return -1;
     }
 
-    g_soundModule.PlaySound((Sound*)lua_touserdata(L, 1), true);
+    lua_pushlightuserdata(L, g_soundModule.DefineMusic(lua_tostring(L, 1)));
+    return 1;
+}
+
+s32 ScriptModule::_playMusic(lua_State* L)
+{
+    if (!LuaExpect(L, "playMusic", 1))
+    {
+        return -1;
+    }
+
+    g_soundModule.PlayMusic( (Music*)lua_touserdata(L, 1) );
     return 0;
 }
 
-s32 ScriptModule::_stopAllSounds(lua_State* L)
+s32 ScriptModule::_fadeInMusic(lua_State* L)
 {
-    if (!LuaExpect(L, "stopAllSounds", 0))
+    if (!LuaExpect(L, "fadeInMusic", 2))
     {
         return -1;
     }
 
-    g_soundModule.StopSounds();
+    g_soundModule.PlayMusic((Music*)lua_touserdata(L, 1), (s32)lua_tointeger(L, 2));
     return 0;
 }
 
-s32 ScriptModule::_defineMusic(lua_State* L)
+s32 ScriptModule::_fadeOutMusic(lua_State* L)
 {
-    if (!LuaExpect(L, "defineMusic", 1))
+    if (!LuaExpect(L, "fadeOutMusic", 1))
     {
         return -1;
     }
 
-    lua_pushlightuserdata(L, g_soundModule.DefineMusic(lua_tostring(L, 1)));
-    return 1;
+    g_soundModule.FadeOutMusic((s32)lua_tointeger(L, 1));
+    return 0;
 }
 
-s32 ScriptModule::_playMusic(lua_State* L)
+s32 ScriptModule::_releaseMusic(lua_State* L)
 {
-    if (!LuaExpect(L, "playMusic", 1))
+    if (!LuaExpect(L, "releaseMusic", 1))
     {
         return -1;
     }
 
-    g_soundModule.PlayMusic( (Music*)lua_touserdata(L, 1) );
+    g_soundModule.ReleaseMusic((Music*)lua_touserdata(L, 1));
     return 0;
 }
 
@@ -1041,6 +1898,47 @@ s32 ScriptModule::_defineAnimation(lua_State* L)
     return 1;
 }
 
+s32 ScriptModule::_defineNamedAnimation(lua_State* L)
+{
+    if (!LuaExpect(L, "defineNamedAnimation", 4))
+    {
+        return -1;
+    }
+    if (lua_type(L, 1) != LUA_TSTRING)
+    {
+        LuaNote(PR_WARNING, "defineNamedAnimation() called without name");
+        return -1;
+    }
+
+    Animation anim = { (s32)lua_tointeger(L, 2), (s32)lua_tointeger(L, 3), (f32)lua_tonumber(L, 4) };
+    lua_pushlightuserdata(L, (void*)g_animModule.DefineAnimation(lua_tostring(L, 1), anim));
+    return 1;
+}
+
+s32 ScriptModule::_findAnimation(lua_State* L)
+{
+    if (!LuaExpect(L, "findAnimation", 1))
+    {
+        return -1;
+    }
+    if (lua_type(L, 1) != LUA_TSTRING)
+    {
+        LuaNote(PR_WARNING, "findAnimation() called without name");
+        return -1;
+    }
+
+    const Animation* pAnim = g_animModule.FindAnimation(lua_tostring(L, 1));
+    if (pAnim)
+    {
+        lua_pushlightuserdata(L, (void*)pAnim);
+    }
+    else
+    {
+        lua_pushnil(L);
+    }
+    return 1;
+}
+
 s32 ScriptModule::_getTicks(lua_State* L)
 {
     if (!LuaExpect(L, "getTicks", 0))
@@ -1203,10 +2101,10 @@ s32 ScriptModule::_setEntityPosition(lua_State* L)
         LuaNote(PR_WARNING, "setEntityPosition() called with null entity");
         return -1;
     }
-    pEntity->m_vPosition = {
+    pEntity->SetPosition({
         g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 2)),
         g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 3))
-    };
+    });
 
     return 0;
 }
@@ -1221,8 +2119,8 @@ s32 ScriptModule::_getEntityPosition(lua_State* L)
     Entity* pEntity = (Entity*)lua_touserdata(L, 1);
     if (pEntity)
     {
-        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX(pEntity->m_vPosition.x));
-        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY(pEntity->m_vPosition.y));
+        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX(pEntity->Position().x));
+        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY(pEntity->Position().y));
     }
     else
     {
@@ -1247,7 +2145,7 @@ s32 ScriptModule::_setEntityVelocity(lua_State* L)
         LuaNote(PR_WARNING, "setEntityVelocity() called with null entity");
         return -1;
     }
-    pEntity->m_vVelocity = {
+    pEntity->Velocity() = {
         g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 2)),
         g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 3))
     };
@@ -1265,8 +2163,8 @@ s32 ScriptModule::_getEntityVelocity(lua_State* L)
     Entity* pEntity = (Entity*)lua_touserdata(L, 1);
     if (pEntity)
     {
-        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX(pEntity->m_vVelocity.x));
-        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY(pEntity->m_vVelocity.y));
+        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX(pEntity->Velocity().x));
+        lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY(pEntity->Velocity().y));
     }
     else
     {
@@ -1291,12 +2189,12 @@ s32 ScriptModule::_setEntityHitBox(lua_State* L)
         LuaNote(PR_WARNING, "setEntityHitBox() called with null entity");
         return -1;
     }
-    pEntity->m_hitBox = {
+    pEntity->SetHitBox({
         g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 2)),
         g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 3)),
         g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 4)),
         g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 5)),
-    };
+    });
 
     return 0;
 }
@@ -1315,7 +2213,7 @@ s32 ScriptModule::_getEntityHitBox(lua_State* L)
         return -1;
     }
 
-    const FRect& hitBox = pEntity->m_hitBox;
+    const FRect& hitBox = pEntity->HitBox();
     lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX(hitBox.x1));
     lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY(hitBox.y1));
     lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX(hitBox.x2));
@@ -1337,7 +2235,7 @@ s32 ScriptModule::_toggleEntityCollidable(lua_State* L)
         LuaNote(PR_WARNING, "toggleEntityCollidable() called with null entity");
         return -1;
     }
-    pEntity->m_bCollidable = (b32)lua_toboolean(L, 2);
+    pEntity->Collidable() = (b32)lua_toboolean(L, 2);
 
     return 0;
 }
@@ -1355,7 +2253,7 @@ s32 ScriptModule::_getEntityCollidable(lua_State* L)
         LuaNote(PR_WARNING, "getEntityCollidable(): function called with null entity");
         return -1;
     }
-    lua_pushboolean(L, pEntity->m_bCollidable);
+    lua_pushboolean(L, pEntity->Collidable());
 
     return 1;
 }
@@ -1373,7 +2271,7 @@ s32 ScriptModule::_setEntityAnimFrame(lua_State* L)
         LuaNote(PR_WARNING, "setEntityAnimFrame(): function called with null entity");
         return -1;
     }
-    pEntity->m_animFrame = (s32)lua_tointeger(L, 2);
+    pEntity->AnimFrame() = (s32)lua_tointeger(L, 2);
 
     return 0;
 }
@@ -1388,7 +2286,7 @@ s32 ScriptModule::_getEntityAnimFrame(lua_State* L)
     Entity* pEntity = (Entity*)lua_touserdata(L, 1);
     if (pEntity)
     {
-        lua_pushinteger(L, pEntity->m_animFrame);
+        lua_pushinteger(L, pEntity->AnimFrame());
     }
     else
     {
@@ -1412,7 +2310,7 @@ s32 ScriptModule::_setEntityAnimElapsed(lua_State* L)
         LuaNote(PR_WARNING, "setEntityAnimElapsed(): function called with null entity");
         return -1;
     }
-    pEntity->m_animElapsed = (f32)lua_tonumber(L, 2);
+    pEntity->AnimElapsed() = (f32)lua_tonumber(L, 2);
 
     return 0;
 }
@@ -1427,7 +2325,7 @@ s32 ScriptModule::_getEntityAnimElapsed(lua_State* L)
     Entity* pEntity = (Entity*)lua_touserdata(L, 1);
     if (pEntity)
     {
-        lua_pushnumber(L, pEntity->m_animElapsed);
+        lua_pushnumber(L, pEntity->AnimElapsed());
     }
     else
     {
@@ -1451,7 +2349,7 @@ s32 ScriptModule::_setEntityAnim(lua_State* L)
         LuaNote(PR_WARNING, "setEntityAnim(): function called with null entity");
         return -1;
     }
-    pEntity->m_pAnim = (const Animation*)lua_touserdata(L, 2);
+    pEntity->Anim() = LuaToAnimation(L, 2);
 
     return 0;
 }
@@ -1466,7 +2364,7 @@ s32 ScriptModule::_getEntityAnim(lua_State* L)
     Entity* pEntity = (Entity*)lua_touserdata(L, 1);
     if (pEntity)
     {
-        lua_pushlightuserdata(L, (void*)pEntity->m_pAnim);
+        lua_pushlightuserdata(L, (void*)pEntity->Anim());
     }
     else
     {
@@ -1569,6 +2467,7 @@ s32 ScriptModule::_toggleEntityHUD(lua_State* L)
         return -1;
     }
     pEntity->m_bHUD = (b32)lua_toboolean(L, 2);
+    pEntity->SetCulled(!pEntity->m_bHUD && pEntity->GetType() != ENTITY_TYPE_DIALOG);
 
     return 0;
 }
@@ -1633,6 +2532,186 @@ s32 ScriptModule::_getEntityTexture(lua_State* L)
     return 1;
 }
 
+s32 ScriptModule::_setEntityPositions(lua_State* L)
+{
+    if (!LuaExpect(L, "setEntityPositions", 3))
+    {
+        return -1;
+    }
+
+    if (!lua_istable(L, 1) || !lua_istable(L, 2) || !lua_istable(L, 3))
+    {
+        LuaNote(PR_WARNING, "setEntityPositions() expects tables of entities, xs and ys");
+        return -1;
+    }
+
+    s32 count = (s32)LuaCompat::RawLength(L, 1);
+    if ((s32)LuaCompat::RawLength(L, 2) < count || (s32)LuaCompat::RawLength(L, 3) < count)
+    {
+        LuaNote(PR_WARNING, "setEntityPositions(): there're less coordinates than entities");
+        return -1;
+    }
+
+    s32 nulls = 0;
+    for (s32 i = 1; i <= count; ++i)
+    {
+        lua_rawgeti(L, 1, i);
+        lua_rawgeti(L, 2, i);
+        lua_rawgeti(L, 3, i);
+
+        Entity* pEntity = (Entity*)LuaToPointer(L, -3);
+        if (pEntity)
+        {
+            pEntity->SetPosition({
+                g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, -2)),
+                g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, -1))
+            });
+        }
+        else
+        {
+            ++nulls;
+        }
+
+        lua_pop(L, 3);
+    }
+
+    if (nulls)
+    {
+        LuaNote(PR_WARNING, "setEntityPositions() called with %d null entities", nulls);
+    }
+
+    return 0;
+}
+
+s32 ScriptModule::_getEntityPositions(lua_State* L)
+{
+    if (!LuaExpect(L, "getEntityPositions", 1))
+    {
+        return -1;
+    }
+
+    if (!lua_istable(L, 1))
+    {
+        LuaNote(PR_WARNING, "getEntityPositions() expects table of entities");
+        return -1;
+    }
+
+    s32 count = (s32)LuaCompat::RawLength(L, 1);
+    lua_createtable(L, count, 0);
+    lua_createtable(L, count, 0);
+
+    s32 nulls = 0;
+    for (s32 i = 1; i <= count; ++i)
+    {
+        lua_rawgeti(L, 1, i);
+        Entity* pEntity = (Entity*)LuaToPointer(L, -1);
+        lua_pop(L, 1);
+
+        if (pEntity)
+        {
+            lua_pushnumber(L, g_graphicsModule.PixelsToUnitsX(pEntity->Position().x));
+            lua_rawseti(L, -3, i);
+            lua_pushnumber(L, g_graphicsModule.PixelsToUnitsY(pEntity->Position().y));
+            lua_rawseti(L, -2, i);
+        }
+        else
+        {
+            ++nulls;
+            lua_pushnumber(L, 0.0f);
+            lua_rawseti(L, -3, i);
+            lua_pushnumber(L, 0.0f);
+            lua_rawseti(L, -2, i);
+        }
+    }
+
+    if (nulls)
+    {
+        LuaNote(PR_WARNING, "getEntityPositions() called with %d null entities", nulls);
+    }
+
+    return 2;
+}
+
+s32 ScriptModule::_setEntityVelocities(lua_State* L)
+{
+    if (!LuaExpect(L, "setEntityVelocities", 3))
+    {
+        return -1;
+    }
+
+    if (!lua_istable(L, 1) || !lua_istable(L, 2) || !lua_istable(L, 3))
+    {
+        LuaNote(PR_WARNING, "setEntityVelocities() expects tables of entities, xs and ys");
+        return -1;
+    }
+
+    s32 count = (s32)LuaCompat::RawLength(L, 1);
+    if ((s32)LuaCompat::RawLength(L, 2) < count || (s32)LuaCompat::RawLength(L, 3) < count)
+    {
+        LuaNote(PR_WARNING, "setEntityVelocities(): there're less coordinates than entities");
+        return -1;
+    }
+
+    s32 nulls = 0;
+    for (s32 i = 1; i <= count; ++i)
+    {
+        lua_rawgeti(L, 1, i);
+        lua_rawgeti(L, 2, i);
+        lua_rawgeti(L, 3, i);
+
+        Entity* pEntity = (Entity*)LuaToPointer(L, -3);
+        if (pEntity)
+        {
+            pEntity->Velocity() = {
+                g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, -2)),
+                g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, -1))
+            };
+        }
+        else
+        {
+            ++nulls;
+        }
+
+        lua_pop(L, 3);
+    }
+
+    if (nulls)
+    {
+        LuaNote(PR_WARNING, "setEntityVelocities() called with %d null entities", nulls);
+    }
+
+    return 0;
+}
+
+s32 ScriptModule::_getEntitiesInRect(lua_State* L)
+{
+    if (!LuaExpect(L, "getEntitiesInRect", 4))
+    {
+        return -1;
+    }
+
+    FRect rect = {
+        g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 1)),
+        g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 2)),
+        g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 3)),
+        g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 4))
+    };
+
+    // Push every entity which hitbox overlaps the rectangle
+    lua_newtable(L);
+    s32 count = 0;
+
+    EntityStore& store = g_game.GetWorld().GetEntityStore();
+    s32 found = store.Query(rect);
+    for (i32f i = 0; i < found; ++i)
+    {
+        lua_pushlightuserdata(L, (void*)store.GetQueryEntity(i));
+        lua_rawseti(L, -2, ++count);
+    }
+
+    return 1;
+}
+
 s32 ScriptModule::_addActor(lua_State* L)
 {
     if (!LuaExpect(L, "addActor", 5))
@@ -1702,6 +2781,31 @@ s32 ScriptModule::_getActorTeam(lua_State* L)
     return 1;
 }
 
+s32 ScriptModule::_getActorsByTeam(lua_State* L)
+{
+    if (!LuaExpect(L, "getActorsByTeam", 1))
+    {
+        return -1;
+    }
+
+    s32 team = (s32)lua_tointeger(L, 1);
+
+    lua_newtable(L);
+    s32 count = 0;
+
+    auto& lstEntity = g_game.GetWorld().GetEntityList();
+    for (auto it = lstEntity.Begin(); it; ++it)
+    {
+        if (it->data->GetType() == ENTITY_TYPE_ACTOR && static_cast<Actor*>(it->data)->m_actorTeam == team)
+        {
+            lua_pushlightuserdata(L, (void*)it->data);
+            lua_rawseti(L, -2, ++count);
+        }
+    }
+
+    return 1;
+}
+
 s32 ScriptModule::_setActorHealth(lua_State* L)
 {
     if (!LuaExpect(L, "setActorHealth", 2))
@@ -1937,6 +3041,7 @@ s32 ScriptModule::_pushActorTask(lua_State* L)
     }
 
     // Set task
+    MemoryScope scope(MEMORY_AI);
     switch (lua_tointeger(L, 2))
     {
     case AITASK_NONE:
@@ -1990,12 +3095,12 @@ s32 ScriptModule::_pushActorTask(lua_State* L)
 
     case AITASK_ANIMATE_FOR:
     {
-        pActor->PushTask(new AnimateForTask(pActor, (const Animation*)lua_touserdata(L, 3), (f32)lua_tonumber(L, 4)));
+        pActor->PushTask(new AnimateForTask(pActor, LuaToAnimation(L, 3), (f32)lua_tonumber(L, 4)));
     } break;
 
     case AITASK_WAIT_ANIMATION:
     {
-        pActor->PushTask(new WaitAnimationTask(pActor, (const Animation*)lua_touserdata(L, 3)));
+        pActor->PushTask(new WaitAnimationTask(pActor, LuaToAnimation(L, 3)));
     } break;
 
     case AITASK_WAIT_DIALOG:
@@ -2226,7 +3331,7 @@ s32 ScriptModule::_setActorAnim(lua_State* L)
     Actor* pActor = static_cast<Actor*>(lua_touserdata(L, 1));
     if (pActor)
     {
-        pActor->m_aActorAnims[lua_tointeger(L, 2)] = (const Animation*)lua_touserdata(L, 3);
+        pActor->m_aActorAnims[lua_tointeger(L, 2)] = LuaToAnimation(L, 3);
     }
     else
     {
@@ -2247,10 +3352,7 @@ s32 ScriptModule::_playActorAnimOnce(lua_State* L)
     Actor* pActor = static_cast<Actor*>(lua_touserdata(L, 1));
     if (pActor)
     {
-        pActor->m_pAnim = (const Animation*)lua_touserdata(L, 2);
-        pActor->m_animFrame = 0;
-        pActor->m_animElapsed = 0.0f;
-        pActor->m_actorState = ACTOR_STATE_ANIMATE_ONCE;
+        pActor->PlayAnimOnce(LuaToAnimation(L, 2));
     }
     else
     {
@@ -2271,10 +3373,10 @@ s32 ScriptModule::_playActorAnimLooped(lua_State* L)
     Actor* pActor = static_cast<Actor*>(lua_touserdata(L, 1));
     if (pActor)
     {
-        pActor->m_pAnim = (const Animation*)lua_touserdata(L, 2);
-        pActor->m_animFrame = 0;
-        pActor->m_animElapsed = 0.0f;
-        pActor->m_actorState = ACTOR_STATE_ANIMATE_LOOPED;
+        pActor->Anim() = LuaToAnimation(L, 2);
+        pActor->AnimFrame() = 0;
+        pActor->AnimElapsed() = 0.0f;
+        pActor->SetActorState(ACTOR_STATE_ANIMATE_LOOPED);
     }
     else
     {
@@ -2295,7 +3397,7 @@ s32 ScriptModule::_stopActorAnim(lua_State* L)
     Actor* pActor = static_cast<Actor*>(lua_touserdata(L, 1));
     if (pActor)
     {
-        pActor->m_actorState = ACTOR_STATE_IDLE;
+        pActor->SetActorState(ACTOR_STATE_IDLE);
     }
     else
     {
@@ -2316,7 +3418,7 @@ s32 ScriptModule::_defineWeapon(lua_State* L)
     }
 
     // Init weapon
-    const Animation* pAnim = (const Animation*)lua_touserdata(L, 1);
+    const Animation* pAnim = LuaToAnimation(L, 1);
 
     FRect hitBox;
     hitBox.x1 = -g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 2));
@@ -2416,7 +3518,7 @@ s32 ScriptModule::_setCarMaxSpeed(lua_State* L)
         LuaNote(PR_WARNING, "setCarMaxSpeed() called with null car");
         return -1;
     }
-    pCar->m_vMaxSpeed = {
+    pCar->MaxSpeed() = {
         g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 2)),
         g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 3))
     };
@@ -2437,7 +3539,7 @@ s32 ScriptModule::_setCarAcceleration(lua_State* L)
         LuaNote(PR_WARNING, "setCarAcceleration() called with null car");
         return -1;
     }
-    pCar->m_vAcceleration = {
+    pCar->Acceleration() = {
         g_graphicsModule.UnitsToPixelsX((f32)lua_tonumber(L, 2)),
         g_graphicsModule.UnitsToPixelsY((f32)lua_tonumber(L, 3))
     };
@@ -2479,7 +3581,13 @@ s32 ScriptModule::_putActorInCar(lua_State* L)
         LuaNote(PR_WARNING, "putActorInCar() called with null car");
         return -1;
     }
-    pCar->PutActor((Actor*)lua_touserdata(L, 1), (s32)lua_tointeger(L, 3));
+    Actor* pActor = (Actor*)lua_touserdata(L, 1);
+    if (!pActor)
+    {
+        LuaNote(PR_WARNING, "putActorInCar() called with null actor");
+        return -1;
+    }
+    g_game.GetWorld().GetCommands().Reparent(nullptr, pActor, pCar, (s32)lua_tointeger(L, 3));
 
     return 0;
 }
@@ -2497,7 +3605,7 @@ s32 ScriptModule::_ejectActorFromCar(lua_State* L)
         LuaNote(PR_WARNING, "ejectActorInCar() called with null car");
         return -1;
     }
-    pCar->EjectActor((s32)lua_tointeger(L, 2));
+    g_game.GetWorld().GetCommands().Reparent(nullptr, nullptr, pCar, (s32)lua_tointeger(L, 2));
 
     return 0;
 }
@@ -2544,6 +3652,62 @@ s32 ScriptModule::_addTrigger(lua_State* L)
     return 1;
 }
 
+s32 ScriptModule::_watchTriggerEntity(lua_State* L)
+{
+    if (!LuaExpect(L, "watchTriggerEntity", 2))
+    {
+        return -1;
+    }
+
+    Trigger* pTrigger = (Trigger*)lua_touserdata(L, 1);
+    Entity* pEntity = (Entity*)LuaToPointer(L, 2);
+    if (!pTrigger || !pEntity)
+    {
+        LuaNote(PR_WARNING, "watchTriggerEntity() called with null trigger or entity");
+        return -1;
+    }
+
+    pTrigger->Attach(pEntity);
+    return 0;
+}
+
+s32 ScriptModule::_setTriggerRepeatable(lua_State* L)
+{
+    if (!LuaExpect(L, "setTriggerRepeatable", 2))
+    {
+        return -1;
+    }
+
+    Trigger* pTrigger = (Trigger*)lua_touserdata(L, 1);
+    if (!pTrigger)
+    {
+        LuaNote(PR_WARNING, "setTriggerRepeatable() called with null trigger");
+        return -1;
+    }
+
+    pTrigger->SetRepeatable(lua_toboolean(L, 2));
+    return 0;
+}
+
+s32 ScriptModule::_setTriggerExitFunction(lua_State* L)
+{
+    if (!LuaExpect(L, "setTriggerExitFunction", 2))
+    {
+        return -1;
+    }
+
+    Trigger* pTrigger = (Trigger*)lua_touserdata(L, 1);
+    const char* functionName = lua_tostring(L, 2);
+    if (!pTrigger || !functionName)
+    {
+        LuaNote(PR_WARNING, "setTriggerExitFunction() called with null trigger or function name");
+        return -1;
+    }
+
+    pTrigger->SetExitFunctionName(functionName);
+    return 0;
+}
+
 s32 ScriptModule::_addDialog(lua_State* L)
 {
     if (!LuaExpect(L, "addDialog", 6))
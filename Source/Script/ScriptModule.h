@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/EngineModule.h"
+#include "Containers/List.h"
 
 static constexpr char MISSION_LOADER_PATH[] = "Scripts/Internal/Loader.lua";
 static constexpr char MAIN_MENU_PATH[] = "Scripts/MainMenu.lua";
@@ -8,10 +9,26 @@ static constexpr char MAIN_MENU_PATH[] = "Scripts/MainMenu.lua";
 class Entity;
 class Actor;
 class Trigger;
+class ScriptScheduler;
+struct Animation;
 struct lua_State;
 
+/** Precompiled internal library, loaded into every mission through package.preload */
+struct LuaChunk
+{
+    const char* name;
+    u8* code;
+    size_t size;
+    size_t capacity;
+};
+
 class ScriptModule final : public EngineModule
 {
+    LuaChunk* m_aLibraries;
+    s32 m_librariesCount;
+
+    TList<ScriptScheduler*> m_lstScheduler;
+
 public:
     ScriptModule() : EngineModule("ScriptModule", CHANNEL_SCRIPT) {}
 
@@ -24,6 +41,9 @@ public:
     void UpdateMission(lua_State* pScript, f32 dtTime);
     void RenderMission(lua_State* pScript);
 
+    /** Routes hot bindings through FFI or regular functions, false if FFI isn't available */
+    b32 SelectApi(lua_State* pScript, b32 bFFI);
+
     void CallFunction(lua_State* pScript, const char* functionName, void* userdata);
     void CallFunction(lua_State* pScript, const char* functionName);
     void CallState(lua_State* pScript, const char* functionName, Actor* pActor);
@@ -31,12 +51,30 @@ public:
 
     void Interpret(lua_State* pScript, const char* text);
 
+    /** Wakes coroutines waiting for entity event, see eScriptEvent */
+    void SignalEvent(Entity* pEntity, s32 event);
+
 private:
     void DefineFunctions(lua_State* L);
     void DefineSymbols(lua_State* L);
 
-    static void LuaNote(s32 priority, const char* fmt, ...);
+    void CompileLibraries();
+    void FreeLibraries();
+    void PreloadLibraries(lua_State* L);
+    static s32 WriteChunk(lua_State* L, const void* p, size_t size, void* userdata);
+
+    /** States allocate through LuaAlloc, so their memory is counted as Script */
+    static lua_State* NewLuaState();
+    static void* LuaAlloc(void* ud, void* ptr, size_t osize, size_t nsize);
+    static s32 LuaPanic(lua_State* L);
+
+    static ScriptScheduler* GetScheduler(lua_State* L);
+    static s32 WaitEvent(lua_State* L, const char* funName, s32 event);
+
     static b32 LuaExpect(lua_State* L, const char* funName, s32 expect);
+    static void* LuaToPointer(lua_State* L, s32 index);
+    /** Accepts both raw pointers and names of clips */
+    static const Animation* LuaToAnimation(lua_State* L, s32 index);
     b32 CheckLua(lua_State* L, s32 res);
 
     /** Log */
@@ -45,6 +83,13 @@ private:
     /** Lua */
     static s32 _dostring(lua_State* L);
 
+    /** Coroutines */
+    static s32 _runScript(lua_State* L);
+    static s32 _waitTime(lua_State* L);
+    static s32 _waitAnimation(lua_State* L);
+    static s32 _waitDialog(lua_State* L);
+    static s32 _waitDeath(lua_State* L);
+
     /** Window */
     static s32 _showCursor(lua_State* L);
 
@@ -59,6 +104,8 @@ private:
     static s32 _drawText(lua_State* L);
     static s32 _fillRect(lua_State* L);
     static s32 _drawRect(lua_State* L);
+    static s32 _setLayerCached(lua_State* L);
+    static s32 _setPartialRedraw(lua_State* L);
 
     // Camera
     static s32 _attachCamera(lua_State* L);
@@ -67,15 +114,44 @@ private:
     static s32 _setCameraBounds(lua_State* L);
     static s32 _getCameraPosition(lua_State* L);
 
+    // Tilemap
+    static s32 _createTilemap(lua_State* L);
+    static s32 _loadTilemap(lua_State* L);
+    static s32 _saveTilemap(lua_State* L);
+    static s32 _unloadTilemap(lua_State* L);
+    static s32 _defineTileset(lua_State* L);
+    static s32 _setTilemapLayer(lua_State* L);
+    static s32 _setTile(lua_State* L);
+    static s32 _getTile(lua_State* L);
+    static s32 _getTileAt(lua_State* L);
+    static s32 _getTilemapSize(lua_State* L);
+
+    // Frame
+    static s32 _getRenderTimes(lua_State* L);
+    static s32 _getRenderStats(lua_State* L);
+    static s32 _showOverdraw(lua_State* L);
+
+    // Memory
+    static s32 _getMemoryStats(lua_State* L);
+    static s32 _setMemoryBudget(lua_State* L);
+    static s32 _writeMemoryReport(lua_State* L);
+
     /** Sound */
     static s32 _defineSound(lua_State* L);
     static s32 _playSound(lua_State* L);
     static s32 _playSoundLooped(lua_State* L);
+    static s32 _playSoundAt(lua_State* L);
+    static s32 _setSoundPriority(lua_State* L);
+    static s32 _getVoiceStats(lua_State* L);
     static s32 _stopAllSounds(lua_State* L);
+    static s32 _releaseSound(lua_State* L);
 
     /** Music */
     static s32 _defineMusic(lua_State* L);
     static s32 _playMusic(lua_State* L);
+    static s32 _fadeInMusic(lua_State* L);
+    static s32 _fadeOutMusic(lua_State* L);
+    static s32 _releaseMusic(lua_State* L);
 
     /** Input */
     static s32 _isKeyDown(lua_State* L);
@@ -88,6 +164,8 @@ private:
 
     /** Animation */
     static s32 _defineAnimation(lua_State* L);
+    static s32 _defineNamedAnimation(lua_State* L);
+    static s32 _findAnimation(lua_State* L);
 
     /** Game */
     static s32 _getTicks(lua_State* L);
@@ -102,6 +180,8 @@ private:
     static s32 _hostSwitchLocation(lua_State* L);
     static s32 _setGroundBounds(lua_State* L);
     static s32 _hasWorldEntity(lua_State* L);
+    static s32 _getWorldUpdateTime(lua_State* L);
+    static s32 _benchKernels(lua_State* L);
 
     // Entity
     static s32 _addEntity(lua_State* L);
@@ -141,11 +221,18 @@ private:
     static s32 _setEntityTexture(lua_State* L);
     static s32 _getEntityTexture(lua_State* L);
 
+    // Entity bulk
+    static s32 _setEntityPositions(lua_State* L);
+    static s32 _getEntityPositions(lua_State* L);
+    static s32 _setEntityVelocities(lua_State* L);
+    static s32 _getEntitiesInRect(lua_State* L);
+
     // Actor
     static s32 _addActor(lua_State* L);
 
     static s32 _setActorTeam(lua_State* L);
     static s32 _getActorTeam(lua_State* L);
+    static s32 _getActorsByTeam(lua_State* L);
 
     static s32 _setActorHealth(lua_State* L);
     static s32 _getActorHealth(lua_State* L);
@@ -198,6 +285,9 @@ private:
 
     // Trigger
     static s32 _addTrigger(lua_State* L);
+    static s32 _watchTriggerEntity(lua_State* L);
+    static s32 _setTriggerRepeatable(lua_State* L);
+    static s32 _setTriggerExitFunction(lua_State* L);
 
     // Dialog
     static s32 _addDialog(lua_State* L);
@@ -208,3 +298,6 @@ private:
 };
 
 inline ScriptModule g_scriptModule;
+
+/** Note of scripts, see LogNote */
+#define LuaNote(PRIORITY, ...) LogNote(CHANNEL_SCRIPT, (PRIORITY), "Lua", __VA_ARGS__)
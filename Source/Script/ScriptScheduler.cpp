@@ -0,0 +1,180 @@
+#include "Script/LuaCompat.h"
+#include "Engine/DebugLogManager.h"
+#include "Script/ScriptScheduler.h"
+
+static constexpr s32 TIMERS_START_CAPACITY = 32;
+
+void ScriptScheduler::StartUp(lua_State* pScript)
+{
+    m_pScript = pScript;
+    m_time = 0.0f;
+
+    m_aTimers = new Timer[TIMERS_START_CAPACITY];
+    m_timersCount = 0;
+    m_timersCapacity = TIMERS_START_CAPACITY;
+
+    for (i32f i = 0; i < WAIT_BUCKETS; ++i)
+    {
+        m_aBuckets[i] = nullptr;
+    }
+}
+
+void ScriptScheduler::ShutDown()
+{
+    // Coroutines die with lua state, so only free our memory
+    delete[] m_aTimers;
+
+    for (i32f i = 0; i < WAIT_BUCKETS; ++i)
+    {
+        while (m_aBuckets[i])
+        {
+            Wait* pNext = m_aBuckets[i]->pNext;
+            delete m_aBuckets[i];
+            m_aBuckets[i] = pNext;
+        }
+    }
+
+    m_lstReady.Clean();
+}
+
+void ScriptScheduler::Update(f32 dtTime)
+{
+    m_time += dtTime;
+
+    // Move expired timers to ready list, so timers
+    // pushed by resumed coroutines wait at least one frame
+    while (m_timersCount > 0 && m_aTimers[0].wakeTime <= m_time)
+    {
+        m_lstReady.PushBack({ PopTimer().ref, true });
+    }
+
+    // Resume everything that is ready
+    while (!m_lstReady.IsEmpty())
+    {
+        Ready ready = m_lstReady.Front();
+        m_lstReady.Pop();
+
+        Resume(ready.ref, ready.bResult);
+    }
+}
+
+void ScriptScheduler::WaitTime(s32 ref, f32 time)
+{
+    PushTimer({ m_time + time, ref });
+}
+
+void ScriptScheduler::WaitEvent(s32 ref, Entity* pEntity, s32 event)
+{
+    i32f bucket = Bucket(pEntity);
+    m_aBuckets[bucket] = new Wait { pEntity, event, ref, m_aBuckets[bucket] };
+}
+
+void ScriptScheduler::Signal(Entity* pEntity, s32 event)
+{
+    Wait** ppWait = &m_aBuckets[Bucket(pEntity)];
+
+    while (*ppWait)
+    {
+        Wait* pWait = *ppWait;
+        if (pWait->pEntity != pEntity || (pWait->event != event && event != SCRIPT_EVENT_REMOVED))
+        {
+            ppWait = &pWait->pNext;
+            continue;
+        }
+
+        // Unlink and resume on next update
+        *ppWait = pWait->pNext;
+        m_lstReady.PushBack({ pWait->ref, pWait->event == event });
+        delete pWait;
+    }
+}
+
+void ScriptScheduler::PushTimer(const Timer& timer)
+{
+    // Grow heap if needed
+    if (m_timersCount >= m_timersCapacity)
+    {
+        Timer* aTimers = new Timer[m_timersCapacity * 2];
+        std::memcpy(aTimers, m_aTimers, sizeof(Timer) * m_timersCount);
+        delete[] m_aTimers;
+
+        m_aTimers = aTimers;
+        m_timersCapacity *= 2;
+    }
+
+    // Sift up
+    s32 i = m_timersCount++;
+    while (i > 0)
+    {
+        s32 parent = (i - 1) / 2;
+        if (m_aTimers[parent].wakeTime <= timer.wakeTime)
+        {
+            break;
+        }
+
+        m_aTimers[i] = m_aTimers[parent];
+        i = parent;
+    }
+    m_aTimers[i] = timer;
+}
+
+ScriptScheduler::Timer ScriptScheduler::PopTimer()
+{
+    Timer top = m_aTimers[0];
+    Timer last = m_aTimers[--m_timersCount];
+
+    // Sift down
+    s32 i = 0;
+    for ( ;; )
+    {
+        s32 child = i * 2 + 1;
+        if (child >= m_timersCount)
+        {
+            break;
+        }
+        if (child + 1 < m_timersCount && m_aTimers[child + 1].wakeTime < m_aTimers[child].wakeTime)
+        {
+            ++child;
+        }
+        if (last.wakeTime <= m_aTimers[child].wakeTime)
+        {
+            break;
+        }
+
+        m_aTimers[i] = m_aTimers[child];
+        i = child;
+    }
+    m_aTimers[i] = last;
+
+    return top;
+}
+
+void ScriptScheduler::Resume(s32 ref, b32 bResult)
+{
+    // Keep coroutine on the stack while it's running
+    lua_rawgeti(m_pScript, LUA_REGISTRYINDEX, ref);
+    luaL_unref(m_pScript, LUA_REGISTRYINDEX, ref);
+
+    lua_State* pThread = lua_tothread(m_pScript, -1);
+    if (!pThread)
+    {
+        lua_pop(m_pScript, 1);
+        return;
+    }
+
+    // Result of wait function
+    lua_pushboolean(pThread, bResult);
+
+    s32 results;
+    s32 res = LuaCompat::Resume(pThread, m_pScript, 1, &results);
+    if (res == LUA_OK || res == LUA_YIELD)
+    {
+        lua_pop(pThread, results);
+    }
+    else
+    {
+        LogNote(CHANNEL_SCRIPT, PR_ERROR, "Lua", "ScriptScheduler: %s", lua_tostring(pThread, -1));
+    }
+
+    lua_pop(m_pScript, 1);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+#include "Containers/List.h"
+
+class Entity;
+struct lua_State;
+
+enum eScriptEvent
+{
+    SCRIPT_EVENT_ANIMATION_END = 1,
+    SCRIPT_EVENT_DIALOG_CLOSE,
+    SCRIPT_EVENT_DEATH,
+
+    /** Entity left the world, wakes every wait on it */
+    SCRIPT_EVENT_REMOVED
+};
+
+/**
+ * Resumes Lua coroutines when their timer expires or awaited entity event happens.
+ * Nothing is polled: timers live in min-heap, event waits in per-entity buckets
+ */
+class ScriptScheduler
+{
+    static constexpr i32f WAIT_BUCKETS = 64;
+
+    struct Timer
+    {
+        f32 wakeTime;
+        s32 ref;
+    };
+
+    struct Wait
+    {
+        Entity* pEntity;
+        s32 event;
+        s32 ref;
+        Wait* pNext;
+    };
+
+    struct Ready
+    {
+        s32 ref;
+        b32 bResult;
+    };
+
+    lua_State* m_pScript;
+    f32 m_time;
+
+    Timer* m_aTimers;
+    s32 m_timersCount;
+    s32 m_timersCapacity;
+
+    Wait* m_aBuckets[WAIT_BUCKETS];
+    TList<Ready> m_lstReady;
+
+public:
+    void StartUp(lua_State* pScript);
+    void ShutDown();
+
+    void Update(f32 dtTime);
+
+    /** Ref is registry reference to coroutine */
+    void WaitTime(s32 ref, f32 time);
+    void WaitEvent(s32 ref, Entity* pEntity, s32 event);
+
+    void Signal(Entity* pEntity, s32 event);
+
+private:
+    void PushTimer(const Timer& timer);
+    Timer PopTimer();
+
+    void Resume(s32 ref, b32 bResult);
+
+    forceinline i32f Bucket(const Entity* pEntity) const { return ((uintptr_t)pEntity >> 4) & (WAIT_BUCKETS - 1); }
+};
@@ -0,0 +1,469 @@
+#include "SDL_mixer.h"
+#include "Engine/DebugLogManager.h"
+#include "Engine/MemoryTracker.h"
+#include "Sound/MusicStream.h"
+
+static constexpr u32 STREAMER_PERIOD = 50;
+
+/** WAVE_FORMAT_* of fmt chunk */
+static constexpr u16 WAV_PCM = 1;
+static constexpr u16 WAV_FLOAT = 3;
+static constexpr u16 WAV_EXTENSIBLE = 0xFFFE;
+
+internal forceinline u16 ReadU16(const u8* p)
+{
+    return (u16)(p[0] | (p[1] << 8));
+}
+
+internal forceinline u32 ReadU32(const u8* p)
+{
+    return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+}
+
+void MusicStream::StartUp()
+{
+    m_current = 0;
+    m_pThread = nullptr;
+    m_pWake = nullptr;
+    SDL_AtomicSet(&m_bQuit, 0);
+
+    // We add floats to 16-bit output of mixer
+    int frequency, channels;
+    Uint16 format;
+    m_bEnabled = Mix_QuerySpec(&frequency, &format, &channels) && format == AUDIO_S16SYS;
+    m_channels = channels;
+    m_frequency = frequency;
+
+    if (!m_bEnabled)
+    {
+        LogNote(CHANNEL_SOUND, PR_WARNING, "MusicStream", "Streaming is disabled, it needs 16-bit mixer output");
+        return;
+    }
+
+    for (i32f i = 0; i < DECK_COUNT; ++i)
+    {
+        Deck& deck = m_aDecks[i];
+        deck.pLock = SDL_CreateMutex();
+        deck.hFile = nullptr;
+        deck.pConverter = nullptr;
+        deck.aReadBuffer = new u8[READ_SIZE];
+        deck.aConverted = new f32[CONVERT_SIZE];
+        deck.aRing = new f32[RING_SIZE];
+        SDL_AtomicSet(&deck.writePos, 0);
+        SDL_AtomicSet(&deck.readPos, 0);
+        SDL_AtomicSet(&deck.bActive, 0);
+        SDL_AtomicSet(&deck.bFinished, 0);
+        deck.mixLock = 0;
+        deck.gain = 0.0f;
+        deck.gainStep = 0.0f;
+        deck.targetGain = 0.0f;
+    }
+
+    m_pWake = SDL_CreateSemaphore(0);
+    m_pThread = m_pWake ? SDL_CreateThread(StreamerMain, "GT2D Music", this) : nullptr;
+    if (!m_pThread)
+    {
+        LogNote(CHANNEL_SOUND, PR_WARNING, "MusicStream", "Can't create streamer thread, only prefetched part is played: %s", SDL_GetError());
+    }
+
+    Mix_SetPostMix(MixDecks, this);
+}
+
+void MusicStream::ShutDown()
+{
+    if (!m_bEnabled)
+    {
+        return;
+    }
+
+    Mix_SetPostMix(nullptr, nullptr);
+
+    if (m_pThread)
+    {
+        SDL_AtomicSet(&m_bQuit, 1);
+        SDL_SemPost(m_pWake);
+        SDL_WaitThread(m_pThread, nullptr);
+        m_pThread = nullptr;
+    }
+    if (m_pWake)
+    {
+        SDL_DestroySemaphore(m_pWake);
+        m_pWake = nullptr;
+    }
+
+    for (i32f i = 0; i < DECK_COUNT; ++i)
+    {
+        Deck& deck = m_aDecks[i];
+        Close(deck);
+        SDL_DestroyMutex(deck.pLock);
+        delete[] deck.aReadBuffer;
+        delete[] deck.aConverted;
+        delete[] deck.aRing;
+    }
+
+    m_bEnabled = false;
+}
+
+b32 MusicStream::Play(const char* path, b32 bLoop, s32 fadeTime)
+{
+    if (!m_bEnabled)
+    {
+        return false;
+    }
+
+    // Take deck which isn't current, whatever it played is dropped
+    s32 next = (m_current + 1) % DECK_COUNT;
+    Deck& deck = m_aDecks[next];
+
+    SDL_AtomicLock(&deck.mixLock);
+    SDL_AtomicSet(&deck.bActive, 0);
+    SDL_AtomicUnlock(&deck.mixLock);
+
+    SDL_LockMutex(deck.pLock);
+    Close(deck);
+    b32 bOpened = Open(deck, path);
+    deck.bLoop = bLoop;
+    SDL_UnlockMutex(deck.pLock);
+
+    if (!bOpened)
+    {
+        return false;
+    }
+
+    // Prefetch, so the first callback already has samples
+    Fill(deck);
+
+    Deck& previous = m_aDecks[m_current];
+    SDL_AtomicLock(&previous.mixLock);
+    Fade(previous, 0.0f, fadeTime);
+    SDL_AtomicUnlock(&previous.mixLock);
+
+    SDL_AtomicLock(&deck.mixLock);
+    deck.gain = fadeTime > 0 ? 0.0f : 1.0f;
+    Fade(deck, 1.0f, fadeTime);
+    SDL_AtomicSet(&deck.bActive, 1);
+    SDL_AtomicUnlock(&deck.mixLock);
+
+    m_current = next;
+    if (m_pWake)
+    {
+        SDL_SemPost(m_pWake);
+    }
+
+    return true;
+}
+
+void MusicStream::Stop(s32 fadeTime)
+{
+    if (!m_bEnabled)
+    {
+        return;
+    }
+
+    for (i32f i = 0; i < DECK_COUNT; ++i)
+    {
+        Deck& deck = m_aDecks[i];
+        SDL_AtomicLock(&deck.mixLock);
+        Fade(deck, 0.0f, fadeTime);
+        if (fadeTime <= 0)
+        {
+            SDL_AtomicSet(&deck.bActive, 0);
+        }
+        SDL_AtomicUnlock(&deck.mixLock);
+    }
+}
+
+b32 MusicStream::IsPlaying()
+{
+    if (!m_bEnabled)
+    {
+        return false;
+    }
+
+    Deck& deck = m_aDecks[m_current];
+    return SDL_AtomicGet(&deck.bActive) && deck.targetGain > 0.0f;
+}
+
+s32 MusicStream::GetBufferedFrames()
+{
+    return m_bEnabled ? GetRingCount(m_aDecks[m_current]) / m_channels : 0;
+}
+
+s32 SDLCALL MusicStream::StreamerMain(void* pData)
+{
+    MusicStream* pStream = (MusicStream*)pData;
+    MemoryScope scope(MEMORY_SOUND);
+
+    while (!SDL_AtomicGet(&pStream->m_bQuit))
+    {
+        for (i32f i = 0; i < DECK_COUNT; ++i)
+        {
+            pStream->Fill(pStream->m_aDecks[i]);
+        }
+
+        // Audio thread wakes us every time it takes samples
+        SDL_SemWaitTimeout(pStream->m_pWake, STREAMER_PERIOD);
+    }
+
+    return 0;
+}
+
+void SDLCALL MusicStream::MixDecks(void* pData, Uint8* pStream, int length)
+{
+    MusicStream* pMusic = (MusicStream*)pData;
+    s16* aSamples = (s16*)pStream;
+    s32 count = length / (s32)sizeof(s16);
+
+    for (i32f i = 0; i < DECK_COUNT; ++i)
+    {
+        Deck& deck = pMusic->m_aDecks[i];
+        SDL_AtomicLock(&deck.mixLock);
+        if (!SDL_AtomicGet(&deck.bActive))
+        {
+            SDL_AtomicUnlock(&deck.mixLock);
+            continue;
+        }
+
+        u32 readPos = (u32)SDL_AtomicGet(&deck.readPos);
+        s32 available = GetRingCount(deck);
+        s32 mixCount = available < count ? available : count;
+
+        for (i32f j = 0; j < mixCount; ++j)
+        {
+            f32 sample = deck.aRing[(readPos + (u32)j) & (RING_SIZE - 1)] * deck.gain;
+
+            // Step gain towards target, fade ends exactly on it
+            if (deck.gain != deck.targetGain)
+            {
+                deck.gain += deck.gainStep;
+                if ((deck.gainStep > 0.0f && deck.gain > deck.targetGain) || (deck.gainStep < 0.0f && deck.gain < deck.targetGain))
+                {
+                    deck.gain = deck.targetGain;
+                }
+            }
+
+            s32 mixed = aSamples[j] + (s32)(sample * 32767.0f);
+            aSamples[j] = (s16)(mixed > INT16_MAX ? INT16_MAX : (mixed < INT16_MIN ? INT16_MIN : mixed));
+        }
+
+        SDL_AtomicAdd(&deck.readPos, mixCount);
+
+        // Faded out or played till the end
+        if ((deck.gain == 0.0f && deck.targetGain == 0.0f) || (mixCount < count && SDL_AtomicGet(&deck.bFinished)))
+        {
+            SDL_AtomicSet(&deck.bActive, 0);
+        }
+        SDL_AtomicUnlock(&deck.mixLock);
+    }
+
+    if (pMusic->m_pWake)
+    {
+        SDL_SemPost(pMusic->m_pWake);
+    }
+}
+
+b32 MusicStream::Fill(Deck& deck)
+{
+    b32 bFilled = false;
+    SDL_LockMutex(deck.pLock);
+
+    while (deck.hFile && !SDL_AtomicGet(&deck.bFinished))
+    {
+        // Fill in decent pieces, not after every callback
+        s32 space = RING_SIZE - GetRingCount(deck);
+        if (space < CONVERT_SIZE / 4)
+        {
+            break;
+        }
+
+        // Feed converter until it has enough for ring
+        if (!deck.bFlushed && SDL_AudioStreamAvailable(deck.pConverter) < space * (s32)sizeof(f32))
+        {
+            if (deck.dataRead >= deck.dataSize && deck.bLoop && deck.dataSize)
+            {
+                std::fseek(deck.hFile, (long)deck.dataStart, SEEK_SET);
+                deck.dataRead = 0;
+            }
+
+            u32 toRead = deck.dataSize - deck.dataRead;
+            toRead = toRead < READ_SIZE ? toRead : READ_SIZE;
+
+            size_t readSize = toRead ? std::fread(deck.aReadBuffer, 1, toRead, deck.hFile) : 0;
+            if (readSize)
+            {
+                deck.dataRead += (u32)readSize;
+                SDL_AudioStreamPut(deck.pConverter, deck.aReadBuffer, (s32)readSize);
+            }
+            else
+            {
+                // End of data or file is cut, converter gives the rest
+                if (toRead)
+                {
+                    deck.bLoop = false;
+                }
+                SDL_AudioStreamFlush(deck.pConverter);
+                deck.bFlushed = true;
+            }
+        }
+
+        s32 getCount = space < CONVERT_SIZE ? space : CONVERT_SIZE;
+        getCount -= getCount % m_channels;
+
+        s32 gotSize = SDL_AudioStreamGet(deck.pConverter, deck.aConverted, getCount * (s32)sizeof(f32));
+        if (gotSize <= 0)
+        {
+            if (deck.bFlushed)
+            {
+                SDL_AtomicSet(&deck.bFinished, 1);
+            }
+            continue;
+        }
+
+        // Copy into ring in two pieces if it wraps
+        s32 gotCount = gotSize / (s32)sizeof(f32);
+        u32 writeIndex = (u32)SDL_AtomicGet(&deck.writePos) & (RING_SIZE - 1);
+        s32 firstCount = RING_SIZE - (s32)writeIndex < gotCount ? RING_SIZE - (s32)writeIndex : gotCount;
+
+        std::memcpy(&deck.aRing[writeIndex], deck.aConverted, firstCount * sizeof(f32));
+        std::memcpy(deck.aRing, deck.aConverted + firstCount, (gotCount - firstCount) * sizeof(f32));
+
+        SDL_AtomicAdd(&deck.writePos, gotCount);
+        bFilled = true;
+    }
+
+    SDL_UnlockMutex(deck.pLock);
+    return bFilled;
+}
+
+b32 MusicStream::Open(Deck& deck, const char* path)
+{
+    deck.hFile = std::fopen(path, "rb");
+    if (!deck.hFile)
+    {
+        LogNote(CHANNEL_SOUND, PR_WARNING, "MusicStream", "Can't open %s", path);
+        return false;
+    }
+
+    // Find fmt and data chunks
+    u8 header[12];
+    if (std::fread(header, 1, sizeof(header), deck.hFile) != sizeof(header) ||
+        std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0)
+    {
+        LogNote(CHANNEL_SOUND, PR_WARNING, "MusicStream", "%s is not WAV", path);
+        Close(deck);
+        return false;
+    }
+
+    u16 format = 0;
+    u16 channels = 0;
+    u32 frequency = 0;
+    u16 blockAlign = 0;
+    u16 bits = 0;
+    b32 bHasData = false;
+
+    u8 chunk[8];
+    while (!bHasData && std::fread(chunk, 1, sizeof(chunk), deck.hFile) == sizeof(chunk))
+    {
+        u32 size = ReadU32(chunk + 4);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+        {
+            u8 fmt[40] = {};
+            u32 fmtSize = size < sizeof(fmt) ? size : (u32)sizeof(fmt);
+            if (std::fread(fmt, 1, fmtSize, deck.hFile) != fmtSize)
+            {
+                break;
+            }
+
+            format = ReadU16(fmt);
+            channels = ReadU16(fmt + 2);
+            frequency = ReadU32(fmt + 4);
+            blockAlign = ReadU16(fmt + 12);
+            bits = ReadU16(fmt + 14);
+
+            // Extensible keeps real format in the beginning of sub format GUID
+            if (format == WAV_EXTENSIBLE && fmtSize >= 26)
+            {
+                format = ReadU16(fmt + 24);
+            }
+
+            std::fseek(deck.hFile, (long)(size - fmtSize + (size & 1)), SEEK_CUR);
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            deck.dataStart = (u32)std::ftell(deck.hFile);
+            deck.dataSize = size;
+            bHasData = true;
+        }
+        else
+        {
+            // Chunks are padded to even size
+            std::fseek(deck.hFile, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    SDL_AudioFormat sourceFormat = 0;
+    if (format == WAV_PCM)
+    {
+        sourceFormat = bits == 8 ? AUDIO_U8 : (bits == 16 ? AUDIO_S16LSB : (bits == 32 ? AUDIO_S32LSB : 0));
+    }
+    else if (format == WAV_FLOAT && bits == 32)
+    {
+        sourceFormat = AUDIO_F32LSB;
+    }
+
+    if (!bHasData || !sourceFormat || !channels || !frequency || !blockAlign)
+    {
+        LogNote(CHANNEL_SOUND, PR_WARNING, "MusicStream", "%s is not 8, 16, 32-bit PCM or float WAV", path);
+        Close(deck);
+        return false;
+    }
+
+    deck.pConverter = SDL_NewAudioStream(sourceFormat, (Uint8)channels, (s32)frequency, AUDIO_F32SYS, (Uint8)m_channels, m_frequency);
+    if (!deck.pConverter)
+    {
+        LogNote(CHANNEL_SOUND, PR_WARNING, "MusicStream", "Can't convert %s: %s", path, SDL_GetError());
+        Close(deck);
+        return false;
+    }
+
+    // Drop partial frame at the end
+    deck.dataSize -= deck.dataSize % blockAlign;
+    deck.dataRead = 0;
+    deck.bFlushed = false;
+
+    SDL_AtomicSet(&deck.writePos, 0);
+    SDL_AtomicSet(&deck.readPos, 0);
+    SDL_AtomicSet(&deck.bFinished, 0);
+
+    return true;
+}
+
+void MusicStream::Close(Deck& deck)
+{
+    if (deck.pConverter)
+    {
+        SDL_FreeAudioStream(deck.pConverter);
+        deck.pConverter = nullptr;
+    }
+    if (deck.hFile)
+    {
+        std::fclose(deck.hFile);
+        deck.hFile = nullptr;
+    }
+}
+
+void MusicStream::Fade(Deck& deck, f32 targetGain, s32 fadeTime)
+{
+    deck.targetGain = targetGain;
+
+    s32 sampleCount = (s32)((s64)fadeTime * m_frequency * m_channels / 1000);
+    if (sampleCount <= 0)
+    {
+        deck.gain = targetGain;
+        deck.gainStep = 0.0f;
+        return;
+    }
+
+    deck.gainStep = (targetGain - deck.gain) / (f32)sampleCount;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "SDL.h"
+#include "Engine/StdHeaders.h"
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+/**
+ * Plays WAV tracks straight from disk. Streamer thread reads file in small
+ * chunks, converts them into float samples of device and keeps them in
+ * bounded ring of deck. Audio thread adds decks to mixer output after
+ * everything else is mixed. There're two decks, so new track fades in
+ * while previous fades out. Memory doesn't depend on track length
+ */
+class MusicStream
+{
+    static constexpr i32f DECK_COUNT = 2;
+
+    /** Floats, about 1.5 seconds of stereo 44100 */
+    static constexpr i32f RING_SIZE = 128 * 1024;
+    static constexpr i32f READ_SIZE = 16 * 1024;
+    static constexpr i32f CONVERT_SIZE = 16 * 1024;
+
+    struct Deck
+    {
+        /** Guards file and converter against streamer thread */
+        SDL_mutex* pLock;
+
+        std::FILE* hFile;
+        SDL_AudioStream* pConverter;
+        u32 dataStart;
+        u32 dataSize;
+        u32 dataRead;
+        b32 bLoop;
+        b32 bFlushed;
+
+        u8* aReadBuffer;
+        f32* aConverted;
+
+        /** Producer fills it under deck lock, consumer is audio thread */
+        f32* aRing;
+        SDL_atomic_t writePos;
+        SDL_atomic_t readPos;
+        SDL_atomic_t bActive;
+        SDL_atomic_t bFinished;
+
+        /** Audio thread holds it while deck is mixed, main thread changes gain and activity under it */
+        SDL_SpinLock mixLock;
+        f32 gain;
+        f32 gainStep;
+        f32 targetGain;
+    };
+
+    Deck m_aDecks[DECK_COUNT];
+    s32 m_current;
+
+    s32 m_channels;
+    s32 m_frequency;
+    b32 m_bEnabled;
+
+    SDL_Thread* m_pThread;
+    SDL_sem* m_pWake;
+    SDL_atomic_t m_bQuit;
+
+public:
+    void StartUp();
+    void ShutDown();
+
+    /** False if file isn't PCM or float WAV */
+    b32 Play(const char* path, b32 bLoop, s32 fadeTime);
+    void Stop(s32 fadeTime);
+
+    forceinline b32 IsEnabled() const { return m_bEnabled; }
+
+    /** True if track of current deck is still heard */
+    b32 IsPlaying();
+
+    /** Frames buffered ahead of audio thread in current deck */
+    s32 GetBufferedFrames();
+
+private:
+    static s32 SDLCALL StreamerMain(void* pData);
+    static void SDLCALL MixDecks(void* pData, Uint8* pStream, int length);
+
+    /** Tops ring up under deck lock, false if nothing was filled */
+    b32 Fill(Deck& deck);
+
+    b32 Open(Deck& deck, const char* path);
+    void Close(Deck& deck);
+
+    /** Call under mix lock of deck */
+    void Fade(Deck& deck, f32 targetGain, s32 fadeTime);
+
+    forceinline static s32 GetRingCount(Deck& deck)
+    {
+        return (s32)((u32)SDL_AtomicGet(&deck.writePos) - (u32)SDL_AtomicGet(&deck.readPos));
+    }
+};
@@ -0,0 +1,386 @@
+#include "Sound/SoftwareMixer.h"
+
+/** Frames mixed at once, longer callbacks are mixed in pieces */
+static constexpr i32f ACCUMULATOR_FRAMES = 4096;
+
+b32 SoftwareMixer::StartUp(s32 frequency, s32 bufferFrames)
+{
+    m_frequency = frequency;
+    m_bufferFrames = bufferFrames;
+
+    SDL_AtomicSet(&m_commandWrite, 0);
+    SDL_AtomicSet(&m_commandRead, 0);
+
+    for (i32f i = 0; i < MAX_VOICES; ++i)
+    {
+        m_aPlayIds[i] = 0;
+        SDL_AtomicSet(&m_aFinishedIds[i], 0);
+        m_aVoices[i].activeIndex = -1;
+    }
+
+    m_activeCount = 0;
+    m_aAccumulator = new f32[ACCUMULATOR_FRAMES * 2];
+    m_bScalar = false;
+
+    SDL_AtomicSet(&m_activeVoices, 0);
+    SDL_AtomicSet(&m_callbacks, 0);
+    SDL_AtomicSet(&m_droppedCommands, 0);
+    m_statsLock = 0;
+    m_mixTicks = 0;
+    m_maxMixTicks = 0;
+    m_mixCount = 0;
+
+    // Device converts from our format by itself if it has to
+    SDL_AudioSpec want;
+    std::memset(&want, 0, sizeof(want));
+    want.freq = frequency;
+    want.format = AUDIO_S16SYS;
+    want.channels = 2;
+    want.samples = (Uint16)bufferFrames;
+    want.callback = AudioCallback;
+    want.userdata = this;
+
+    SDL_AudioSpec have;
+    m_device = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
+    if (!m_device)
+    {
+        delete[] m_aAccumulator;
+        m_aAccumulator = nullptr;
+        return false;
+    }
+
+    SDL_PauseAudioDevice(m_device, 0);
+    return true;
+}
+
+void SoftwareMixer::ShutDown()
+{
+    // Waits for callback to finish
+    if (m_device)
+    {
+        SDL_CloseAudioDevice(m_device);
+        m_device = 0;
+    }
+
+    if (m_aAccumulator)
+    {
+        delete[] m_aAccumulator;
+        m_aAccumulator = nullptr;
+    }
+}
+
+void SoftwareMixer::Play(s32 voice, const s16* aSamples, s32 frameCount, f32 gainLeft, f32 gainRight, b32 bLoop)
+{
+    // Voice which never got its command would look busy forever, so drop it before id changes
+    if (SDL_AtomicGet(&m_commandWrite) - SDL_AtomicGet(&m_commandRead) >= COMMAND_COUNT)
+    {
+        SDL_AtomicAdd(&m_droppedCommands, 1);
+        return;
+    }
+
+    ++m_aPlayIds[voice];
+    PushCommand({ COMMAND_PLAY, voice, m_aPlayIds[voice], aSamples, frameCount, gainLeft, gainRight, bLoop });
+}
+
+void SoftwareMixer::SetGain(s32 voice, f32 gainLeft, f32 gainRight)
+{
+    PushCommand({ COMMAND_SET_GAIN, voice, m_aPlayIds[voice], nullptr, 0, gainLeft, gainRight, false });
+}
+
+void SoftwareMixer::Stop(s32 voice)
+{
+    PushCommand({ COMMAND_STOP, voice, m_aPlayIds[voice], nullptr, 0, 0.0f, 0.0f, false });
+}
+
+void SoftwareMixer::StopAll()
+{
+    PushCommand({ COMMAND_STOP_ALL, 0, 0, nullptr, 0, 0.0f, 0.0f, false });
+}
+
+void SoftwareMixer::Sync()
+{
+    // Callback doesn't run under device lock, so we're the only consumer
+    SDL_LockAudioDevice(m_device);
+    ApplyCommands();
+    SDL_UnlockAudioDevice(m_device);
+}
+
+void SoftwareMixer::GetStats(MixerStats& stats)
+{
+    stats.activeVoices = SDL_AtomicGet(&m_activeVoices);
+    stats.callbacks = SDL_AtomicGet(&m_callbacks);
+    stats.droppedCommands = SDL_AtomicGet(&m_droppedCommands);
+
+    SDL_AtomicLock(&m_statsLock);
+    f64 frequency = (f64)SDL_GetPerformanceFrequency();
+    stats.averageMixTime = m_mixCount ? (f64)m_mixTicks / m_mixCount / frequency * 1000.0 : 0.0;
+    stats.maxMixTime = (f64)m_maxMixTicks / frequency * 1000.0;
+    m_mixTicks = 0;
+    m_maxMixTicks = 0;
+    m_mixCount = 0;
+    SDL_AtomicUnlock(&m_statsLock);
+
+    stats.bufferTime = (f64)m_bufferFrames / m_frequency * 1000.0;
+}
+
+void SoftwareMixer::Mix(s16* aOutput, s32 frameCount)
+{
+    u64 start = SDL_GetPerformanceCounter();
+    ApplyCommands();
+
+    while (frameCount > 0)
+    {
+        s32 pieceFrames = frameCount < ACCUMULATOR_FRAMES ? frameCount : ACCUMULATOR_FRAMES;
+        std::memset(m_aAccumulator, 0, pieceFrames * 2 * sizeof(f32));
+
+        // Backwards, so finished voices can be swapped out
+        for (i32f i = m_activeCount - 1; i >= 0; --i)
+        {
+            s32 index = m_aActive[i];
+            Voice& voice = m_aVoices[index];
+
+            s32 mixed = 0;
+            while (mixed < pieceFrames)
+            {
+                s32 left = voice.frameCount - voice.position;
+                s32 count = left < pieceFrames - mixed ? left : pieceFrames - mixed;
+
+                const s16* aSamples = voice.aSamples + voice.position * 2;
+                if (m_bScalar)
+                {
+                    MixVoiceScalar(m_aAccumulator + mixed * 2, aSamples, count, voice.gainLeft, voice.gainRight);
+                }
+                else
+                {
+                    MixVoice(m_aAccumulator + mixed * 2, aSamples, count, voice.gainLeft, voice.gainRight);
+                }
+
+                mixed += count;
+                voice.position += count;
+
+                if (voice.position >= voice.frameCount)
+                {
+                    if (!voice.bLoop)
+                    {
+                        FinishVoice(index);
+                        break;
+                    }
+                    voice.position = 0;
+                }
+            }
+        }
+
+        if (m_bScalar)
+        {
+            ResolveScalar(aOutput, m_aAccumulator, pieceFrames * 2);
+        }
+        else
+        {
+            Resolve(aOutput, m_aAccumulator, pieceFrames * 2);
+        }
+
+        aOutput += pieceFrames * 2;
+        frameCount -= pieceFrames;
+    }
+
+    SDL_AtomicSet(&m_activeVoices, m_activeCount);
+    SDL_AtomicAdd(&m_callbacks, 1);
+
+    u64 ticks = SDL_GetPerformanceCounter() - start;
+    SDL_AtomicLock(&m_statsLock);
+    m_mixTicks += ticks;
+    m_maxMixTicks = ticks > m_maxMixTicks ? ticks : m_maxMixTicks;
+    ++m_mixCount;
+    SDL_AtomicUnlock(&m_statsLock);
+}
+
+void SoftwareMixer::ComputeGains(f32 volume, f32 pan, f32& gainLeft, f32& gainRight)
+{
+    pan = pan < -1.0f ? -1.0f : (pan > 1.0f ? 1.0f : pan);
+    gainLeft = volume * (pan > 0.0f ? 1.0f - pan : 1.0f);
+    gainRight = volume * (pan < 0.0f ? 1.0f + pan : 1.0f);
+}
+
+void SDLCALL SoftwareMixer::AudioCallback(void* pData, Uint8* pStream, int length)
+{
+    ((SoftwareMixer*)pData)->Mix((s16*)pStream, length / (s32)(2 * sizeof(s16)));
+}
+
+void SoftwareMixer::PushCommand(const Command& command)
+{
+    s32 write = SDL_AtomicGet(&m_commandWrite);
+    if (write - SDL_AtomicGet(&m_commandRead) >= COMMAND_COUNT)
+    {
+        SDL_AtomicAdd(&m_droppedCommands, 1);
+        return;
+    }
+
+    m_aCommands[(u32)write % COMMAND_COUNT] = command;
+    SDL_AtomicSet(&m_commandWrite, write + 1);
+}
+
+void SoftwareMixer::ApplyCommands()
+{
+    s32 read = SDL_AtomicGet(&m_commandRead);
+    s32 write = SDL_AtomicGet(&m_commandWrite);
+
+    for ( ; read != write; ++read)
+    {
+        const Command& command = m_aCommands[(u32)read % COMMAND_COUNT];
+        Voice& voice = m_aVoices[command.voice];
+
+        switch (command.type)
+        {
+        case COMMAND_PLAY:
+        {
+            // Sound which played here is finished, new one takes its place
+            if (voice.activeIndex >= 0)
+            {
+                SDL_AtomicSet(&m_aFinishedIds[command.voice], voice.playId);
+            }
+            else
+            {
+                voice.activeIndex = m_activeCount;
+                m_aActive[m_activeCount++] = command.voice;
+            }
+
+            voice.aSamples = command.aSamples;
+            voice.frameCount = command.frameCount;
+            voice.position = 0;
+            voice.gainLeft = command.gainLeft;
+            voice.gainRight = command.gainRight;
+            voice.bLoop = command.bLoop;
+            voice.playId = command.playId;
+
+            if (voice.frameCount <= 0)
+            {
+                FinishVoice(command.voice);
+            }
+        } break;
+
+        case COMMAND_SET_GAIN:
+        {
+            if (voice.activeIndex >= 0 && voice.playId == command.playId)
+            {
+                voice.gainLeft = command.gainLeft;
+                voice.gainRight = command.gainRight;
+            }
+        } break;
+
+        case COMMAND_STOP:
+        {
+            if (voice.activeIndex >= 0 && voice.playId == command.playId)
+            {
+                FinishVoice(command.voice);
+            }
+        } break;
+
+        case COMMAND_STOP_ALL:
+        {
+            while (m_activeCount > 0)
+            {
+                FinishVoice(m_aActive[m_activeCount - 1]);
+            }
+        } break;
+        }
+    }
+
+    SDL_AtomicSet(&m_commandRead, read);
+}
+
+void SoftwareMixer::FinishVoice(s32 index)
+{
+    Voice& voice = m_aVoices[index];
+
+    // Swap with the last active one
+    s32 last = m_aActive[--m_activeCount];
+    m_aActive[voice.activeIndex] = last;
+    m_aVoices[last].activeIndex = voice.activeIndex;
+    voice.activeIndex = -1;
+
+    SDL_AtomicSet(&m_aFinishedIds[index], voice.playId);
+}
+
+void SoftwareMixer::MixVoiceScalar(f32* aAccumulator, const s16* aSamples, s32 frameCount, f32 gainLeft, f32 gainRight)
+{
+    for (i32f i = 0; i < frameCount; ++i)
+    {
+        aAccumulator[i * 2] += aSamples[i * 2] * gainLeft;
+        aAccumulator[i * 2 + 1] += aSamples[i * 2 + 1] * gainRight;
+    }
+}
+
+void SoftwareMixer::ResolveScalar(s16* aOutput, const f32* aAccumulator, s32 sampleCount)
+{
+    for (i32f i = 0; i < sampleCount; ++i)
+    {
+        f32 sample = aAccumulator[i];
+        sample = sample > 32767.0f ? 32767.0f : (sample < -32768.0f ? -32768.0f : sample);
+        aOutput[i] = (s16)(sample >= 0.0f ? sample + 0.5f : sample - 0.5f);
+    }
+}
+
+void SoftwareMixer::MixVoice(f32* aAccumulator, const s16* aSamples, s32 frameCount, f32 gainLeft, f32 gainRight)
+{
+    i32f i = 0;
+
+#if defined(SIMD_AVX2)
+    // 8 frames, samples are widened to 32-bit and converted
+    __m256 vGain = _mm256_setr_ps(gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight);
+    for ( ; i + 8 <= frameCount; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(aSamples + i * 2));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(aSamples + i * 2 + 8));
+        __m256 vLo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(lo));
+        __m256 vHi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(hi));
+
+        f32* p = aAccumulator + i * 2;
+        _mm256_storeu_ps(p, _mm256_add_ps(_mm256_loadu_ps(p), _mm256_mul_ps(vLo, vGain)));
+        _mm256_storeu_ps(p + 8, _mm256_add_ps(_mm256_loadu_ps(p + 8), _mm256_mul_ps(vHi, vGain)));
+    }
+#elif defined(SIMD_SSE2)
+    // 4 frames, samples are sign-extended by unpacking into high halves
+    __m128 vGain = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+    for ( ; i + 4 <= frameCount; i += 4)
+    {
+        __m128i samples = _mm_loadu_si128((const __m128i*)(aSamples + i * 2));
+        __m128 vLo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+        __m128 vHi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+
+        f32* p = aAccumulator + i * 2;
+        _mm_storeu_ps(p, _mm_add_ps(_mm_loadu_ps(p), _mm_mul_ps(vLo, vGain)));
+        _mm_storeu_ps(p + 4, _mm_add_ps(_mm_loadu_ps(p + 4), _mm_mul_ps(vHi, vGain)));
+    }
+#endif
+
+    MixVoiceScalar(aAccumulator + i * 2, aSamples + i * 2, frameCount - (s32)i, gainLeft, gainRight);
+}
+
+void SoftwareMixer::Resolve(s16* aOutput, const f32* aAccumulator, s32 sampleCount)
+{
+    i32f i = 0;
+
+#if defined(SIMD_AVX2)
+    // Pack works inside 128-bit lanes, so quads are put back in order
+    __m256 vMax = _mm256_set1_ps(32767.0f);
+    __m256 vMin = _mm256_set1_ps(-32768.0f);
+    for ( ; i + 16 <= sampleCount; i += 16)
+    {
+        __m256i lo = _mm256_cvtps_epi32(_mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(aAccumulator + i), vMax), vMin));
+        __m256i hi = _mm256_cvtps_epi32(_mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(aAccumulator + i + 8), vMax), vMin));
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)(aOutput + i), packed);
+    }
+#elif defined(SIMD_SSE2)
+    __m128 vMax = _mm_set1_ps(32767.0f);
+    __m128 vMin = _mm_set1_ps(-32768.0f);
+    for ( ; i + 8 <= sampleCount; i += 8)
+    {
+        __m128i lo = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(aAccumulator + i), vMax), vMin));
+        __m128i hi = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(aAccumulator + i + 4), vMax), vMin));
+        _mm_storeu_si128((__m128i*)(aOutput + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+
+    ResolveScalar(aOutput + i, aAccumulator + i, sampleCount - (s32)i);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "SDL.h"
+#include "Engine/StdHeaders.h"
+#include "Engine/Types.h"
+#include "Engine/Platform.h"
+
+struct MixerStats
+{
+    s32 activeVoices;
+    s32 callbacks;
+    s32 droppedCommands;
+
+    /** Milliseconds, average and worst since last GetStats() */
+    f64 averageMixTime;
+    f64 maxMixTime;
+
+    /** Milliseconds of audio one callback produces */
+    f64 bufferTime;
+};
+
+/**
+ * Mixes interleaved 16-bit stereo voices in callback of its own audio device.
+ * Voices are slots picked by caller, game thread sends commands through
+ * lock-free queue and audio thread applies them before every mix. Gain
+ * and pan are applied 8 (AVX2) or 4 (SSE2) samples at once into float
+ * accumulator, which is saturated into output in the end.
+ * Samples must stay alive while voice plays them
+ */
+class SoftwareMixer
+{
+public:
+    static constexpr i32f MAX_VOICES = 512;
+
+private:
+    static constexpr i32f COMMAND_COUNT = 1024;
+
+    enum eCommand
+    {
+        COMMAND_PLAY = 0,
+        COMMAND_SET_GAIN,
+        COMMAND_STOP,
+        COMMAND_STOP_ALL
+    };
+
+    struct Command
+    {
+        s32 type;
+        s32 voice;
+        u32 playId;
+        const s16* aSamples;
+        s32 frameCount;
+        f32 gainLeft;
+        f32 gainRight;
+        b32 bLoop;
+    };
+
+    /** Audio thread only */
+    struct Voice
+    {
+        const s16* aSamples;
+        s32 frameCount;
+        s32 position;
+        f32 gainLeft;
+        f32 gainRight;
+        b32 bLoop;
+        u32 playId;
+        s32 activeIndex;
+    };
+
+    SDL_AudioDeviceID m_device;
+    s32 m_frequency;
+    s32 m_bufferFrames;
+
+    /** Single producer is game thread, single consumer is audio thread */
+    Command m_aCommands[COMMAND_COUNT];
+    SDL_atomic_t m_commandWrite;
+    SDL_atomic_t m_commandRead;
+
+    /** Voice plays while its finished id differs from play id */
+    u32 m_aPlayIds[MAX_VOICES];
+    SDL_atomic_t m_aFinishedIds[MAX_VOICES];
+
+    Voice m_aVoices[MAX_VOICES];
+    s32 m_aActive[MAX_VOICES];
+    s32 m_activeCount;
+    f32* m_aAccumulator;
+    b32 m_bScalar;
+
+    /** Written by audio thread */
+    SDL_atomic_t m_activeVoices;
+    SDL_atomic_t m_callbacks;
+    SDL_atomic_t m_droppedCommands;
+    SDL_SpinLock m_statsLock;
+    u64 m_mixTicks;
+    u64 m_maxMixTicks;
+    s32 m_mixCount;
+
+public:
+    /** Opens default device as 16-bit stereo, false if it can't be opened */
+    b32 StartUp(s32 frequency, s32 bufferFrames);
+    void ShutDown();
+
+    void Play(s32 voice, const s16* aSamples, s32 frameCount, f32 gainLeft, f32 gainRight, b32 bLoop);
+    void SetGain(s32 voice, f32 gainLeft, f32 gainRight);
+    void Stop(s32 voice);
+    void StopAll();
+
+    /** Applies pending commands right away, samples of stopped voices may be freed after it */
+    void Sync();
+
+    forceinline b32 IsPlaying(s32 voice) { return (u32)SDL_AtomicGet(&m_aFinishedIds[voice]) != m_aPlayIds[voice]; }
+
+    void GetStats(MixerStats& stats);
+
+    /** Callback isn't running when it returns, so Mix() may be called directly */
+    forceinline void Pause(b32 bPause) { SDL_PauseAudioDevice(m_device, bPause ? 1 : 0); }
+
+    /** Scalar kernels instead of SIMD ones, for comparison */
+    forceinline void SetScalar(b32 bScalar) { m_bScalar = bScalar; }
+
+    /** Applies commands and fills output, audio callback calls it */
+    void Mix(s16* aOutput, s32 frameCount);
+
+    /** Accumulator += samples * gain for stereo frames */
+    static void MixVoice(f32* aAccumulator, const s16* aSamples, s32 frameCount, f32 gainLeft, f32 gainRight);
+    static void MixVoiceScalar(f32* aAccumulator, const s16* aSamples, s32 frameCount, f32 gainLeft, f32 gainRight);
+
+    /** Saturates accumulator into 16-bit output */
+    static void Resolve(s16* aOutput, const f32* aAccumulator, s32 sampleCount);
+    static void ResolveScalar(s16* aOutput, const f32* aAccumulator, s32 sampleCount);
+
+    /** Gains of volume in [0, 1] and pan in [-1, 1], equal at center */
+    static void ComputeGains(f32 volume, f32 pan, f32& gainLeft, f32& gainRight);
+
+private:
+    static void SDLCALL AudioCallback(void* pData, Uint8* pStream, int length);
+
+    void PushCommand(const Command& command);
+    void ApplyCommands();
+    void FinishVoice(s32 voice);
+};
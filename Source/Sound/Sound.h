@@ -1,8 +1,28 @@
 #pragma once
 
+#include "Engine/Types.h"
+
 struct Mix_Chunk;
 
+/** When voices are out, sound steals voice of lower priority */
+enum eSoundPriority
+{
+    SOUND_PRIORITY_LOW = 0,
+    SOUND_PRIORITY_NORMAL,
+    SOUND_PRIORITY_HIGH,
+    SOUND_PRIORITY_CRITICAL
+};
+
 struct Sound
 {
     Mix_Chunk* pSound;
+
+    /** Normalized path, key of sound in registry */
+    char* path;
+    s32 refCount;
+
+    s32 priority;
+
+    /** Oldest instance is restarted when sound is played over it */
+    s32 maxInstances;
 };
@@ -1,23 +1,73 @@
+#include <cctype>
 #include "Engine/StdHeaders.h"
+#include "Engine/MemoryTracker.h"
+#include "Graphics/GraphicsModule.h"
 #include "Sound/Sound.h"
 #include "Sound/SoundModule.h"
 
-static constexpr i32f MAX_SOUNDS = 256;
-static constexpr i32f MAX_MUSICS = 256;
+static constexpr s32 DEFAULT_MAX_INSTANCES = 4;
+
+/** Of screen width */
+static constexpr f32 FULL_VOLUME_DISTANCE = 0.5f;
+static constexpr f32 CULL_DISTANCE = 1.5f;
+
+#ifdef GT2D_SOFTWARE_MIXER
+/** About 12 ms at 44100 */
+static constexpr s32 MIXER_BUFFER_FRAMES = 512;
+#endif
 
 struct Music
 {
+    /** Opened by mixer only while it plays track, MusicStream opens file itself */
     Mix_Music* pMusic;
+    char* fileName;
+    b32 bStreamed;
+
+    char* path;
+    s32 refCount;
 };
 
+internal b32 IsStreamedMusic(const char* path)
+{
+    size_t length = std::strlen(path);
+    return length >= 4 && std::strcmp(path + length - 4, ".wav") == 0;
+}
+
 void SoundModule::StartUp()
 {
-    // Init sounds
-    m_aSounds = new Sound[MAX_SOUNDS];
-    std::memset(m_aSounds, 0, MAX_SOUNDS * sizeof(Sound));
+#ifdef GT2D_SOFTWARE_MIXER
+    // Chunks are converted to mixer output, so it has to be 16-bit stereo
+    int frequency, channels;
+    Uint16 format;
+    m_bSoftwareMixer = Mix_QuerySpec(&frequency, &format, &channels) && format == AUDIO_S16SYS && channels == 2 &&
+                       m_mixer.StartUp(frequency, MIXER_BUFFER_FRAMES);
+
+    if (m_bSoftwareMixer)
+    {
+        AddNote(PR_NOTE, "Sounds are mixed by software mixer with %d voices", (s32)VOICE_COUNT);
+    }
+    else
+    {
+        AddNote(PR_WARNING, "Software mixer can't be started, sounds are mixed by SDL_mixer: %s", SDL_GetError());
+        Mix_AllocateChannels(VOICE_COUNT);
+    }
+#else
+    // Every channel is our voice
+    Mix_AllocateChannels(VOICE_COUNT);
+#endif
+
+    std::memset(m_aVoices, 0, sizeof(m_aVoices));
+    std::memset(&m_voiceStats, 0, sizeof(m_voiceStats));
+    m_voiceStats.voiceCount = VOICE_COUNT;
+
+    UpdateListener();
 
-    m_aMusics = new Music[MAX_MUSICS];
-    std::memset(m_aMusics, 0, MAX_MUSICS * sizeof(Music));
+    m_musicStream.StartUp();
+    m_pCurrentMusic = nullptr;
+    m_pMixerMusic = nullptr;
+    m_musicFadeEnd = 0;
+    m_bMusicPending = false;
+    m_pendingFadeTime = 0;
 
     AddNote(PR_NOTE, "Module started");
 }
@@ -25,114 +75,765 @@ void SoundModule::StartUp()
 void SoundModule::ShutDown()
 {
     StopSoundsAndMusic();
+
+#ifdef GT2D_SOFTWARE_MIXER
+    if (m_bSoftwareMixer)
+    {
+        m_mixer.ShutDown();
+        m_bSoftwareMixer = false;
+    }
+#endif
+
     UndefineResources();
-    delete[] m_aMusics;
-    delete[] m_aSounds;
+    m_musicStream.ShutDown();
 
     AddNote(PR_NOTE, "Module shut down");
 }
 
 Sound* SoundModule::DefineWAV(const char* fileName)
 {
-    for (i32f i = 0; i < MAX_SOUNDS; ++i)
+    MemoryScope scope(MEMORY_SOUND);
+
+    char path[MAX_PATH_LENGTH];
+    if (!NormalizePath(fileName, path))
+    {
+        AddNote(PR_WARNING, "Can't define sound, path is too long: %s", fileName);
+        return nullptr;
+    }
+
+    // Share chunk if it's already loaded
+    Sound** ppSound = m_tabSounds.Find(path);
+    if (ppSound)
     {
-        if (!m_aSounds[i].pSound)
+        // Sound kept from previous mission starts with defaults again
+        if ((*ppSound)->refCount == 0)
         {
-            m_aSounds[i].pSound = Mix_LoadWAV(fileName);
+            (*ppSound)->priority = SOUND_PRIORITY_NORMAL;
+            (*ppSound)->maxInstances = DEFAULT_MAX_INSTANCES;
+        }
 
-            if (!m_aSounds[i].pSound)
-            {
-                AddNote(PR_WARNING, "Can't define sound %s: %s", fileName, Mix_GetError());
-                return nullptr;
-            }
+        ++(*ppSound)->refCount;
+        return *ppSound;
+    }
 
-            return &m_aSounds[i];
-        }
+    Mix_Chunk* pChunk = Mix_LoadWAV(fileName);
+    if (!pChunk)
+    {
+        AddNote(PR_WARNING, "Can't define sound %s: %s", fileName, Mix_GetError());
+        return nullptr;
     }
 
-    return nullptr;
+    Sound* pSound = new Sound;
+    pSound->pSound = pChunk;
+    pSound->path = CopyPath(path);
+    pSound->refCount = 1;
+    pSound->priority = SOUND_PRIORITY_NORMAL;
+    pSound->maxInstances = DEFAULT_MAX_INSTANCES;
+
+    m_tabSounds.Insert(pSound->path, pSound);
+    return pSound;
 }
 
 Music* SoundModule::DefineMusic(const char* fileName)
 {
-    for (i32f i = 0; i < MAX_MUSICS; ++i)
+    MemoryScope scope(MEMORY_SOUND);
+
+    char path[MAX_PATH_LENGTH];
+    if (!NormalizePath(fileName, path))
     {
-        if (!m_aMusics[i].pMusic)
-        {
-            m_aMusics[i].pMusic = Mix_LoadMUS(fileName);
+        AddNote(PR_WARNING, "Can't define music, path is too long: %s", fileName);
+        return nullptr;
+    }
 
-            if (!m_aMusics[i].pMusic)
-            {
-                AddNote(PR_WARNING, "Can't define music %s: %s", fileName, Mix_GetError());
-                return nullptr;
-            }
+    Music** ppMusic = m_tabMusics.Find(path);
+    if (ppMusic)
+    {
+        ++(*ppMusic)->refCount;
+        return *ppMusic;
+    }
 
-            return &m_aMusics[i];
-        }
+    // Music is opened only when it's played, just check that it's there
+    SDL_RWops* pFile = SDL_RWFromFile(fileName, "rb");
+    if (!pFile)
+    {
+        AddNote(PR_WARNING, "Can't define music %s: %s", fileName, SDL_GetError());
+        return nullptr;
     }
+    SDL_RWclose(pFile);
+
+    Music* pMusic = new Music;
+    pMusic->pMusic = nullptr;
+    pMusic->fileName = CopyPath(fileName);
+    pMusic->bStreamed = IsStreamedMusic(path) && m_musicStream.IsEnabled();
+    pMusic->path = CopyPath(path);
+    pMusic->refCount = 1;
 
-    return nullptr;
+    m_tabMusics.Insert(pMusic->path, pMusic);
+    return pMusic;
+}
+
+void SoundModule::ReleaseSound(Sound* pSound)
+{
+    if (!pSound)
+    {
+        AddNote(PR_WARNING, "ReleaseSound() called with null sound");
+        return;
+    }
+
+    if (--pSound->refCount > 0)
+    {
+        return;
+    }
+
+    ForgetVoices(pSound);
+    m_tabSounds.Remove(pSound->path);
+    FreeSound(pSound);
+}
+
+void SoundModule::ReleaseMusic(Music* pMusic)
+{
+    if (!pMusic)
+    {
+        AddNote(PR_WARNING, "ReleaseMusic() called with null music");
+        return;
+    }
+
+    if (--pMusic->refCount > 0)
+    {
+        return;
+    }
+
+    if (pMusic == m_pCurrentMusic)
+    {
+        StopMusic();
+        m_pCurrentMusic = nullptr;
+    }
+
+    m_tabMusics.Remove(pMusic->path);
+    FreeMusic(pMusic);
 }
 
 void SoundModule::UndefineSounds()
 {
     StopSounds();
+    std::memset(m_aVoices, 0, sizeof(m_aVoices));
 
-    if (m_aSounds)
+    for (i32f i = 0; i < m_tabSounds.GetCapacity(); ++i)
     {
-        for (i32f i = 0; i < MAX_SOUNDS; ++i)
+        Sound** ppSound = m_tabSounds.GetAt(i);
+        if (ppSound)
         {
-            if (m_aSounds[i].pSound)
-            {
-                Mix_FreeChunk(m_aSounds[i].pSound);
-                m_aSounds[i].pSound = nullptr;
-            }
+            FreeSound(*ppSound);
         }
     }
+
+    m_tabSounds.Clean();
 }
 
 void SoundModule::UndefineMusics()
 {
     StopMusic();
 
-    if (m_aMusics)
+    for (i32f i = 0; i < m_tabMusics.GetCapacity(); ++i)
     {
-        for (i32f i = 0; i < MAX_MUSICS; ++i)
+        Music** ppMusic = m_tabMusics.GetAt(i);
+        if (ppMusic)
         {
-            if (m_aMusics[i].pMusic)
-            {
-                Mix_FreeMusic(m_aMusics[i].pMusic);
-                m_aMusics[i].pMusic = nullptr;
-            }
+            FreeMusic(*ppMusic);
         }
     }
+
+    m_tabMusics.Clean();
+    m_pCurrentMusic = nullptr;
 }
 
-b32 SoundModule::PlaySound(Sound* pSound, b32 bLoop)
+void SoundModule::ReleaseResources()
 {
-    if (pSound)
+    StopSoundsAndMusic();
+    std::memset(m_aVoices, 0, sizeof(m_aVoices));
+    m_pCurrentMusic = nullptr;
+
+    for (i32f i = 0; i < m_tabSounds.GetCapacity(); ++i)
     {
-        Mix_PlayChannel(-1, pSound->pSound, bLoop ? -1 : 0);
-        return true;
+        Sound** ppSound = m_tabSounds.GetAt(i);
+        if (ppSound)
+        {
+            (*ppSound)->refCount = 0;
+        }
     }
-    else
+
+    for (i32f i = 0; i < m_tabMusics.GetCapacity(); ++i)
+    {
+        Music** ppMusic = m_tabMusics.GetAt(i);
+        if (ppMusic)
+        {
+            (*ppMusic)->refCount = 0;
+        }
+    }
+}
+
+void SoundModule::PurgeResources()
+{
+    // Removing moves entries of table, so collect them first
+    s32 soundCount = 0;
+    Sound** apSounds = new Sound*[m_tabSounds.GetCount() + 1];
+    for (i32f i = 0; i < m_tabSounds.GetCapacity(); ++i)
+    {
+        Sound** ppSound = m_tabSounds.GetAt(i);
+        if (ppSound && (*ppSound)->refCount == 0)
+        {
+            apSounds[soundCount++] = *ppSound;
+        }
+    }
+
+    for (i32f i = 0; i < soundCount; ++i)
+    {
+        ForgetVoices(apSounds[i]);
+        m_tabSounds.Remove(apSounds[i]->path);
+        FreeSound(apSounds[i]);
+    }
+    delete[] apSounds;
+
+    s32 musicCount = 0;
+    Music** apMusics = new Music*[m_tabMusics.GetCount() + 1];
+    for (i32f i = 0; i < m_tabMusics.GetCapacity(); ++i)
+    {
+        Music** ppMusic = m_tabMusics.GetAt(i);
+        if (ppMusic && (*ppMusic)->refCount == 0 && *ppMusic != m_pCurrentMusic)
+        {
+            apMusics[musicCount++] = *ppMusic;
+        }
+    }
+
+    for (i32f i = 0; i < musicCount; ++i)
+    {
+        m_tabMusics.Remove(apMusics[i]->path);
+        FreeMusic(apMusics[i]);
+    }
+    delete[] apMusics;
+
+    if (soundCount > 0 || musicCount > 0)
+    {
+        AddNote(PR_NOTE, "Purged %d sounds and %d musics of previous mission", soundCount, musicCount);
+    }
+}
+
+void SoundModule::Update()
+{
+    // Previous music has faded out
+    if (m_bMusicPending && !Mix_PlayingMusic())
+    {
+        m_bMusicPending = false;
+        StartMixerMusic(m_pCurrentMusic, m_pendingFadeTime);
+    }
+    else if (m_pMixerMusic && !m_bMusicPending && !Mix_PlayingMusic())
+    {
+        CloseMixerMusic();
+    }
+
+    b32 bListenerMoved = UpdateListener();
+
+    s32 activeVoices = 0;
+    for (i32f i = 0; i < VOICE_COUNT; ++i)
+    {
+        Voice& voice = m_aVoices[i];
+        if (!voice.pSound)
+        {
+            continue;
+        }
+
+        if (!IsChannelPlaying((s32)i))
+        {
+            voice.pSound = nullptr;
+            continue;
+        }
+
+        ++activeVoices;
+
+        // Far looped voices keep playing silently until camera comes back
+        if (voice.bPositional && bListenerMoved)
+        {
+            voice.volume = ComputeVolume(voice.vPosition);
+            SetChannelVolume((s32)i, voice.volume, ComputePan(voice.vPosition));
+        }
+    }
+
+    m_voiceStats.activeVoices = activeVoices;
+    if (activeVoices > m_voiceStats.peakVoices)
+    {
+        m_voiceStats.peakVoices = activeVoices;
+    }
+}
+
+void SoundModule::SetSoundPriority(Sound* pSound, s32 priority, s32 maxInstances)
+{
+    if (!pSound)
+    {
+        AddNote(PR_WARNING, "SetSoundPriority() called with null sound");
+        return;
+    }
+
+    pSound->priority = priority;
+    pSound->maxInstances = maxInstances > 0 ? maxInstances : 0;
+}
+
+b32 SoundModule::PlaySound(Sound* pSound, b32 bLoop)
+{
+    if (!pSound)
     {
         AddNote(PR_WARNING, "PlaySound() called with null sound");
         return false;
     }
+
+    s32 channel = AcquireVoice(pSound, MIX_MAX_VOLUME);
+    if (channel < 0)
+    {
+        return false;
+    }
+
+    return StartVoice(channel, pSound, bLoop, false, Vector2(0.0f, 0.0f), MIX_MAX_VOLUME);
+}
+
+b32 SoundModule::PlaySoundAt(Sound* pSound, const Vector2& vPosition, b32 bLoop)
+{
+    if (!pSound)
+    {
+        AddNote(PR_WARNING, "PlaySoundAt() called with null sound");
+        return false;
+    }
+
+    s32 volume = ComputeVolume(vPosition);
+    if (!volume && !bLoop)
+    {
+        ++m_voiceStats.culled;
+        return false;
+    }
+
+    s32 channel = AcquireVoice(pSound, volume);
+    if (channel < 0)
+    {
+        return false;
+    }
+
+    return StartVoice(channel, pSound, bLoop, true, vPosition, volume);
 }
 
-b32 SoundModule::PlayMusic(Music* pMusic)
+b32 SoundModule::PlayMusic(Music* pMusic, s32 fadeTime)
 {
-    if (pMusic)
+    if (!pMusic)
+    {
+        AddNote(PR_WARNING, "PlayMusic() called with null music");
+        return false;
+    }
+
+    // Cross with music which is fading out
+    u32 ticks = SDL_GetTicks();
+    if (!fadeTime && (s32)(m_musicFadeEnd - ticks) > 0)
+    {
+        fadeTime = (s32)(m_musicFadeEnd - ticks);
+    }
+    m_musicFadeEnd = 0;
+    m_bMusicPending = false;
+
+    if (pMusic->bStreamed)
+    {
+        if (fadeTime > 0)
+        {
+            Mix_FadeOutMusic(fadeTime);
+        }
+        else
+        {
+            Mix_HaltMusic();
+        }
+
+        if (!m_musicStream.Play(pMusic->fileName, true, fadeTime))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        m_musicStream.Stop(fadeTime);
+
+        // Mixer has single music, so its track fades out for the first half of fade and the next one fades in for the rest
+        if (fadeTime > 0 && Mix_PlayingMusic() && Mix_FadingMusic() != MIX_FADING_OUT)
+        {
+            Mix_FadeOutMusic(fadeTime / 2);
+            fadeTime -= fadeTime / 2;
+        }
+
+        // Mixer blocks until fade out is over before it plays anything else, so wait for it in Update()
+        if (Mix_FadingMusic() == MIX_FADING_OUT)
+        {
+            m_bMusicPending = true;
+            m_pendingFadeTime = fadeTime;
+        }
+        else if (!StartMixerMusic(pMusic, fadeTime))
+        {
+            return false;
+        }
+    }
+
+    m_pCurrentMusic = pMusic;
+    return true;
+}
+
+b32 SoundModule::StartMixerMusic(Music* pMusic, s32 fadeTime)
+{
+    // Previous track is done, mixer decodes the next one from file while it plays
+    Mix_HaltMusic();
+    if (m_pMixerMusic != pMusic)
+    {
+        CloseMixerMusic();
+    }
+
+    if (!pMusic->pMusic)
+    {
+        MemoryScope scope(MEMORY_SOUND);
+        pMusic->pMusic = Mix_LoadMUS(pMusic->fileName);
+        if (!pMusic->pMusic)
+        {
+            AddNote(PR_WARNING, "Can't play music %s: %s", pMusic->fileName, Mix_GetError());
+            return false;
+        }
+    }
+    m_pMixerMusic = pMusic;
+
+    // @NOTE: 65535 it's like infinite loop, i don't think it's possible to reach this limit...
+    if (fadeTime > 0)
+    {
+        Mix_FadeInMusic(pMusic->pMusic, 65535, fadeTime);
+    }
+    else
     {
-        // @NOTE: 65535 it's like infinite loop, i don't think it's possible to reach this limit...
         Mix_PlayMusic(pMusic->pMusic, 65535);
+    }
+
+    return true;
+}
+
+void SoundModule::CloseMixerMusic()
+{
+    if (m_pMixerMusic)
+    {
+        Mix_FreeMusic(m_pMixerMusic->pMusic);
+        m_pMixerMusic->pMusic = nullptr;
+        m_pMixerMusic = nullptr;
+    }
+}
+
+void SoundModule::FadeOutMusic(s32 fadeTime)
+{
+    if (fadeTime <= 0)
+    {
+        StopMusic();
+        return;
+    }
+
+    if (Mix_PlayingMusic())
+    {
+        Mix_FadeOutMusic(fadeTime);
+    }
+    m_musicStream.Stop(fadeTime);
+    m_bMusicPending = false;
+
+    m_musicFadeEnd = SDL_GetTicks() + (u32)fadeTime;
+}
+
+s32 SoundModule::AcquireVoice(Sound* pSound, s32 volume)
+{
+    s32 freeVoice = -1;
+    s32 instanceCount = 0;
+    s32 oldestInstance = -1;
+    s32 victim = -1;
+
+    for (i32f i = 0; i < VOICE_COUNT; ++i)
+    {
+        Voice& voice = m_aVoices[i];
+        if (voice.pSound && !IsChannelPlaying((s32)i))
+        {
+            voice.pSound = nullptr;
+        }
+
+        if (!voice.pSound)
+        {
+            if (freeVoice < 0)
+            {
+                freeVoice = (s32)i;
+            }
+            continue;
+        }
+
+        if (voice.pSound == pSound)
+        {
+            ++instanceCount;
+            if (oldestInstance < 0 || voice.startTicks < m_aVoices[oldestInstance].startTicks)
+            {
+                oldestInstance = (s32)i;
+            }
+        }
+
+        // The lowest priority, then the quietest, then the oldest
+        if (victim < 0)
+        {
+            victim = (s32)i;
+            continue;
+        }
+
+        const Voice& worst = m_aVoices[victim];
+        if (voice.priority != worst.priority)
+        {
+            if (voice.priority < worst.priority)
+            {
+                victim = (s32)i;
+            }
+        }
+        else if (voice.volume != worst.volume)
+        {
+            if (voice.volume < worst.volume)
+            {
+                victim = (s32)i;
+            }
+        }
+        else if (voice.startTicks < worst.startTicks)
+        {
+            victim = (s32)i;
+        }
+    }
+
+    if (pSound->maxInstances && instanceCount >= pSound->maxInstances)
+    {
+        ++m_voiceStats.limited;
+        return oldestInstance;
+    }
+
+    if (freeVoice >= 0)
+    {
+        return freeVoice;
+    }
+
+    const Voice& worst = m_aVoices[victim];
+    if (worst.priority < pSound->priority || (worst.priority == pSound->priority && worst.volume <= volume))
+    {
+        ++m_voiceStats.stolen;
+        return victim;
+    }
+
+    ++m_voiceStats.rejected;
+    return -1;
+}
+
+b32 SoundModule::StartVoice(s32 channel, Sound* pSound, b32 bLoop, b32 bPositional, const Vector2& vPosition, s32 volume)
+{
+    // Channel which is still playing is halted by mixer
+    if (!PlayChannel(channel, pSound, bLoop, volume, bPositional ? ComputePan(vPosition) : 0.0f))
+    {
+        AddNote(PR_WARNING, "Can't play sound %s: %s", pSound->path, Mix_GetError());
+        m_aVoices[channel].pSound = nullptr;
+        return false;
+    }
+
+    Voice& voice = m_aVoices[channel];
+    voice.pSound = pSound;
+    voice.priority = pSound->priority;
+    voice.startTicks = SDL_GetTicks();
+    voice.bPositional = bPositional;
+    voice.vPosition = vPosition;
+    voice.volume = volume;
+
+    ++m_voiceStats.played;
+    return true;
+}
+
+b32 SoundModule::UpdateListener()
+{
+    s32 x, y;
+    g_graphicsModule.GetCamera().GetPosition(x, y);
+
+    s32 width = g_graphicsModule.GetScreenWidth();
+    s32 height = g_graphicsModule.GetScreenHeight();
+
+    Vector2 vListener((f32)(x + width / 2), (f32)(y + height / 2));
+    b32 bMoved = vListener.x != m_vListener.x || vListener.y != m_vListener.y;
+
+    m_vListener = vListener;
+    m_fullDistance = width * FULL_VOLUME_DISTANCE;
+    m_cullDistance = width * CULL_DISTANCE;
+
+    return bMoved;
+}
+
+s32 SoundModule::ComputeVolume(const Vector2& vPosition) const
+{
+    f32 dx = vPosition.x - m_vListener.x;
+    f32 dy = vPosition.y - m_vListener.y;
+    f32 distanceSq = dx * dx + dy * dy;
+
+    if (distanceSq <= m_fullDistance * m_fullDistance)
+    {
+        return MIX_MAX_VOLUME;
+    }
+    if (distanceSq >= m_cullDistance * m_cullDistance)
+    {
+        return 0;
+    }
+
+    // Linear fade between full and cull distance
+    f32 t = (std::sqrt(distanceSq) - m_fullDistance) / (m_cullDistance - m_fullDistance);
+    return (s32)(MIX_MAX_VOLUME * (1.0f - t) + 0.5f);
+}
+
+f32 SoundModule::ComputePan(const Vector2& vPosition) const
+{
+    // Half of volume is reached at cull distance
+    f32 pan = (vPosition.x - m_vListener.x) / m_cullDistance;
+    pan = pan < -1.0f ? -1.0f : (pan > 1.0f ? 1.0f : pan);
+    return pan * 0.5f;
+}
+
+b32 SoundModule::PlayChannel(s32 channel, Sound* pSound, b32 bLoop, s32 volume, f32 pan)
+{
+#ifdef GT2D_SOFTWARE_MIXER
+    if (m_bSoftwareMixer)
+    {
+        // Chunk is 16-bit stereo, 4 bytes per frame
+        f32 gainLeft, gainRight;
+        SoftwareMixer::ComputeGains((f32)volume / MIX_MAX_VOLUME, pan, gainLeft, gainRight);
+        m_mixer.Play(channel, (const s16*)pSound->pSound->abuf, (s32)(pSound->pSound->alen / 4), gainLeft, gainRight, bLoop);
         return true;
     }
-    else
+#endif
+
+    if (Mix_PlayChannel(channel, pSound->pSound, bLoop ? -1 : 0) < 0)
+    {
+        return false;
+    }
+
+    SetChannelVolume(channel, volume, pan);
+    return true;
+}
+
+b32 SoundModule::IsChannelPlaying(s32 channel)
+{
+#ifdef GT2D_SOFTWARE_MIXER
+    if (m_bSoftwareMixer)
+    {
+        return m_mixer.IsPlaying(channel);
+    }
+#endif
+
+    return Mix_Playing(channel);
+}
+
+void SoundModule::SetChannelVolume(s32 channel, s32 volume, f32 pan)
+{
+#ifdef GT2D_SOFTWARE_MIXER
+    if (m_bSoftwareMixer)
+    {
+        f32 gainLeft, gainRight;
+        SoftwareMixer::ComputeGains((f32)volume / MIX_MAX_VOLUME, pan, gainLeft, gainRight);
+        m_mixer.SetGain(channel, gainLeft, gainRight);
+        return;
+    }
+#endif
+
+    // Both 255 removes panning effect
+    u8 left = (u8)(255.0f * (pan > 0.0f ? 1.0f - pan : 1.0f));
+    u8 right = (u8)(255.0f * (pan < 0.0f ? 1.0f + pan : 1.0f));
+
+    Mix_Volume(channel, volume);
+    Mix_SetPanning(channel, left, right);
+}
+
+void SoundModule::HaltChannel(s32 channel)
+{
+#ifdef GT2D_SOFTWARE_MIXER
+    // Chunk may be freed right after halt
+    if (m_bSoftwareMixer)
+    {
+        if (channel < 0)
+        {
+            m_mixer.StopAll();
+        }
+        else
+        {
+            m_mixer.Stop(channel);
+        }
+        m_mixer.Sync();
+        return;
+    }
+#endif
+
+    Mix_HaltChannel(channel);
+}
+
+#ifdef GT2D_SOFTWARE_MIXER
+b32 SoundModule::GetMixerStats(MixerStats& stats)
+{
+    if (!m_bSoftwareMixer)
     {
-        AddNote(PR_WARNING, "PlayMusic() called with null music");
         return false;
     }
+
+    m_mixer.GetStats(stats);
+    return true;
+}
+#endif
+
+void SoundModule::FreeSound(Sound* pSound)
+{
+    Mix_FreeChunk(pSound->pSound);
+    delete[] pSound->path;
+    delete pSound;
+}
+
+void SoundModule::FreeMusic(Music* pMusic)
+{
+    // Freeing music which is fading out would wait for the fade
+    if (pMusic == m_pMixerMusic)
+    {
+        Mix_HaltMusic();
+        CloseMixerMusic();
+    }
+    delete[] pMusic->fileName;
+    delete[] pMusic->path;
+    delete pMusic;
+}
+
+void SoundModule::ForgetVoices(Sound* pSound)
+{
+    for (i32f i = 0; i < VOICE_COUNT; ++i)
+    {
+        if (m_aVoices[i].pSound == pSound)
+        {
+            HaltChannel((s32)i);
+            m_aVoices[i].pSound = nullptr;
+        }
+    }
+}
+
+b32 SoundModule::NormalizePath(const char* fileName, char* path)
+{
+    i32f i = 0;
+    for ( ; fileName[i]; ++i)
+    {
+        if (i >= MAX_PATH_LENGTH - 1)
+        {
+            return false;
+        }
+
+        char c = fileName[i];
+        path[i] = c == '\\' ? '/' : (char)std::tolower((u8)c);
+    }
+
+    path[i] = '\0';
+    return true;
+}
+
+char* SoundModule::CopyPath(const char* path)
+{
+    size_t size = std::strlen(path) + 1;
+    char* copy = new char[size];
+    std::memcpy(copy, path, size);
+    return copy;
 }
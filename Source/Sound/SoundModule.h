@@ -3,14 +3,99 @@
 #include "SDL_mixer.h"
 #include "Engine/Types.h"
 #include "Engine/EngineModule.h"
+#include "Containers/NameTable.h"
+#include "Math/Math.h"
+#include "Sound/MusicStream.h"
+#ifdef GT2D_SOFTWARE_MIXER
+    #include "Sound/SoftwareMixer.h"
+#endif
 
 struct Sound;
 struct Music;
 
+struct VoiceStats
+{
+    s32 voiceCount;
+    s32 activeVoices;
+    s32 peakVoices;
+
+    /** Since start up */
+    s32 played;
+    s32 stolen;
+    s32 limited;
+    s32 culled;
+    s32 rejected;
+};
+
+/**
+ * Sounds and musics are registered by path, defining the same file again
+ * gives the same handle and adds reference. Handles are valid until they're
+ * released as many times as they were defined or resources are undefined.
+ * Missions release resources on exit and purge them after the next one is
+ * entered, so files used by both of them are loaded only once.
+ *
+ * Every mixer channel is a voice owned by module. Sounds over their instance
+ * limit restart their oldest voice, when voices are out the lowest priority,
+ * quietest and oldest one is stolen. Positional sounds are attenuated and
+ * panned by distance from camera center and culled when they're too far.
+ *
+ * Musics are opened only when they're played. WAV musics are streamed from
+ * disk by MusicStream, others (OGG, MP3) are decoded by mixer while it plays
+ * them and are closed after they stop. Track played while previous one fades
+ * out fades in for the rest of its fade. Both are heard at once only when one
+ * of them is streamed, mixer has single music, so its track fades out for the
+ * first half of fade and the next one fades in for the second half.
+ *
+ * Define GT2D_SOFTWARE_MIXER to mix sounds by SoftwareMixer on its own
+ * device with many more voices, SDL_mixer keeps musics then. Sounds fall
+ * back to SDL_mixer if mixer can't be started
+ */
 class SoundModule final : public EngineModule
 {
-    Sound* m_aSounds;
-    Music* m_aMusics;
+    static constexpr i32f MAX_PATH_LENGTH = 256;
+#ifdef GT2D_SOFTWARE_MIXER
+    static constexpr i32f VOICE_COUNT = 256;
+#else
+    static constexpr i32f VOICE_COUNT = 32;
+#endif
+
+    struct Voice
+    {
+        Sound* pSound;
+        s32 priority;
+        u32 startTicks;
+
+        b32 bPositional;
+        Vector2 vPosition;
+        s32 volume;
+    };
+
+    TNameTable<Sound*> m_tabSounds;
+    TNameTable<Music*> m_tabMusics;
+
+    Voice m_aVoices[VOICE_COUNT];
+    VoiceStats m_voiceStats;
+
+#ifdef GT2D_SOFTWARE_MIXER
+    SoftwareMixer m_mixer;
+    b32 m_bSoftwareMixer;
+#endif
+
+    MusicStream m_musicStream;
+    Music* m_pCurrentMusic;
+
+    /** Music which track mixer holds, it may be fading out already */
+    Music* m_pMixerMusic;
+    u32 m_musicFadeEnd;
+
+    /** Current music waits until mixer's music fades out, then fades in itself */
+    b32 m_bMusicPending;
+    s32 m_pendingFadeTime;
+
+    /** Camera center, updated every frame */
+    Vector2 m_vListener;
+    f32 m_fullDistance;
+    f32 m_cullDistance;
 
 public:
     SoundModule() : EngineModule("SoundModule", CHANNEL_SOUND) {}
@@ -21,15 +106,77 @@ public:
     Sound* DefineWAV(const char* fileName);
     Music* DefineMusic(const char* fileName);
 
+    void ReleaseSound(Sound* pSound);
+    void ReleaseMusic(Music* pMusic);
+
     void UndefineSounds();
     void UndefineMusics();
     forceinline void UndefineResources() { UndefineSounds(); UndefineMusics(); }
 
+    /**
+     * Stops everything and drops all references, but files stay loaded,
+     * so the next mission gets them back without loading when it defines them
+     */
+    void ReleaseResources();
+
+    /** Frees sounds and musics nobody defined since ReleaseResources() */
+    void PurgeResources();
+
+    /** Re-attenuates positional voices when camera moves */
+    void Update();
+
+    void SetSoundPriority(Sound* pSound, s32 priority, s32 maxInstances);
+
     b32 PlaySound(Sound* pSound, b32 bLoop = false);
-    b32 PlayMusic(Music* pMusic);
-    forceinline void StopSounds() { Mix_HaltChannel(-1); }
-    forceinline void StopMusic() { Mix_HaltMusic(); }
+    b32 PlaySoundAt(Sound* pSound, const Vector2& vPosition, b32 bLoop = false);
+    b32 PlayMusic(Music* pMusic, s32 fadeTime = 0);
+    void FadeOutMusic(s32 fadeTime);
+    forceinline void StopSounds() { HaltChannel(-1); }
+    forceinline void StopMusic() { Mix_HaltMusic(); m_musicStream.Stop(0); m_musicFadeEnd = 0; m_bMusicPending = false; }
     forceinline void StopSoundsAndMusic() { StopSounds(); StopMusic(); }
+
+    forceinline s32 GetSoundCount() const { return m_tabSounds.GetCount(); }
+    forceinline s32 GetMusicCount() const { return m_tabMusics.GetCount(); }
+    forceinline const VoiceStats& GetVoiceStats() const { return m_voiceStats; }
+    forceinline s32 GetStreamedFrames() { return m_musicStream.GetBufferedFrames(); }
+
+#ifdef GT2D_SOFTWARE_MIXER
+    /** False if sounds are mixed by SDL_mixer */
+    b32 GetMixerStats(MixerStats& stats);
+#endif
+
+private:
+    /** -1 if sound is rejected */
+    s32 AcquireVoice(Sound* pSound, s32 volume);
+    b32 StartVoice(s32 channel, Sound* pSound, b32 bLoop, b32 bPositional, const Vector2& vPosition, s32 volume);
+    /** True if camera moved since last call */
+    b32 UpdateListener();
+
+    /** 0 if sound is too far to be heard */
+    s32 ComputeVolume(const Vector2& vPosition) const;
+    /** In [-0.5, 0.5], opposite side gets quieter up to half of volume */
+    f32 ComputePan(const Vector2& vPosition) const;
+
+    /** Channels are either of SDL_mixer or software mixer, -1 halts all */
+    b32 PlayChannel(s32 channel, Sound* pSound, b32 bLoop, s32 volume, f32 pan);
+    b32 IsChannelPlaying(s32 channel);
+    void SetChannelVolume(s32 channel, s32 volume, f32 pan);
+    void HaltChannel(s32 channel);
+
+    /** Voices of sound must be forgotten before it's freed */
+    void ForgetVoices(Sound* pSound);
+    void FreeSound(Sound* pSound);
+    void FreeMusic(Music* pMusic);
+
+    /** Opens track of music, false if it can't be played */
+    b32 StartMixerMusic(Music* pMusic, s32 fadeTime);
+
+    /** Call only when mixer doesn't play */
+    void CloseMixerMusic();
+
+    /** Paths differ only in case and slashes on Windows, false if it's too long */
+    static b32 NormalizePath(const char* fileName, char* path);
+    static char* CopyPath(const char* path);
 };
 
 inline SoundModule g_soundModule;
\ No newline at end of file
@@ -61,7 +61,19 @@ public:
         }
         else
         {
-            g_debugLogMgr.AddNote(CHANNEL_GAME, PR_WARNING, "SoundPack", "Play() called with wrong index %d", index);
+            LogNote(CHANNEL_GAME, PR_WARNING, "SoundPack", "Play() called with wrong index %d", index);
+        }
+    }
+
+    void PlayAt(i32f index, const Vector2& vPosition) const
+    {
+        if (index >= 0 && index < m_count && m_aSounds[index])
+        {
+            g_soundModule.PlaySoundAt(m_aSounds[index], vPosition);
+        }
+        else
+        {
+            LogNote(CHANNEL_GAME, PR_WARNING, "SoundPack", "PlayAt() called with wrong index %d", index);
         }
     }
 };
@@ -0,0 +1,218 @@
+#include <cctype>
+#include <ctime>
+#include "Engine/StdHeaders.h"
+#include "Engine/MappedFile.h"
+#include "Engine/LogFormat.h"
+
+/**
+ * Turns binary log of GT2D_LOG_BINARY build into text:
+ *   LogDecoder <Log.gtlog> [-channel <Name>]... [-from <seconds>] [-to <seconds>] [-out <file>]
+ * Channels are named like text logs: GT2D, GraphicsModule, ScriptModule...
+ */
+
+static constexpr s32 TEXT_SIZE = 1024;
+static constexpr i32f MAX_FORMATS = 65536;
+
+struct LogFormat
+{
+    const char* name;
+    const char* fmt;
+};
+
+internal b32 IsSameName(const char* a, const char* b)
+{
+    for ( ; *a && *b; ++a, ++b)
+    {
+        if (std::tolower((u8)*a) != std::tolower((u8)*b))
+        {
+            return false;
+        }
+    }
+    return *a == *b;
+}
+
+/** 0 if there's no such channel */
+internal s32 FindChannel(const char* name)
+{
+    for (i32f i = 0; i < 16; ++i)
+    {
+        s32 channel = 1 << i;
+        if (IsSameName(GetLogChannelName(channel), name))
+        {
+            return channel;
+        }
+    }
+    return 0;
+}
+
+internal s32 PrintUsage()
+{
+    std::fprintf(stderr, "Usage: LogDecoder <Log.gtlog> [-channel <Name>]... [-from <seconds>] [-to <seconds>] [-out <file>]\n");
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    // Parse arguments
+    const char* inPath = nullptr;
+    const char* outPath = nullptr;
+    s32 channelMask = 0;
+    f64 from = 0.0;
+    f64 to = -1.0;
+
+    for (s32 i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        b32 bHasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "-channel") == 0 && bHasValue)
+        {
+            s32 channel = FindChannel(argv[++i]);
+            if (!channel)
+            {
+                std::fprintf(stderr, "Unknown channel: %s\n", argv[i]);
+                return 1;
+            }
+            channelMask |= channel;
+        }
+        else if (std::strcmp(arg, "-from") == 0 && bHasValue)
+        {
+            from = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(arg, "-to") == 0 && bHasValue)
+        {
+            to = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(arg, "-out") == 0 && bHasValue)
+        {
+            outPath = argv[++i];
+        }
+        else if (arg[0] != '-' && !inPath)
+        {
+            inPath = arg;
+        }
+        else
+        {
+            return PrintUsage();
+        }
+    }
+
+    if (!inPath)
+    {
+        return PrintUsage();
+    }
+
+    // Check header
+    MappedFile file;
+    if (!file.Open(inPath))
+    {
+        std::fprintf(stderr, "Can't open log: %s\n", inPath);
+        return 1;
+    }
+
+    const u8* pData = file.GetData();
+    u64 size = file.GetSize();
+
+    LogFileHeader header;
+    if (size < sizeof(header))
+    {
+        std::fprintf(stderr, "Not a binary log: %s\n", inPath);
+        return 1;
+    }
+
+    std::memcpy(&header, pData, sizeof(header));
+    if (std::memcmp(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || header.version != LOG_VERSION)
+    {
+        std::fprintf(stderr, "Not a binary log or unsupported version: %s\n", inPath);
+        return 1;
+    }
+
+    std::FILE* hOut = outPath ? std::fopen(outPath, "w") : stdout;
+    if (!hOut)
+    {
+        std::fprintf(stderr, "Can't open output: %s\n", outPath);
+        return 1;
+    }
+
+    std::time_t startTime = (std::time_t)header.startTime;
+    const char* startText = std::ctime(&startTime);
+    std::fprintf(hOut, "Log started %s", startText ? startText : "at unknown time\n");
+
+    // Strings of format entries point right into file
+    LogFormat* aFormats = new LogFormat[MAX_FORMATS];
+    std::memset(aFormats, 0, sizeof(LogFormat) * MAX_FORMATS);
+
+    u32 fromTime = (u32)(from * 1000.0);
+    u32 toTime = to >= 0.0 ? (u32)(to * 1000.0) : UINT32_MAX;
+
+    char text[TEXT_SIZE];
+    u64 offset = sizeof(header);
+    u64 noteCount = 0;
+
+    while (offset + sizeof(LogEntry) <= size)
+    {
+        LogEntry entry;
+        std::memcpy(&entry, pData + offset, sizeof(entry));
+        offset += sizeof(entry);
+
+        // Last entry may be cut if game crashed
+        if (offset + entry.size > size)
+        {
+            std::fprintf(stderr, "Log is cut at %llu\n", (unsigned long long)offset);
+            break;
+        }
+
+        const u8* pPayload = pData + offset;
+        offset += entry.size;
+
+        switch (entry.kind)
+        {
+        case LOG_ENTRY_FORMAT:
+        {
+            const char* name = (const char*)pPayload;
+            const char* nameEnd = (const char*)std::memchr(name, '\0', entry.size);
+            const char* fmtEnd = nameEnd ? (const char*)std::memchr(nameEnd + 1, '\0', entry.size - (nameEnd + 1 - name)) : nullptr;
+            if (!fmtEnd)
+            {
+                std::fprintf(stderr, "Broken format entry at %llu\n", (unsigned long long)(offset - entry.size));
+                break;
+            }
+
+            aFormats[entry.format] = { name, nameEnd + 1 };
+        } break;
+
+        case LOG_ENTRY_NOTE:
+        {
+            if (entry.time < fromTime || entry.time > toTime || (channelMask && !(entry.channel & channelMask)))
+            {
+                break;
+            }
+
+            const LogFormat& format = aFormats[entry.format];
+            if (!format.fmt)
+            {
+                std::fprintf(stderr, "Note refers to undefined format %u\n", (u32)entry.format);
+                break;
+            }
+
+            FormatLogArgs(text, TEXT_SIZE, format.fmt, pPayload, entry.size);
+            std::fprintf(hOut, "[%9.3f] <%s> %s: %s\n", entry.time / 1000.0, format.name, GetLogPriorityName(entry.priority), text);
+            ++noteCount;
+        } break;
+
+        default:
+        {
+            std::fprintf(stderr, "Unknown entry %u at %llu\n", (u32)entry.kind, (unsigned long long)(offset - entry.size));
+        } break;
+        }
+    }
+
+    delete[] aFormats;
+    if (hOut != stdout)
+    {
+        std::fclose(hOut);
+    }
+
+    std::fprintf(stderr, "%llu notes decoded\n", (unsigned long long)noteCount);
+    return 0;
+}
@@ -0,0 +1,166 @@
+#define SDL_MAIN_HANDLED
+#include "Engine/StdHeaders.h"
+#include "Sound/SoftwareMixer.h"
+
+/**
+ * Mixes many looped voices by SoftwareMixer on dummy audio driver, so it
+ * runs headless. Reports callback time against buffer time, then times
+ * Mix() directly with SIMD and scalar kernels:
+ *   MixerBench [-voices <count>] [-seconds <seconds>] [-frequency <hz>] [-buffer <frames>]
+ */
+
+static constexpr i32f CLIP_COUNT = 8;
+
+internal s32 PrintUsage()
+{
+    std::fprintf(stderr, "Usage: MixerBench [-voices <count>] [-seconds <seconds>] [-frequency <hz>] [-buffer <frames>]\n");
+    return 1;
+}
+
+/** Milliseconds per Mix() call */
+internal f64 MeasureMix(SoftwareMixer& mixer, s16* aOutput, s32 frameCount, s32 iterations)
+{
+    u64 start = SDL_GetPerformanceCounter();
+    for (i32f i = 0; i < iterations; ++i)
+    {
+        mixer.Mix(aOutput, frameCount);
+    }
+    u64 ticks = SDL_GetPerformanceCounter() - start;
+
+    return (f64)ticks / SDL_GetPerformanceFrequency() * 1000.0 / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    // Parse arguments
+    s32 voiceCount = 256;
+    s32 seconds = 5;
+    s32 frequency = 44100;
+    s32 bufferFrames = 512;
+
+    for (s32 i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        b32 bHasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "-voices") == 0 && bHasValue)
+        {
+            voiceCount = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(arg, "-seconds") == 0 && bHasValue)
+        {
+            seconds = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(arg, "-frequency") == 0 && bHasValue)
+        {
+            frequency = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(arg, "-buffer") == 0 && bHasValue)
+        {
+            bufferFrames = std::atoi(argv[++i]);
+        }
+        else
+        {
+            return PrintUsage();
+        }
+    }
+
+    if (voiceCount <= 0 || voiceCount > SoftwareMixer::MAX_VOICES || seconds <= 0 || frequency <= 0 || bufferFrames <= 0)
+    {
+        std::fprintf(stderr, "Voices must be in [1, %d], other values must be positive\n", (s32)SoftwareMixer::MAX_VOICES);
+        return 1;
+    }
+
+    // Dummy driver pulls buffers in real time without audio hardware
+    SDL_SetMainReady();
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_AUDIO) < 0)
+    {
+        std::fprintf(stderr, "Can't initialize SDL audio: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SoftwareMixer* pMixer = new SoftwareMixer();
+    if (!pMixer->StartUp(frequency, bufferFrames))
+    {
+        std::fprintf(stderr, "Can't open audio device: %s\n", SDL_GetError());
+        delete pMixer;
+        SDL_Quit();
+        return 1;
+    }
+
+    // Clips of different tones and lengths, odd lengths leave SIMD tails
+    s16* aClips[CLIP_COUNT];
+    s32 aClipFrames[CLIP_COUNT];
+    for (i32f i = 0; i < CLIP_COUNT; ++i)
+    {
+        aClipFrames[i] = frequency / 4 + (s32)i * 1237;
+        aClips[i] = new s16[aClipFrames[i] * 2];
+
+        f32 step = 2.0f * 3.14159265f * (110.0f * (i + 1)) / frequency;
+        for (i32f j = 0; j < aClipFrames[i]; ++j)
+        {
+            s16 sample = (s16)(std::sin(step * j) * 8192.0f);
+            aClips[i][j * 2] = sample;
+            aClips[i][j * 2 + 1] = sample;
+        }
+    }
+
+    for (i32f i = 0; i < voiceCount; ++i)
+    {
+        f32 gainLeft, gainRight;
+        SoftwareMixer::ComputeGains((f32)(std::rand() % 101) / 100.0f, (f32)(std::rand() % 201 - 100) / 100.0f, gainLeft, gainRight);
+
+        s32 clip = (s32)i % CLIP_COUNT;
+        pMixer->Play((s32)i, aClips[clip], aClipFrames[clip], gainLeft, gainRight, true);
+    }
+
+    // Callback time of real playback
+    MixerStats stats;
+    pMixer->GetStats(stats);
+
+    std::printf("%d voices, %d Hz, %d frames per buffer (%.2f ms)\n", voiceCount, frequency, bufferFrames, stats.bufferTime);
+    for (i32f i = 0; i < seconds; ++i)
+    {
+        SDL_Delay(1000);
+        pMixer->GetStats(stats);
+        std::printf("%2d s: %d voices, %d callbacks, mix %.3f ms average, %.3f ms worst, %.1f%% of buffer time\n",
+                    (s32)i + 1, stats.activeVoices, stats.callbacks, stats.averageMixTime, stats.maxMixTime,
+                    stats.averageMixTime / stats.bufferTime * 100.0);
+    }
+
+    // Mix directly while device is paused
+    pMixer->Pause(true);
+
+    s16* aOutput = new s16[bufferFrames * 2];
+    s32 iterations = 200;
+
+    pMixer->SetScalar(true);
+    f64 scalarTime = MeasureMix(*pMixer, aOutput, bufferFrames, iterations);
+    pMixer->SetScalar(false);
+    f64 simdTime = MeasureMix(*pMixer, aOutput, bufferFrames, iterations);
+
+#if defined(SIMD_AVX2)
+    const char* simdName = "AVX2";
+#elif defined(SIMD_SSE2)
+    const char* simdName = "SSE2";
+#else
+    const char* simdName = "Scalar";
+#endif
+
+    std::printf("%s vs scalar, %d iterations: %.3f ms vs %.3f ms per buffer, %.2fx\n", simdName, iterations, simdTime, scalarTime, scalarTime / simdTime);
+    std::printf("Dropped commands: %d\n", stats.droppedCommands);
+
+    // Clean up
+    pMixer->ShutDown();
+    delete pMixer;
+
+    delete[] aOutput;
+    for (i32f i = 0; i < CLIP_COUNT; ++i)
+    {
+        delete[] aClips[i];
+    }
+
+    SDL_Quit();
+    return 0;
+}